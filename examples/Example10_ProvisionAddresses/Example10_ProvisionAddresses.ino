@@ -0,0 +1,62 @@
+/******************************************************************************
+  Gives several LIDARs that all start on the default address their own address.
+
+  Every LIDAR ships on address 0x62. Each one also has a 4 byte serial number
+  (UNIT_ID), and only the LIDAR whose serial number matches will accept a new
+  address, so they can all stay connected while they are provisioned. The
+  library reads each changed register back until the LIDAR has restarted
+  with it, instead of waiting a fixed time, so this takes milliseconds per
+  LIDAR instead of half a second.
+
+  To find a LIDAR's serial number, connect it on its own and read the UNIT_ID
+  registers: myLIDAR.read(0x16, unitId, 4)
+
+  Hardware Connections:
+  Plug all Qwiic LIDARs into the Qwiic RedBoard, daisy-chained.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+
+LIDARLite_v4LED myLIDAR;
+
+//Serial numbers of your LIDARs and the address each one should get
+LIDARLite_AddressAssignment addressTable[] = {
+  {{0x00, 0x00, 0x00, 0x00}, 0x30, false},
+  {{0x00, 0x00, 0x00, 0x00}, 0x31, false},
+  {{0x00, 0x00, 0x00, 0x00}, 0x32, false},
+};
+#define NUMBER_OF_LIDARS (sizeof(addressTable) / sizeof(addressTable[0]))
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  //check if any LIDAR will acknowledge on the default address
+  if (myLIDAR.begin() == false) {
+    Serial.println("No LIDAR on the default address! Freezing.");
+    while(1);
+  }
+
+  //Move the LIDARs. Pass true instead of false to store the addresses in flash.
+  uint8_t moved = myLIDAR.provisionAddresses(addressTable, NUMBER_OF_LIDARS, false);
+
+  Serial.print("Provisioned ");
+  Serial.print(moved);
+  Serial.print(" of ");
+  Serial.print(NUMBER_OF_LIDARS);
+  Serial.print(" LIDARs in ");
+  Serial.print(myLIDAR.getProvisionTime());
+  Serial.println(" ms");
+
+  for (uint8_t i = 0; i < NUMBER_OF_LIDARS; i++) {
+    Serial.print("Address 0x");
+    Serial.print(addressTable[i].address, HEX);
+    Serial.println(addressTable[i].found ? ": OK" : ": not found");
+  }
+}
+
+void loop() {
+}
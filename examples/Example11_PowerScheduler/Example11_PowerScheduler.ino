@@ -0,0 +1,54 @@
+/******************************************************************************
+  Saves power by letting the LIDAR sleep between measurements when it can.
+
+  In asynchronous power mode the LIDAR's coprocessor turns off between
+  measurements, but every measurement then takes longer because it has to
+  wake up first. The power scheduler measures that extra wake-up time and only
+  uses asynchronous mode while measurements still finish within your latency
+  budget.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+#include <LIDARLite_v4LED_Power.h>
+
+#define SAMPLE_PERIOD_US 100000 //10 samples per second
+#define LATENCY_BUDGET_US 20000 //Each result may take up to 20 ms from trigger
+
+LIDARLite_v4LED myLIDAR;
+LIDARLite_v4LED_PowerScheduler powerScheduler;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  //check if LIDAR will acknowledge over I2C
+  if (myLIDAR.begin() == false) {
+    Serial.println("Device did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("LIDAR acknowledged!");
+
+  powerScheduler.begin(myLIDAR, SAMPLE_PERIOD_US, LATENCY_BUDGET_US);
+}
+
+void loop() {
+  if (powerScheduler.service()) {
+    Serial.print("Distance: ");
+    Serial.print(powerScheduler.getDistance());
+    Serial.print(" cm, mode: ");
+    Serial.print(powerScheduler.isAsync() ? "async" : "always on");
+    Serial.print(", latency: ");
+    Serial.print(powerScheduler.getLatency());
+    Serial.print(" us, wake-up: ");
+    Serial.print(powerScheduler.getWakeLatency());
+    Serial.print(" us, duty cycle: ");
+    Serial.print(powerScheduler.getDutyCycle() / 10.0);
+    Serial.println(" %");
+  }
+}
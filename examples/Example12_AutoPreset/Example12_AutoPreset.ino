@@ -0,0 +1,67 @@
+/******************************************************************************
+  Lets the library choose the configure() preset from the distances it sees.
+
+  Short range presets are faster but only work on near targets; long range
+  presets are slower. The auto preset uses the fastest preset that covers the
+  target and still gives readings steady to within ACCURACY_CM, and prints
+  every switch it makes and why.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+#include <LIDARLite_v4LED_AutoPreset.h>
+
+#define ACCURACY_CM 3 //Largest acceptable average deviation from the median
+
+LIDARLite_v4LED myLIDAR;
+LIDARLite_v4LED_AutoPreset autoPreset;
+
+const char *reasonNames[] = {"range up", "range down", "accuracy", "speed", "sensitivity on", "sensitivity off"};
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  //check if LIDAR will acknowledge over I2C
+  if (myLIDAR.begin() == false) {
+    Serial.println("Device did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("LIDAR acknowledged!");
+
+  autoPreset.begin(myLIDAR, ACCURACY_CM);
+
+  //Optional: raise detection sensitivity when 3 of 8 readings come back empty
+  //autoPreset.enableSensitivitySwitching(0x00, 0x20, 3);
+}
+
+void loop() {
+  uint16_t distance = autoPreset.getDistance();
+
+  Serial.print("Distance: ");
+  Serial.print(distance);
+  Serial.print(" cm, preset: ");
+  Serial.println(autoPreset.getPreset());
+
+  LIDARLite_PresetSwitch entry;
+  while (autoPreset.readLog(entry)) {
+    Serial.print("Switched preset ");
+    Serial.print(entry.fromPreset);
+    Serial.print(" -> ");
+    Serial.print(entry.toPreset);
+    Serial.print(" (");
+    Serial.print(reasonNames[entry.reason]);
+    Serial.print(", median ");
+    Serial.print(entry.median);
+    Serial.print(" cm, jitter ");
+    Serial.print(entry.jitter);
+    Serial.println(" cm)");
+  }
+
+  delay(20);  //Don't hammer too hard on the I2C bus
+}
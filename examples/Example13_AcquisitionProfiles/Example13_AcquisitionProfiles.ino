@@ -0,0 +1,80 @@
+/******************************************************************************
+  Defines a custom acquisition profile and measures every profile.
+
+  A profile sets the acquisition count, quick termination and, optionally,
+  detection sensitivity in one call. The six configure() presets are
+  available as built-in profiles. For each profile this sketch prints how
+  many I2C transactions applying it took and the average time a
+  measurement took with it.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+
+#define MEASUREMENTS 50 //Measurements averaged per profile
+
+//64 acquisitions with quick termination and a raised detection threshold
+constexpr LIDARLite_Profile MY_PROFILE = {0x40, 0x00, true, 0x20, 100};
+
+const LIDARLite_Profile profiles[] = {
+  LIDARLITE_PROFILE_MAX_RANGE,
+  LIDARLITE_PROFILE_BALANCED,
+  LIDARLITE_PROFILE_SHORT_RANGE,
+  LIDARLITE_PROFILE_MID_RANGE_QT,
+  LIDARLITE_PROFILE_MAX_RANGE_QT,
+  LIDARLITE_PROFILE_VERY_SHORT_RANGE,
+  MY_PROFILE,
+};
+const char *profileNames[] = {"max range", "balanced", "short range", "mid range QT", "max range QT", "very short range", "custom"};
+
+//Count bus transactions so the cost of applying a profile can be printed
+LIDARLite_v4LED_T<LIDARLite_WireTransport, LIDARLite_BusStats> myLIDAR;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  //check if LIDAR will acknowledge over I2C
+  if (myLIDAR.begin() == false) {
+    Serial.println("Device did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("LIDAR acknowledged!");
+
+  //Skip register writes that would not change anything
+  myLIDAR.enableShadowCache(true);
+}
+
+void loop() {
+  for (uint8_t p = 0; p < sizeof(profiles) / sizeof(profiles[0]); p++) {
+    myLIDAR.getStats().clear();
+    myLIDAR.applyProfile(profiles[p]);
+    uint32_t applyTransactions = myLIDAR.getStats().transactions;
+
+    uint32_t totalTime = 0;
+    uint32_t totalDistance = 0;
+    for (uint8_t i = 0; i < MEASUREMENTS; i++) {
+      myLIDAR.takeRange();
+      myLIDAR.waitForBusy();
+      totalTime += myLIDAR.getLastWaitTime();
+      totalDistance += myLIDAR.readDistance();
+    }
+
+    Serial.print(profileNames[p]);
+    Serial.print(": apply ");
+    Serial.print(applyTransactions);
+    Serial.print(" transactions, ");
+    Serial.print(totalTime / MEASUREMENTS);
+    Serial.print(" us per measurement, ");
+    Serial.print(totalDistance / MEASUREMENTS);
+    Serial.println(" cm");
+  }
+  Serial.println();
+
+  delay(2000);
+}
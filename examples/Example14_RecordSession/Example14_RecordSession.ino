@@ -0,0 +1,67 @@
+/******************************************************************************
+  Records every I2C transaction and distance to an SD card.
+
+  The LIDAR is driven through a recording transport, which logs each bus
+  transaction to a compact binary file as it happens. Each decoded distance
+  is logged too. Copy LIDAR.LLR off the card and replay it with
+  LIDARLite_ReplayTransport to reproduce the session without the hardware.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Connect an SD card breakout with its chip select on pin SD_CS_PIN.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <SPI.h>
+#include <SD.h>
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+#include <LIDARLite_v4LED_Record.h>
+
+#define SD_CS_PIN 10
+#define SAMPLES_PER_FLUSH 50 //Flush the file this often so a power loss costs little
+
+LIDARLite_v4LED_T<LIDARLite_RecordingTransport<> > myLIDAR;
+LIDARLite_Recorder recorder;
+File logFile;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  if (SD.begin(SD_CS_PIN) == false) {
+    Serial.println("SD card not found! Freezing.");
+    while(1);
+  }
+  logFile = SD.open("LIDAR.LLR", FILE_WRITE);
+  recorder.begin(logFile);
+
+  //Start recording before begin() so the replay sees the same transactions
+  myLIDAR.getTransport().setRecorder(&recorder);
+
+  //check if LIDAR will acknowledge over I2C
+  if (myLIDAR.begin() == false) {
+    Serial.println("Device did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("LIDAR acknowledged!");
+}
+
+void loop() {
+  static uint16_t samples = 0;
+
+  uint16_t distance = myLIDAR.getDistance();
+  recorder.recordSample(LIDARLITE_ADDR_DEFAULT, distance);
+
+  if (++samples % SAMPLES_PER_FLUSH == 0) {
+    logFile.flush();
+    Serial.print("Logged ");
+    Serial.print(recorder.getBytesWritten());
+    Serial.print(" bytes, dropped ");
+    Serial.print(recorder.getDroppedRecords());
+    Serial.println(" records");
+  }
+
+  delay(20);  //Don't hammer too hard on the I2C bus
+}
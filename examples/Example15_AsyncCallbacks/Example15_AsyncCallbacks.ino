@@ -0,0 +1,63 @@
+/******************************************************************************
+  Runs two LIDARs from one loop using callbacks.
+
+  measure() asks for a distance and returns straight away. The event loop
+  checks on every sensor each time service() is called and runs your
+  callback when a distance arrives. Here each callback asks for the next
+  measurement, so both sensors measure continuously and loop() stays free
+  for other work.
+
+  Hardware Connections:
+  Plug two Qwiic LIDARs into Qwiic RedBoard using Qwiic cables.
+  Change the address of one of them to 0x42 with Example2_ChangeI2CAddress.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+#include <LIDARLite_v4LED_Async.h>
+
+#define TIMEOUT_US 50000 //Give up on a measurement after 50 ms
+
+LIDARLite_v4LED lidarA;
+LIDARLite_v4LED lidarB;
+LIDARLite_v4LED_Async eventLoop;
+
+void onDistance(void *context, uint8_t status, uint16_t distance) {
+  LIDARLite_v4LED *sensor = (LIDARLite_v4LED *)context;
+
+  Serial.print(sensor == &lidarA ? "A: " : "B: ");
+  if (status == LIDARLITE_ASYNC_OK) {
+    Serial.print(distance);
+    Serial.println(" cm");
+  }
+  else if (status == LIDARLITE_ASYNC_TIMEOUT)
+    Serial.println("timed out");
+  else
+    Serial.println("did not acknowledge");
+
+  //Ask for the next measurement
+  eventLoop.measure(*sensor, onDistance, sensor, TIMEOUT_US);
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  //check if both LIDARs will acknowledge over I2C
+  if (lidarA.begin() == false || lidarB.begin(0x42) == false) {
+    Serial.println("Device did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("LIDARs acknowledged!");
+
+  eventLoop.measure(lidarA, onDistance, &lidarA, TIMEOUT_US);
+  eventLoop.measure(lidarB, onDistance, &lidarB, TIMEOUT_US);
+}
+
+void loop() {
+  eventLoop.service();
+
+  //Other work can go here
+}
@@ -0,0 +1,61 @@
+/******************************************************************************
+  Fires three LIDARs at the same moment through their trigger pins.
+
+  All trigger pins are flipped together (with a single port write on boards
+  that allow it), so the three distances describe the same instant. The
+  sketch prints the distances, how long each LIDAR took, and the skew: the
+  time between the first and the last LIDAR starting its measurement.
+
+  Hardware Connections:
+  Plug three Qwiic LIDARs into Qwiic RedBoard using Qwiic cables and give
+  them the addresses 0x62, 0x42 and 0x43 with Example2_ChangeI2CAddress.
+  Connect each LIDAR's trigger pin and monitor pin to the pins listed below.
+  Trigger pins 4, 5 and 6 share one port on an Uno.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+#include <LIDARLite_v4LED_GpioGroup.h>
+
+#define NUM_LIDARS 3
+
+const uint8_t addresses[NUM_LIDARS] = {0x62, 0x42, 0x43};
+const uint8_t triggerPins[NUM_LIDARS] = {4, 5, 6};
+const uint8_t monitorPins[NUM_LIDARS] = {7, 8, 9};
+
+LIDARLite_v4LED lidars[NUM_LIDARS];
+LIDARLite_v4LED_GpioGroup group;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  for (uint8_t i = 0; i < NUM_LIDARS; i++) {
+    //check if LIDAR will acknowledge over I2C
+    if (lidars[i].begin(addresses[i]) == false) {
+      Serial.println("Device did not acknowledge! Freezing.");
+      while(1);
+    }
+    group.addSensor(lidars[i], triggerPins[i], monitorPins[i]);
+  }
+  Serial.println("LIDARs acknowledged!");
+}
+
+void loop() {
+  if (group.scan(100000) == false)
+    Serial.print("(incomplete) ");
+
+  for (uint8_t i = 0; i < NUM_LIDARS; i++) {
+    Serial.print(group.getDistance(i));
+    Serial.print(" cm in ");
+    Serial.print(group.getCompletionTime(i));
+    Serial.print(" us, ");
+  }
+  Serial.print("skew: ");
+  Serial.print(group.getTriggerSkew());
+  Serial.println(" us");
+
+  delay(20);  //Don't hammer too hard on the I2C bus
+}
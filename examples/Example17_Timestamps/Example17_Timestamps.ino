@@ -0,0 +1,50 @@
+/******************************************************************************
+  Prints each distance with the time it was measured at.
+
+  A measurement takes a while, and getDistance() only returns once it is
+  done, so stamping the result with micros() afterwards makes it look later
+  than it was. getDistance(sample) stamps each sample with the middle of its
+  acquisition and how long the acquisition took, which is what you want when
+  combining LIDAR readings with other sensors such as an IMU.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+
+LIDARLite_v4LED myLIDAR;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  //check if LIDAR will acknowledge over I2C
+  if (myLIDAR.begin() == false) {
+    Serial.println("Device did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("LIDAR acknowledged!");
+}
+
+void loop() {
+  LIDARLite_Sample sample;
+
+  myLIDAR.getDistance(sample);
+  unsigned long returnedAt = micros();
+
+  Serial.print("Distance: ");
+  Serial.print(sample.distance);
+  Serial.print(" cm, measured at ");
+  Serial.print(sample.timestamp);
+  Serial.print(" us, acquisition took ");
+  Serial.print(sample.duration);
+  Serial.print(" us, returned ");
+  Serial.print(returnedAt - sample.timestamp);
+  Serial.println(" us later");
+
+  delay(20);  //Don't hammer too hard on the I2C bus
+}
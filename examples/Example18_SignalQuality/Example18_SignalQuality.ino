@@ -0,0 +1,77 @@
+/******************************************************************************
+  Reports how strong each return is, and whether there is a second one.
+
+  After every distance the sketch reads a small window of the correlation
+  record around where that distance puts the return, instead of the whole
+  192 point record. From the window it prints the peak amplitude, the
+  peak-to-noise ratio and whether a second return (glass, rain, an edge)
+  shows up next to the main one.
+
+  The correlation record is read from its start, so windows for far targets
+  cost more than windows for close ones. Fill in CALIBRATION for your unit:
+  record the crossing at two known distances and fit offset and cmPerPoint.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+#include <LIDARLite_v4LED_Correlation.h>
+
+#define WINDOW_POINTS 32 //Points read around the expected crossing
+
+//Distance at record point 0 in 1/256 cm, and cm per record point in Q8.8
+const LIDARLite_CorrelationCalibration CALIBRATION = {0, 256};
+
+LIDARLite_v4LED myLIDAR;
+int16_t window[WINDOW_POINTS];
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  //check if LIDAR will acknowledge over I2C
+  if (myLIDAR.begin() == false) {
+    Serial.println("Device did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("LIDAR acknowledged!");
+}
+
+void loop() {
+  uint16_t distance = myLIDAR.getDistance();
+
+  //Center the window on the crossing this distance should produce
+  uint8_t center = LIDARLite_distanceToPoint(distance, CALIBRATION);
+  uint8_t firstPoint = (center > WINDOW_POINTS / 2) ? center - WINDOW_POINTS / 2 : 0;
+  if (firstPoint > 192 - WINDOW_POINTS)
+    firstPoint = 192 - WINDOW_POINTS;
+
+  //A failed read leaves the window half old, half new: skip the quality
+  LIDARLite_SignalQuality quality;
+  bool windowRead = myLIDAR.correlationRecordReadWindow(window, firstPoint, WINDOW_POINTS);
+  if (windowRead)
+    LIDARLite_measureSignalQuality(window, WINDOW_POINTS, quality);
+
+  Serial.print("Distance: ");
+  Serial.print(distance);
+  Serial.print(" cm");
+  if (!windowRead)
+    Serial.print(", correlation read failed");
+  else if (quality.valid) {
+    Serial.print(", peak: ");
+    Serial.print(quality.peak);
+    Serial.print(", peak/noise: ");
+    Serial.print(quality.peakToNoise / 16.0);
+    if (quality.secondPeak)
+      Serial.print(", second return!");
+  }
+  else
+    Serial.print(", no return in window");
+  Serial.println();
+
+  delay(20);  //Don't hammer too hard on the I2C bus
+}
@@ -0,0 +1,108 @@
+/******************************************************************************
+  Keeps two LIDARs running when one of them is unplugged and plugged back in.
+
+  The scheduler counts failed measurements for every sensor. A sensor that
+  fails several times in a row is quarantined: the other sensor keeps its
+  full sample rate, and the missing one is only checked now and then, less
+  often the longer it stays away. When it answers again, its configuration
+  is written back and it rejoins the schedule on its own.
+
+  If both sensors fail at once the bus itself may be stuck, for example by a
+  sensor that was unplugged in the middle of a transfer. The scheduler then
+  calls recoverBus() below, which clocks SCL until the bus is free.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Add another Qwiic LIDAR using Qwiic cable.
+  For this example to work, the two Qwiic LIDAR's need to have different addresses.
+  One is at the default 0x62 and the other at 0x5B. Revisit example 2 to change the
+  address of your Qwiic LIDAR sensor. Use flash storage for the new address, or
+  the sensor comes back on 0x62 after being unplugged.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+#include <LIDARLite_v4LED_Scheduler.h>
+
+LIDARLite_v4LED myLIDAR1;
+LIDARLite_v4LED myLIDAR2;
+LIDARLite_v4LED_Scheduler scheduler;
+
+unsigned long lastReport = 0;
+
+//Called by the scheduler when no sensor answers any more
+bool recoverBus(void *context) {
+  (void)context; //No state needed, the pins are fixed
+#if defined(PIN_WIRE_SDA) && defined(PIN_WIRE_SCL)
+  Wire.end(); //Hand the pins back to recoverBus
+  bool recovered = LIDARLite_recoverBus(PIN_WIRE_SDA, PIN_WIRE_SCL);
+  Wire.begin();
+  return recovered;
+#else
+  return false; //Pins unknown on this platform, keep probing
+#endif
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+#if defined(WIRE_HAS_TIMEOUT)
+  Wire.setWireTimeout(3000, true); //Don't let a stuck bus hang Wire forever
+#endif
+
+  //check if LIDARs will acknowledge over I2C
+  if (myLIDAR1.begin(0x5B) == false) {
+    Serial.println("LIDAR 1 did not acknowledge! Freezing.");
+    while(1);
+  }
+  if (myLIDAR2.begin() == false) {
+    Serial.println("LIDAR 2 did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("Both LIDARs acknowledged.");
+
+  //These settings are written back to a sensor when it is plugged back in
+  myLIDAR1.configure(2);
+  myLIDAR2.configure(2);
+
+  scheduler.addSensor(myLIDAR1);
+  scheduler.addSensor(myLIDAR2);
+  scheduler.setFaultPolicy(3, 100000); //Quarantine after 3 failures in a row, or a measurement busy for 100 ms
+  scheduler.setBusRecovery(recoverBus);
+  scheduler.start();
+}
+
+void loop() {
+  scheduler.service();
+
+  if (millis() - lastReport >= 1000) {
+    lastReport = millis();
+
+    for (uint8_t i = 0; i < scheduler.getNumSensors(); i++) {
+      Serial.print("LIDAR ");
+      Serial.print(i + 1);
+      switch (scheduler.getHealth(i)) {
+        case LIDARLITE_HEALTH_OK:
+          Serial.print(" ok, distance: ");
+          Serial.print(scheduler.getDistance(i));
+          Serial.print(" cm");
+          break;
+        case LIDARLITE_HEALTH_FAILING:
+          Serial.print(" failing");
+          break;
+        case LIDARLITE_HEALTH_QUARANTINED:
+          Serial.print(" unplugged?");
+          break;
+      }
+      Serial.print(", ");
+      Serial.print(scheduler.getSensorHz(i));
+      Serial.print(" Hz, reattached ");
+      Serial.print(scheduler.getReattachCount(i));
+      Serial.println(" times");
+    }
+    Serial.print("Bus recoveries: ");
+    Serial.println(scheduler.getBusRecoveryCount());
+  }
+}
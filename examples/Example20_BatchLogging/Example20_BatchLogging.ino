@@ -0,0 +1,123 @@
+/******************************************************************************
+  Logs two LIDARs to an SD card a whole block of samples at a time.
+
+  Calling getDistance() for every sample and printing each value costs a
+  function call, a number-to-text conversion and a small write per sample.
+  At high sample rates that overhead, not the LIDAR, limits the rate. Here the
+  scheduler drops every new sample straight into a LIDARLite_SampleBlock, which
+  keeps distances, timestamps, status flags and sensor numbers in separate
+  arrays. Once the block is full each array goes to the card in one write.
+
+  Set BLOCK_OUTPUT to false to log one line of text per sample instead, and
+  compare the sample rate and the time spent writing per sample, which are
+  printed every second.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Add another Qwiic LIDAR using Qwiic cable.
+  For this example to work, the two Qwiic LIDAR's need to have different addresses.
+  One is at the default 0x62 and the other at 0x5B. Revisit example 2 to change the
+  address of your Qwiic LIDAR sensor.
+  Connect an SD card breakout with its chip select on pin SD_CS_PIN.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <SPI.h>
+#include <SD.h>
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+#include <LIDARLite_v4LED_Scheduler.h>
+
+#define SD_CS_PIN 10
+#define BLOCK_OUTPUT true //false logs one text line per sample, for comparison
+
+LIDARLite_v4LED myLIDAR1;
+LIDARLite_v4LED myLIDAR2;
+LIDARLite_v4LED_Scheduler scheduler;
+LIDARLite_SampleBlock block; //Global so its arrays are aligned
+File logFile;
+
+unsigned long lastReport = 0;
+uint32_t samples = 0;   //Samples logged since the last report
+uint32_t writeTime = 0; //Microseconds spent writing them
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  if (SD.begin(SD_CS_PIN) == false) {
+    Serial.println("SD card not found! Freezing.");
+    while(1);
+  }
+  logFile = SD.open("LIDAR.BIN", FILE_WRITE);
+
+  //check if LIDARs will acknowledge over I2C
+  if (myLIDAR1.begin(0x5B) == false) {
+    Serial.println("LIDAR 1 did not acknowledge! Freezing.");
+    while(1);
+  }
+  if (myLIDAR2.begin() == false) {
+    Serial.println("LIDAR 2 did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("Both LIDARs acknowledged.");
+
+  myLIDAR1.configure(5); //Fastest preset, so logging is the bottleneck
+  myLIDAR2.configure(5);
+
+  scheduler.addSensor(myLIDAR1);
+  scheduler.addSensor(myLIDAR2);
+  scheduler.start();
+}
+
+void loop() {
+  if (BLOCK_OUTPUT) {
+    scheduler.service(block);
+
+    if (block.count == LIDARLITE_BLOCK_SIZE) {
+      unsigned long start = micros();
+
+      //One write per array. The file holds blocks of LIDARLITE_BLOCK_SIZE
+      //timestamps, then distances, then status flags, then sensor numbers.
+      logFile.write((uint8_t *)block.timestamp, sizeof(block.timestamp));
+      logFile.write((uint8_t *)block.distance, sizeof(block.distance));
+      logFile.write(block.status, sizeof(block.status));
+      logFile.write(block.sensor, sizeof(block.sensor));
+
+      writeTime += micros() - start;
+      samples += block.count;
+      block.count = 0; //Reuse the block
+    }
+  }
+  else {
+    scheduler.service();
+
+    for (uint8_t i = 0; i < scheduler.getNumSensors(); i++) {
+      if (scheduler.available(i)) {
+        unsigned long start = micros();
+
+        logFile.print(micros());
+        logFile.print(",");
+        logFile.print(i);
+        logFile.print(",");
+        logFile.println(scheduler.getDistance(i));
+
+        writeTime += micros() - start;
+        samples++;
+      }
+    }
+  }
+
+  if (millis() - lastReport >= 1000) {
+    lastReport = millis();
+    logFile.flush();
+
+    Serial.print(samples);
+    Serial.print(" samples/s, ");
+    Serial.print(samples ? writeTime / samples : 0);
+    Serial.println(" us writing per sample");
+    samples = 0;
+    writeTime = 0;
+  }
+}
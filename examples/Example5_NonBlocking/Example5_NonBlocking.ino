@@ -0,0 +1,55 @@
+/******************************************************************************
+  Takes distance measurements without blocking the main loop.
+
+  getDistance() waits for the whole acquisition, reading the STATUS register
+  over and over until the measurement is done. This example triggers a
+  measurement with startMeasurement() and then calls service() once per pass
+  through loop(), so the rest of the sketch keeps running while the LIDAR works.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+
+LIDARLite_v4LED myLIDAR;
+
+unsigned long loopCount = 0; //Counts how often loop() got to run while waiting
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  //check if LIDAR will acknowledge over I2C
+  if (myLIDAR.begin() == false) {
+    Serial.println("Device did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("LIDAR acknowledged!");
+
+  myLIDAR.startMeasurement(); //Kick off the first measurement
+}
+
+void loop() {
+  //Advance the measurement. This is at most one short STATUS read.
+  myLIDAR.service();
+
+  if (myLIDAR.measurementReady()) {
+    uint16_t newDistance = myLIDAR.fetch();
+
+    Serial.print("New distance: ");
+    Serial.print(newDistance / 100.0);
+    Serial.print(" m, loops while waiting: ");
+    Serial.println(loopCount);
+
+    loopCount = 0;
+    myLIDAR.startMeasurement(); //Start the next one right away
+  }
+
+  //Do other work here
+  loopCount++;
+  delayMicroseconds(100);
+}
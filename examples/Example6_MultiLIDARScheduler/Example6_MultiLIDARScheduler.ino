@@ -0,0 +1,70 @@
+/******************************************************************************
+  Reads two LIDARs in parallel with the multi-sensor scheduler.
+
+  Example 3 reads one LIDAR and then the other with getDistance(), so every
+  sample waits for the previous sensor's full acquisition. The scheduler starts
+  both acquisitions together and collects each result as soon as it is ready,
+  so the total sample rate grows with the number of sensors.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Add another Qwiic LIDAR using Qwiic cable.
+  For this example to work, the two Qwiic LIDAR's need to have different addresses.
+  One is at the default 0x62 and the other at 0x5B. Revisit example 2 to change the
+  address of your Qwiic LIDAR sensor.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+#include <LIDARLite_v4LED_Scheduler.h>
+
+LIDARLite_v4LED myLIDAR1;
+LIDARLite_v4LED myLIDAR2;
+LIDARLite_v4LED_Scheduler scheduler;
+
+unsigned long lastReport = 0;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  //check if LIDARs will acknowledge over I2C
+  if (myLIDAR1.begin(0x5B) == false) {
+    Serial.println("LIDAR 1 did not acknowledge! Freezing.");
+    while(1);
+  }
+  if (myLIDAR2.begin() == false) {
+    Serial.println("LIDAR 2 did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("Both LIDARs acknowledged.");
+
+  scheduler.addSensor(myLIDAR1);
+  scheduler.addSensor(myLIDAR2);
+  scheduler.start(); //Trigger both LIDARs at once
+}
+
+void loop() {
+  //Collect finished measurements and restart those sensors
+  scheduler.service();
+
+  //Report once a second so printing does not slow down the sensors
+  if (millis() - lastReport >= 1000) {
+    lastReport = millis();
+
+    for (uint8_t i = 0; i < scheduler.getNumSensors(); i++) {
+      Serial.print("LIDAR ");
+      Serial.print(i + 1);
+      Serial.print(" distance: ");
+      Serial.print(scheduler.getDistance(i) / 100.0);
+      Serial.print(" m at ");
+      Serial.print(scheduler.getSensorHz(i));
+      Serial.println(" Hz");
+    }
+    Serial.print("Total: ");
+    Serial.print(scheduler.getTotalHz());
+    Serial.println(" Hz");
+  }
+}
@@ -0,0 +1,64 @@
+/******************************************************************************
+  Lets the LIDAR measure on its own and collects the results.
+
+  In continuous mode the LIDAR triggers its own measurements at the rate set by
+  the MEASUREMENT_INTERVAL register. The Arduino no longer has to start every
+  measurement and wait for it, it just reads each result once it is due.
+  Results are kept in a small ring buffer, so loop() can print them in batches.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+
+LIDARLite_v4LED myLIDAR;
+
+//Value for the MEASUREMENT_INTERVAL register. The library counts it in
+//LIDARLITE_INTERVAL_UNIT_US (1 ms unless defined otherwise before the
+//#include) and measures the real period when continuous mode starts.
+#define MEASUREMENT_INTERVAL_VALUE 20
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  //check if LIDAR will acknowledge over I2C
+  if (myLIDAR.begin() == false) {
+    Serial.println("Device did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("LIDAR acknowledged!");
+
+  if (myLIDAR.startContinuous(MEASUREMENT_INTERVAL_VALUE) == false) {
+    Serial.println("Could not start continuous mode! Freezing.");
+    while(1);
+  }
+  Serial.print("Sample period: ");
+  Serial.print(myLIDAR.getSamplePeriod());
+  Serial.println(" us");
+}
+
+void loop() {
+  //Reads the distance once STATUS shows a new measurement has finished
+  myLIDAR.serviceContinuous();
+
+  //Print in batches to keep Serial from slowing down the sampling
+  if (myLIDAR.samplesAvailable() >= 4) {
+    LIDARLite_Sample sample;
+    while (myLIDAR.readSample(sample)) {
+      Serial.print("#");
+      Serial.print(sample.sequence);
+      Serial.print(" distance: ");
+      Serial.print(sample.distance / 100.0);
+      Serial.println(" m");
+    }
+    Serial.print("Missed: ");
+    Serial.print(myLIDAR.getMissedCount());
+    Serial.print(" Overruns: ");
+    Serial.println(myLIDAR.getOverrunCount());
+  }
+}
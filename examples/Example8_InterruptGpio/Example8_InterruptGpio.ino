@@ -0,0 +1,61 @@
+/******************************************************************************
+  Uses the trigger and monitor pins with an interrupt instead of polling.
+
+  The monitor pin goes low when a measurement is done. An interrupt on that
+  edge records the completion, so the Arduino does not spend any time watching
+  the pin while the LIDAR works. loop() reads the distance whenever a
+  completion is waiting and starts the next measurement.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Connect the LIDAR's trigger pin to TRIGGER_PIN and its monitor pin to
+  MONITOR_PIN. MONITOR_PIN must be able to trigger an interrupt (pin 2 or 3
+  on an Uno).
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+
+#define TRIGGER_PIN 4
+#define MONITOR_PIN 2
+
+LIDARLite_v4LED myLIDAR;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  pinMode(TRIGGER_PIN, OUTPUT);
+  pinMode(MONITOR_PIN, INPUT);
+
+  //check if LIDAR will acknowledge over I2C
+  if (myLIDAR.begin() == false) {
+    Serial.println("Device did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("LIDAR acknowledged!");
+
+  if (myLIDAR.beginInterrupt(TRIGGER_PIN, MONITOR_PIN) == false) {
+    Serial.println("Monitor pin does not support interrupts! Freezing.");
+    while(1);
+  }
+
+  myLIDAR.takeRangeInterrupt(); //Start the first measurement
+}
+
+void loop() {
+  LIDARLite_Sample sample;
+
+  //Only touches the bus when the interrupt has seen a measurement finish
+  if (myLIDAR.readInterruptSample(sample)) {
+    myLIDAR.takeRangeInterrupt(); //Start the next one before printing
+
+    Serial.print("New distance: ");
+    Serial.print(sample.distance / 100.0);
+    Serial.println(" m");
+  }
+
+  //The rest of loop() is free for other work
+}
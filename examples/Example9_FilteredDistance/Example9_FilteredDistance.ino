@@ -0,0 +1,49 @@
+/******************************************************************************
+  Smooths the distance readings with a chain of filters.
+
+  Each reading first goes through an outlier gate that ignores sudden jumps of
+  more than 50 cm (unless they last for 3 readings), then a median of the last
+  5 readings, then a constant velocity Kalman filter. The filters use no
+  dynamic memory and no floating point.
+
+  Hardware Connections:
+  Plug Qwiic LIDAR into Qwiic RedBoard using Qwiic cable.
+  Set serial monitor to 115200 baud.
+
+  Distributed as-is; no warranty is given.
+******************************************************************************/
+#include <LIDARLite_v4LED.h> //Click here to get the library: http://librarymanager/All#SparkFun_LIDARLitev4 by SparkFun
+#include <LIDARLite_v4LED_Filter.h>
+
+LIDARLite_v4LED myLIDAR;
+
+//Outlier gate -> median of 5 -> Kalman filter with alpha 0.5, beta 0.1
+LIDARLite_FilterPipeline<LIDARLite_OutlierGate<50, 3>,
+                         LIDARLite_MedianFilter<5>,
+                         LIDARLite_KalmanCVFilter<128, 26> > filter;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Qwiic LIDARLite_v4 examples");
+  Wire.begin(); //Join I2C bus
+
+  //check if LIDAR will acknowledge over I2C
+  if (myLIDAR.begin() == false) {
+    Serial.println("Device did not acknowledge! Freezing.");
+    while(1);
+  }
+  Serial.println("LIDAR acknowledged!");
+}
+
+void loop() {
+  uint16_t rawDistance = myLIDAR.getDistance();
+  uint16_t smoothDistance = filter.update(rawDistance); //Same as myLIDAR.getDistance(filter)
+
+  Serial.print("Raw: ");
+  Serial.print(rawDistance);
+  Serial.print(" cm, filtered: ");
+  Serial.print(smoothDistance);
+  Serial.println(" cm");
+
+  delay(20);
+}
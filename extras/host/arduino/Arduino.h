@@ -0,0 +1,182 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  Arduino.h
+
+  Just enough of the Arduino core to build the library and the examples on a
+  Linux host. Time, pins and interrupts are provided by the simulator in
+  ../sim, so micros() only moves when the simulated bus, delay() or a
+  pin access spends time.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define NOT_AN_INTERRUPT -1
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define LED_BUILTIN 13
+#define PIN_WIRE_SDA 20
+#define PIN_WIRE_SCL 21
+
+#define F(string) (string)
+
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+void attachInterrupt(int interruptNumber, void (*isr)(), int mode);
+void detachInterrupt(int interruptNumber);
+void noInterrupts();
+void interrupts();
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+
+class String
+{
+private:
+  char _buffer[64];
+
+public:
+  String(const char *text = "")
+  {
+    strncpy(_buffer, text, sizeof(_buffer) - 1);
+    _buffer[sizeof(_buffer) - 1] = 0;
+  }
+  const char *c_str() const { return _buffer; }
+  unsigned int length() const { return strlen(_buffer); }
+  void toCharArray(char *out, unsigned int size) const
+  {
+    if (size == 0)
+      return;
+    strncpy(out, _buffer, size - 1);
+    out[size - 1] = 0;
+  }
+};
+
+class Print
+{
+private:
+  size_t printNumber(unsigned long value, int base)
+  {
+    char text[8 * sizeof(long) + 1];
+    char *p = &text[sizeof(text) - 1];
+
+    *p = 0;
+    if (base < 2)
+      base = 10;
+    do
+    {
+      int digit = value % base;
+      *--p = (digit < 10) ? '0' + digit : 'A' + digit - 10;
+      value /= base;
+    } while (value);
+
+    return print(p);
+  }
+
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t value) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t written = 0;
+    while (written < size && write(buffer[written]))
+      written++;
+    return written;
+  }
+  virtual int availableForWrite() { return 0; }
+  size_t write(const char *text) { return write((const uint8_t *)text, strlen(text)); }
+
+  size_t print(const char *text) { return write(text); }
+  size_t print(const String &text) { return write(text.c_str()); }
+  size_t print(char value) { return write((uint8_t)value); }
+  size_t print(unsigned long value, int base = DEC) { return printNumber(value, base); }
+  size_t print(long value, int base = DEC)
+  {
+    if (value < 0 && base == DEC)
+      return print('-') + printNumber(-(unsigned long)value, base);
+    return printNumber(value, base);
+  }
+  size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(int value, int base = DEC) { return print((long)value, base); }
+  size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(double value, int digits = 2)
+  {
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return print(text);
+  }
+
+  size_t println() { return print("\r\n"); }
+  template <class T>
+  size_t println(T value) { return print(value) + println(); }
+  template <class T>
+  size_t println(T value, int format) { return print(value, format) + println(); }
+};
+
+//Serial prints to stdout and never has input
+class HardwareSerial : public Print
+{
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  size_t write(uint8_t value)
+  {
+    fputc(value, stdout);
+    return 1;
+  }
+  using Print::write;
+  int availableForWrite() { return 64; }
+  int available() { return 0; }
+  int read() { return -1; }
+  String readString() { return String(); }
+  void flush() { fflush(stdout); }
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,56 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  SD.h
+
+  An SD card whose files accept every byte and keep none, so the logging
+  examples build on a host.
+
+------------------------------------------------------------------------------*/
+#ifndef SD_h
+#define SD_h
+
+#include <Arduino.h>
+
+#define FILE_READ 0
+#define FILE_WRITE 1
+
+class File : public Print
+{
+public:
+  size_t write(uint8_t value)
+  {
+    (void)value;
+    return 1;
+  }
+  size_t write(const uint8_t *buffer, size_t size)
+  {
+    (void)buffer;
+    return size;
+  }
+  using Print::write;
+  int availableForWrite() { return 512; }
+  void flush() {}
+  void close() {}
+  operator bool() { return true; }
+};
+
+class SDClass
+{
+public:
+  bool begin(uint8_t csPin = 0)
+  {
+    (void)csPin;
+    return true;
+  }
+  File open(const char *path, uint8_t mode = FILE_READ)
+  {
+    (void)path;
+    (void)mode;
+    return File();
+  }
+};
+
+extern SDClass SD;
+
+#endif
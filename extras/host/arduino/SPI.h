@@ -0,0 +1,14 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  SPI.h
+
+  Empty, for examples that include it next to SD.h.
+
+------------------------------------------------------------------------------*/
+#ifndef SPI_h
+#define SPI_h
+
+#include <Arduino.h>
+
+#endif
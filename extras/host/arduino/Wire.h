@@ -0,0 +1,59 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  Wire.h
+
+  TwoWire with the AVR Wire semantics the library relies on, backed by the
+  simulated bus in ../sim/LidarSim.cpp: endTransmission() returns 2 when no
+  device acknowledges the address, requestFrom() returns the number of bytes
+  received, and the receive buffer holds BUFFER_LENGTH bytes.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH 32
+
+class TwoWire
+{
+private:
+  uint8_t _address = 0;
+  uint8_t _txBuffer[BUFFER_LENGTH];
+  uint8_t _txLength = 0;
+  uint8_t _rxBuffer[BUFFER_LENGTH];
+  uint8_t _rxLength = 0;
+  uint8_t _rxIndex = 0;
+
+public:
+  void begin();
+  void end();
+  void setClock(uint32_t frequency);
+
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t write(uint8_t value);
+  size_t write(const uint8_t *buffer, size_t size);
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+  int available();
+  int read();
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1; //Same simulated bus as Wire, for sketches written for boards with a second port
+
+#endif
@@ -0,0 +1,224 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  bench_async.cpp
+
+  Aggregate sample rate of 1 to LIDARLITE_ASYNC_MAX_PENDING simulated sensors
+  on one bus: read one after another with getDistance(), the blocking loop a
+  thread per sensor would run, and kept measuring by one
+  LIDARLite_v4LED_Async event loop, every callback queueing the next
+  measurement of its sensor, and with coroutines where the compiler has
+  them. Each pattern runs for one second of simulated time at 400 kHz with
+  service() called every 50 us. The program fails if a result is not
+  LIDARLITE_ASYNC_OK with the sensor's distance, if the event loop's speedup
+  over the blocking loop stays below 80% of the sensor count, or if the
+  coroutines count more than 1% fewer samples than the callbacks.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_Async.h"
+#include "LidarSim.h"
+
+#define RUN_MS 1000
+#define SERIALS {0xD0000000, 0xD0000001, 0xD0000002, 0xD0000003, \
+                 0xD0000004, 0xD0000005, 0xD0000006, 0xD0000007, \
+                 0xD0000008, 0xD0000009, 0xD000000A, 0xD000000B, \
+                 0xD000000C, 0xD000000D, 0xD000000E, 0xD000000F}
+
+static int failures = 0;
+
+struct Rig
+{
+  SimLidar sims[LIDARLITE_ASYNC_MAX_PENDING] = SERIALS;
+  LIDARLite_v4LED lidars[LIDARLITE_ASYNC_MAX_PENDING];
+
+  // numSensors sensors on the default address, moved to 0x30 + i
+  explicit Rig(uint8_t numSensors)
+  {
+    LIDARLite_AddressAssignment table[LIDARLITE_ASYNC_MAX_PENDING];
+    LIDARLite_v4LED shared;
+
+    simReset();
+    Wire.setClock(400000);
+    for (uint8_t i = 0; i < numSensors; i++)
+    {
+      sims[i].setDistance(100 + 20 * i);
+      sims[i].setNoise(0);
+      simAttach(sims[i]);
+      for (uint8_t j = 0; j < 4; j++)
+        table[i].unitId[j] = sims[i].getRegister(0x16 + j);
+      table[i].address = 0x30 + i;
+    }
+    shared.begin();
+    if (shared.provisionAddresses(table, numSensors) != numSensors)
+    {
+      printf("MISMATCH %u sensors: provisioning failed\n", numSensors);
+      failures++;
+    }
+    for (uint8_t i = 0; i < numSensors; i++)
+      lidars[i].begin(0x30 + i);
+  }
+};
+
+// One sensor's part of the event loop run
+struct Stream
+{
+  LIDARLite_v4LED_Async *loop;
+  LIDARLite_v4LED *sensor;
+  uint16_t distance; // Expected
+  uint64_t end;      // simNanos() after which no new measurement is queued
+  uint32_t samples;
+  uint32_t errors;
+};
+
+static void check(Stream &stream, uint8_t status, uint16_t distance)
+{
+  if (status == LIDARLITE_ASYNC_OK && distance == stream.distance)
+    stream.samples++;
+  else
+    stream.errors++;
+}
+
+// Counts the result and measures again straight away
+static void onDistance(void *context, uint8_t status, uint16_t distance)
+{
+  Stream &stream = *(Stream *)context;
+
+  check(stream, status, distance);
+  if (simNanos() < stream.end)
+    stream.loop->measure(*stream.sensor, onDistance, &stream);
+}
+
+// getDistance() on each sensor in turn
+static float blockingHz(uint8_t numSensors)
+{
+  Rig rig(numSensors);
+  uint32_t samples = 0;
+  uint64_t end = simNanos() + (uint64_t)RUN_MS * 1000000;
+
+  while (simNanos() < end)
+    for (uint8_t i = 0; i < numSensors; i++)
+    {
+      rig.lidars[i].getDistance();
+      samples++;
+    }
+  return samples * 1000.0f / RUN_MS;
+}
+
+// Runs the loop until every stream has stopped queueing and its last request completed
+static float runLoop(LIDARLite_v4LED_Async &loop, Stream *streams, uint8_t numSensors, uint64_t start)
+{
+  uint32_t samples = 0;
+
+  while (loop.getPending() > 0)
+  {
+    loop.service();
+    delayMicroseconds(50);
+  }
+
+  for (uint8_t i = 0; i < numSensors; i++)
+  {
+    samples += streams[i].samples;
+    if (streams[i].errors > 0)
+    {
+      printf("MISMATCH %u sensors: sensor %u had %lu failed results\n", numSensors, i,
+             (unsigned long)streams[i].errors);
+      failures++;
+    }
+  }
+  return samples * 1e9f / (simNanos() - start);
+}
+
+// One measurement in flight per sensor, each callback queueing the next
+static float callbackHz(uint8_t numSensors)
+{
+  Rig rig(numSensors);
+  LIDARLite_v4LED_Async loop;
+  Stream streams[LIDARLITE_ASYNC_MAX_PENDING];
+  uint64_t start = simNanos();
+
+  for (uint8_t i = 0; i < numSensors; i++)
+  {
+    streams[i] = {&loop, &rig.lidars[i], (uint16_t)(100 + 20 * i), start + (uint64_t)RUN_MS * 1000000, 0, 0};
+    loop.measure(rig.lidars[i], onDistance, &streams[i]);
+  }
+  return runLoop(loop, streams, numSensors, start);
+}
+
+#if LIDARLITE_ASYNC_COROUTINES
+// Fire-and-forget coroutine: starts at once, frees its frame when it returns
+struct Task
+{
+  struct promise_type
+  {
+    Task get_return_object() { return Task(); }
+    std::suspend_never initial_suspend() { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() {}
+  };
+};
+
+static Task measureUntilEnd(Stream &stream)
+{
+  while (simNanos() < stream.end)
+  {
+    LIDARLite_AsyncResult result = co_await stream.loop->measure(*stream.sensor);
+    check(stream, result.status, result.distance);
+  }
+}
+
+// The same with one coroutine per sensor
+static float coroutineHz(uint8_t numSensors)
+{
+  Rig rig(numSensors);
+  LIDARLite_v4LED_Async loop;
+  Stream streams[LIDARLITE_ASYNC_MAX_PENDING];
+  uint64_t start = simNanos();
+
+  for (uint8_t i = 0; i < numSensors; i++)
+  {
+    streams[i] = {&loop, &rig.lidars[i], (uint16_t)(100 + 20 * i), start + (uint64_t)RUN_MS * 1000000, 0, 0};
+    measureUntilEnd(streams[i]);
+  }
+  return runLoop(loop, streams, numSensors, start);
+}
+#endif
+
+int main()
+{
+  SimLidar probe;
+  printf("Acquisition %lu us at the default settings, 400 kHz bus\n\n", (unsigned long)probe.acquisitionTimeUs());
+  printf("| Sensors | Blocking, Hz | Callbacks, Hz | Coroutines, Hz | Speedup |\n");
+  printf("|--:|--:|--:|--:|--:|\n");
+
+  for (uint8_t numSensors = 1; numSensors <= LIDARLITE_ASYNC_MAX_PENDING; numSensors *= 2)
+  {
+    float blocking = blockingHz(numSensors);
+    float callbacks = callbackHz(numSensors);
+    float speedup = callbacks / blocking;
+#if LIDARLITE_ASYNC_COROUTINES
+    float coroutines = coroutineHz(numSensors);
+    printf("| %u | %.0f | %.0f | %.0f | %.2fx |\n", numSensors, blocking, callbacks, coroutines, speedup);
+    if (coroutines < callbacks * 0.99f)
+    {
+      printf("MISMATCH %u sensors: coroutines %.0f Hz, callbacks %.0f Hz\n", numSensors, coroutines, callbacks);
+      failures++;
+    }
+#else
+    printf("| %u | %.0f | %.0f | | %.2fx |\n", numSensors, blocking, callbacks, speedup);
+#endif
+
+    if (speedup < 0.8f * numSensors)
+    {
+      printf("MISMATCH %u sensors: speedup %.2f\n", numSensors, speedup);
+      failures++;
+    }
+  }
+
+  return (failures == 0) ? 0 : 1;
+}
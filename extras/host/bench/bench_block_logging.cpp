@@ -0,0 +1,246 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  bench_block_logging.cpp
+
+  Example 20 on the simulator: two sensors on the very short range preset,
+  run by the scheduler for RUN_MS of simulated time and logged to a memory
+  "file" three ways. Block writes each LIDARLite_SampleBlock array once per
+  LIDARLITE_BLOCK_SIZE samples. Text prints one line per sample as the
+  example's BLOCK_OUTPUT false does. Record writes one binary record per
+  sample, the same bytes as the block but one call at a time. The table
+  shows write calls, bytes and host time spent logging per sample. The
+  simulator is deterministic and logging takes no simulated time, so all
+  three runs see the same measurements. The program fails if a run logs a
+  different number of samples than the scheduler counted, or if the block
+  log and the record log disagree on any sensor or distance. Host time is
+  printed, not checked; it includes one pair of clock reads per block for
+  the block output and per sample for the others.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_Scheduler.h"
+#include "LidarSim.h"
+
+#define RUN_MS 2000
+#define NUM_SENSORS 2
+#define MAX_SAMPLES 16384
+
+enum Output
+{
+  OUTPUT_BLOCK,
+  OUTPUT_TEXT,
+  OUTPUT_RECORD,
+};
+
+static const char *const outputNames[3] = {"Block", "Text", "Record"};
+
+// Append-only memory file counting write calls, wrapping when full
+struct MemoryLog
+{
+  uint8_t data[1 << 20];
+  uint32_t size;
+  uint32_t bytes;
+  uint32_t writes;
+
+  void write(const void *source, uint32_t length)
+  {
+    if (size + length > sizeof(data))
+      size = 0;
+    memcpy(data + size, source, length);
+    size += length;
+    bytes += length;
+    writes++;
+  }
+};
+
+struct Record
+{
+  unsigned long timestamp;
+  uint16_t distance;
+  uint8_t status;
+  uint8_t sensor;
+};
+
+struct Result
+{
+  uint32_t samples;  // Logged
+  uint32_t measured; // Counted by the scheduler
+  uint32_t writes;
+  uint32_t bytes;
+  double hostNs;     // Spent in the logging code
+};
+
+static MemoryLog logFile;
+static LIDARLite_SampleBlock block;
+static int failures = 0;
+
+// Writes the block out whole, one call per array
+static void writeBlock()
+{
+  logFile.write(block.timestamp, block.count * sizeof(block.timestamp[0]));
+  logFile.write(block.distance, block.count * sizeof(block.distance[0]));
+  logFile.write(block.status, block.count * sizeof(block.status[0]));
+  logFile.write(block.sensor, block.count * sizeof(block.sensor[0]));
+}
+
+static Result run(Output output, uint8_t *loggedSensors, uint16_t *loggedDistances)
+{
+  SimLidar sims[NUM_SENSORS] = {0xC0000000, 0xC0000001};
+  LIDARLite_v4LED lidars[NUM_SENSORS];
+  LIDARLite_AddressAssignment table[NUM_SENSORS];
+  LIDARLite_v4LED_Scheduler scheduler;
+  Result result = {};
+
+  simReset();
+  Wire.setClock(400000);
+  for (uint8_t i = 0; i < NUM_SENSORS; i++)
+  {
+    sims[i].setDistance(120 + 40 * i);
+    simAttach(sims[i]);
+    for (uint8_t j = 0; j < 4; j++)
+      table[i].unitId[j] = sims[i].getRegister(0x16 + j);
+    table[i].address = 0x30 + i;
+  }
+  lidars[0].begin();
+  lidars[0].provisionAddresses(table, NUM_SENSORS);
+  for (uint8_t i = 0; i < NUM_SENSORS; i++)
+  {
+    lidars[i].begin(0x30 + i);
+    lidars[i].configure(5);
+    scheduler.addSensor(lidars[i]);
+  }
+
+  memset(&logFile, 0, sizeof(logFile));
+  block.count = 0;
+  std::chrono::steady_clock::duration hostTime{0};
+  uint64_t end = simNanos() + (uint64_t)RUN_MS * 1000000;
+
+  scheduler.start();
+  while (simNanos() < end)
+  {
+    if (output == OUTPUT_BLOCK)
+    {
+      uint16_t first = block.count;
+      scheduler.service(block);
+      for (uint16_t i = first; i < block.count; i++, result.samples++)
+      {
+        if (result.samples < MAX_SAMPLES)
+        {
+          loggedSensors[result.samples] = block.sensor[i];
+          loggedDistances[result.samples] = block.distance[i];
+        }
+      }
+
+      if (block.count == LIDARLITE_BLOCK_SIZE)
+      {
+        auto start = std::chrono::steady_clock::now();
+        writeBlock();
+        hostTime += std::chrono::steady_clock::now() - start;
+        block.count = 0;
+      }
+    }
+    else
+    {
+      scheduler.service();
+
+      for (uint8_t i = 0; i < NUM_SENSORS; i++)
+      {
+        if (scheduler.available(i) == false)
+          continue;
+
+        auto start = std::chrono::steady_clock::now();
+        uint16_t distance = scheduler.getDistance(i);
+        if (output == OUTPUT_TEXT)
+        {
+          char line[32];
+          int length = snprintf(line, sizeof(line), "%lu,%u,%u\n", micros(), i, distance);
+          logFile.write(line, length);
+        }
+        else
+        {
+          Record record = {micros(), distance, 0, i};
+          logFile.write(&record, sizeof(record));
+        }
+        hostTime += std::chrono::steady_clock::now() - start;
+
+        if (result.samples < MAX_SAMPLES)
+        {
+          loggedSensors[result.samples] = i;
+          loggedDistances[result.samples] = distance;
+        }
+        result.samples++;
+      }
+    }
+  }
+
+  // The last partial block
+  if (output == OUTPUT_BLOCK && block.count > 0)
+  {
+    auto start = std::chrono::steady_clock::now();
+    writeBlock();
+    hostTime += std::chrono::steady_clock::now() - start;
+  }
+
+  for (uint8_t i = 0; i < NUM_SENSORS; i++)
+    result.measured += scheduler.getSampleCount(i);
+  result.writes = logFile.writes;
+  result.bytes = logFile.bytes;
+  result.hostNs = std::chrono::duration<double, std::nano>(hostTime).count();
+  return result;
+}
+
+int main()
+{
+  // Sensor and distance of every sample, in the order logged
+  static uint8_t blockSensors[MAX_SAMPLES];
+  static uint16_t blockDistances[MAX_SAMPLES];
+  static uint8_t recordSensors[MAX_SAMPLES];
+  static uint16_t recordDistances[MAX_SAMPLES];
+  static uint8_t scratchSensors[MAX_SAMPLES];
+  static uint16_t scratchDistances[MAX_SAMPLES];
+
+  printf("%u sensors, preset 5, %u ms of simulated time at 400 kHz\n\n", NUM_SENSORS, RUN_MS);
+  printf("| Output | Samples | Write calls/sample | Bytes/sample | Host ns/sample |\n");
+  printf("|---|--:|--:|--:|--:|\n");
+
+  Result results[3];
+  results[OUTPUT_BLOCK] = run(OUTPUT_BLOCK, blockSensors, blockDistances);
+  results[OUTPUT_TEXT] = run(OUTPUT_TEXT, scratchSensors, scratchDistances);
+  results[OUTPUT_RECORD] = run(OUTPUT_RECORD, recordSensors, recordDistances);
+
+  for (uint8_t output = 0; output < 3; output++)
+  {
+    const Result &result = results[output];
+    float samples = (result.samples > 0) ? result.samples : 1;
+
+    printf("| %s | %lu | %.3f | %.1f | %.1f |\n", outputNames[output], (unsigned long)result.samples,
+           result.writes / samples, result.bytes / samples, result.hostNs / samples);
+
+    if (result.samples != result.measured)
+    {
+      printf("MISMATCH %s: logged %lu of %lu samples\n", outputNames[output], (unsigned long)result.samples,
+             (unsigned long)result.measured);
+      failures++;
+    }
+  }
+
+  uint32_t compared = results[OUTPUT_BLOCK].samples;
+  if (compared > MAX_SAMPLES)
+    compared = MAX_SAMPLES;
+  if (results[OUTPUT_RECORD].samples != results[OUTPUT_BLOCK].samples ||
+      memcmp(blockSensors, recordSensors, compared) != 0 ||
+      memcmp(blockDistances, recordDistances, compared * sizeof(blockDistances[0])) != 0)
+  {
+    printf("MISMATCH block and record logs differ\n");
+    failures++;
+  }
+
+  return (failures == 0) ? 0 : 1;
+}
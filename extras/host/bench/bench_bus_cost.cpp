@@ -0,0 +1,191 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  bench_bus_cost.cpp
+
+  Measures the "I2C Bus Cost" table in README.md: every function is run
+  against a simulated sensor at 100 kHz, 400 kHz and 1 MHz, and the
+  transactions, bytes and bus time the simulated bus saw are printed as the
+  table's markdown rows. Rows whose cost depends on a count (n, k, P) are
+  checked for several counts instead, and the program fails if the formula
+  in the table does not hold.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include "LIDARLite_v4LED.h"
+#include "LidarSim.h"
+
+static const uint32_t clocks[3] = {100000, 400000, 1000000};
+static int failures = 0;
+
+struct Cost
+{
+  uint32_t transactions;
+  uint32_t bytes;
+  uint32_t busTimeUs[3];
+};
+
+typedef void (*Setup)(LIDARLite_v4LED &lidar, SimLidar &sim);
+typedef void (*Action)(LIDARLite_v4LED &lidar);
+
+static void noSetup(LIDARLite_v4LED &lidar, SimLidar &sim)
+{
+  (void)lidar;
+  (void)sim;
+}
+
+// Run action on a fresh sensor at each clock rate, counting only what action puts on the bus
+static Cost measure(Setup setup, Action action)
+{
+  Cost cost = {0, 0, {0, 0, 0}};
+
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    SimLidar sim;
+    LIDARLite_v4LED lidar;
+
+    simReset();
+    simAttach(sim);
+    Wire.setClock(clocks[i]);
+    lidar.begin();
+    setup(lidar, sim);
+
+    simClearBusStats();
+    action(lidar);
+    SimBusStats stats = simGetBusStats();
+
+    cost.transactions = stats.transactions;
+    cost.bytes = stats.bytes;
+    cost.busTimeUs[i] = (stats.busTimeNs + 500) / 1000;
+  }
+  return cost;
+}
+
+static void printRow(const char *name, Setup setup, Action action)
+{
+  Cost cost = measure(setup, action);
+  printf("| %s | %lu | %lu | %lu | %lu | %lu |\n", name, (unsigned long)cost.transactions,
+         (unsigned long)cost.bytes, (unsigned long)cost.busTimeUs[0], (unsigned long)cost.busTimeUs[1],
+         (unsigned long)cost.busTimeUs[2]);
+}
+
+static void checkFormula(const char *name, uint32_t count, Cost cost, uint32_t transactions, uint32_t bytes)
+{
+  if (cost.transactions != transactions || cost.bytes != bytes)
+  {
+    printf("MISMATCH %s, count %lu: measured %lu transactions %lu bytes, table says %lu %lu\n", name,
+           (unsigned long)count, (unsigned long)cost.transactions, (unsigned long)cost.bytes,
+           (unsigned long)transactions, (unsigned long)bytes);
+    failures++;
+  }
+}
+
+// Rows with a count, measured for a few values of it
+static uint8_t count;
+static uint8_t buffer[16];
+static int16_t record[192];
+
+static void checkCountedRows()
+{
+  for (count = 1; count <= 8; count++)
+  {
+    checkFormula("write()", count, measure(noSetup, [](LIDARLite_v4LED &lidar) { lidar.write(0x05, buffer, count); }),
+                 1, 2 + count);
+    checkFormula("read()", count, measure(noSetup, [](LIDARLite_v4LED &lidar) { lidar.read(0x05, buffer, count); }),
+                 2, 3 + count);
+  }
+
+  // k of the five registers restoreConfiguration() replays, written since begin()
+  for (count = 0; count <= 5; count++)
+  {
+    checkFormula("restoreConfiguration()", count,
+                 measure(
+                     [](LIDARLite_v4LED &lidar, SimLidar &sim) {
+                       const uint8_t replay[] = {0x05, 0xE5, 0x1C, 0xEB, 0xE2};
+                       (void)sim;
+                       for (uint8_t i = 0; i < count; i++)
+                         lidar.write(replay[i], buffer, 1);
+                     },
+                     [](LIDARLite_v4LED &lidar) { lidar.restoreConfiguration(); }),
+                 count, 3 * count);
+  }
+
+  // P busy polls: shorten the wait before the first poll until it takes P polls
+  for (count = 0; count < 12; count++)
+  {
+    static uint32_t polls;
+    Cost cost = measure(
+        [](LIDARLite_v4LED &lidar, SimLidar &sim) {
+          LIDARLite_Profile profile = LIDARLITE_PROFILE_MAX_RANGE;
+          profile.minAcquisitionUs = sim.acquisitionTimeUs() + 100 - 100 * count;
+          lidar.applyProfile(profile);
+        },
+        [](LIDARLite_v4LED &lidar) {
+          lidar.getDistance();
+          polls = lidar.getLastWaitPolls();
+        });
+    checkFormula("getDistance()", polls, cost, 3 + 2 * polls, 8 + 4 * polls);
+  }
+
+  // k acknowledge polls: the sensor is back 10 ms later, at the first one
+  checkFormula("useDefaultAddress()", 1,
+               measure(
+                   [](LIDARLite_v4LED &lidar, SimLidar &sim) {
+                     (void)sim;
+                     lidar.setI2Caddr(0x40, false);
+                   },
+                   [](LIDARLite_v4LED &lidar) { lidar.useDefaultAddress(); }),
+               2 + 1, 6 + 1);
+}
+
+int main()
+{
+  printf("| Function | Transactions | Bytes | 100 kHz | 400 kHz | 1 MHz |\n");
+  printf("|----------|:------------:|:-----:|--------:|--------:|------:|\n");
+
+  printRow("`isConnected()`", noSetup, [](LIDARLite_v4LED &lidar) { lidar.isConnected(); });
+  printRow("`takeRange()`, `startMeasurement()`", noSetup, [](LIDARLite_v4LED &lidar) { lidar.takeRange(); });
+  printRow("`getBusyFlag()`, `service()` while busy", noSetup, [](LIDARLite_v4LED &lidar) { lidar.getBusyFlag(); });
+  printRow("`readDistance()`", noSetup, [](LIDARLite_v4LED &lidar) { lidar.readDistance(); });
+  printRow("`service()` when the measurement completes",
+           [](LIDARLite_v4LED &lidar, SimLidar &sim) {
+             (void)sim;
+             lidar.startMeasurement();
+             delay(10);
+           },
+           [](LIDARLite_v4LED &lidar) { lidar.service(); });
+  printRow("`getDistance()`, one busy poll",
+           [](LIDARLite_v4LED &lidar, SimLidar &sim) {
+             (void)sim;
+             LIDARLite_Profile profile = LIDARLITE_PROFILE_MAX_RANGE;
+             profile.minAcquisitionUs = 20000; // Past the end of the acquisition
+             lidar.applyProfile(profile);
+           },
+           [](LIDARLite_v4LED &lidar) { lidar.getDistance(); });
+  printRow("`configure()`", noSetup, [](LIDARLite_v4LED &lidar) { lidar.configure(0); });
+  printRow("`enableFlash()`, `setPowerModeAlwaysOn()`, `setPowerModeAsync()`, `enableHighAccuracyMode()`, "
+           "`factoryReset()`, `useNewAddressOnly()`, `useBothAddresses()`",
+           noSetup, [](LIDARLite_v4LED &lidar) { lidar.setPowerModeAlwaysOn(); });
+  printRow("`getBoardTemp()`, `getSOCTemp()`", noSetup, [](LIDARLite_v4LED &lidar) { lidar.getBoardTemp(); });
+  printRow("`readStatusDistance()`, `service()` with fused reads", noSetup, [](LIDARLite_v4LED &lidar) {
+    LIDARLite_Reading reading;
+    lidar.readStatusDistance(reading);
+  });
+  printRow("`readTelemetry()`", noSetup, [](LIDARLite_v4LED &lidar) {
+    LIDARLite_Reading reading;
+    if (!lidar.readTelemetry(reading))
+      failures++;
+  });
+  printRow("`setI2Caddr()`", noSetup, [](LIDARLite_v4LED &lidar) { lidar.setI2Caddr(0x40); });
+  printRow("`correlationRecordRead()`, 192 points", noSetup,
+           [](LIDARLite_v4LED &lidar) { lidar.correlationRecordRead(record, 192); });
+  printRow("`correlationRecordReadWindow()`, 32 points ending at point 64", noSetup,
+           [](LIDARLite_v4LED &lidar) { lidar.correlationRecordReadWindow(record, 32, 32); });
+
+  checkCountedRows();
+
+  return (failures == 0) ? 0 : 1;
+}
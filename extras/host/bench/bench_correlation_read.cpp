@@ -0,0 +1,109 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  bench_correlation_read.cpp
+
+  Bus cost of reading the whole 192 point correlation record with
+  correlationRecordRead(), one 2 byte read of CORR_DATA per point, next to
+  the bulk read a larger Wire buffer suggests: reads of 0x52 as long as
+  BUFFER_LENGTH, enough of them to cover 384 bytes. The bulk read costs a
+  sixteenth of the transactions, but the sensor hands out one record point
+  per read and the register pointer runs on past 0x53 into 0x54, so only the
+  first point of each chunk is a record point and the rest are other
+  registers. The table counts the points each read got right. The program
+  fails if correlationRecordRead() takes more than one address write and one
+  2 byte read per point or misreads a point, or if the bulk read returns
+  the record, in which case correlationRecordRead() should use it.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include "LIDARLite_v4LED.h"
+#include "LidarSim.h"
+
+#define POINTS 192
+
+static const uint32_t clocks[3] = {100000, 400000, 1000000};
+static int failures = 0;
+
+struct Cost
+{
+  uint32_t transactions;
+  uint32_t bytes;
+  uint64_t busTimeNs;
+  uint8_t correct; // Points equal to the record
+};
+
+// Measure once on a fresh sensor, then read the record one point or one Wire buffer at a time
+static Cost readRecord(uint32_t clock, bool bulk, const int16_t *expected, int16_t *record)
+{
+  SimLidar sim; // Same serial number every time, so the same record
+  LIDARLite_v4LED lidar;
+  Cost cost = {};
+
+  simReset();
+  sim.setDistance(300);
+  simAttach(sim);
+  Wire.setClock(clock);
+  lidar.begin();
+  lidar.getDistance();
+
+  simClearBusStats();
+  if (bulk)
+  {
+    for (uint16_t point = 0; point < POINTS; point += BUFFER_LENGTH / 2)
+      lidar.read(0x52, (uint8_t *)&record[point], BUFFER_LENGTH);
+  }
+  else
+    lidar.correlationRecordRead(record, POINTS);
+
+  SimBusStats stats = simGetBusStats();
+  cost.transactions = stats.transactions;
+  cost.bytes = stats.bytes;
+  cost.busTimeNs = stats.busTimeNs;
+  for (uint16_t i = 0; i < POINTS; i++)
+    cost.correct += (expected == nullptr || record[i] == expected[i]) ? 1 : 0;
+  return cost;
+}
+
+int main()
+{
+  int16_t expected[POINTS];
+  int16_t record[POINTS];
+
+  printf("%u points, %u byte Wire buffer\n\n", POINTS, BUFFER_LENGTH);
+  printf("| Clock | Read | Transactions | Bytes | Bus us | Points correct |\n");
+  printf("|--:|---|--:|--:|--:|--:|\n");
+
+  for (uint8_t c = 0; c < 3; c++)
+  {
+    Cost perPoint = readRecord(clocks[c], false, nullptr, expected);
+    Cost bulk = readRecord(clocks[c], true, expected, record);
+    perPoint.correct = readRecord(clocks[c], false, expected, record).correct;
+
+    printf("| %lu kHz | `correlationRecordRead()` | %lu | %lu | %lu | %u |\n", (unsigned long)clocks[c] / 1000,
+           (unsigned long)perPoint.transactions, (unsigned long)perPoint.bytes,
+           (unsigned long)(perPoint.busTimeNs / 1000), perPoint.correct);
+    printf("| %lu kHz | %u byte reads of 0x52 | %lu | %lu | %lu | %u |\n", (unsigned long)clocks[c] / 1000,
+           BUFFER_LENGTH, (unsigned long)bulk.transactions, (unsigned long)bulk.bytes,
+           (unsigned long)(bulk.busTimeNs / 1000), bulk.correct);
+
+    // An address write of 2 bytes and a read of the address and 2 data bytes per point
+    if (perPoint.transactions != 2 * POINTS || perPoint.bytes != 5 * POINTS || perPoint.correct != POINTS)
+    {
+      printf("MISMATCH %lu Hz: correlationRecordRead() %lu transactions, %lu bytes, %u points correct\n",
+             (unsigned long)clocks[c], (unsigned long)perPoint.transactions, (unsigned long)perPoint.bytes,
+             perPoint.correct);
+      failures++;
+    }
+    if (bulk.correct == POINTS)
+    {
+      printf("MISMATCH %lu Hz: the bulk read returns the record\n", (unsigned long)clocks[c]);
+      failures++;
+    }
+  }
+
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  bench_correlation_window.cpp
+
+  correlationRecordReadWindow() against reading the full record with
+  correlationRecordRead(), for targets across the record, the way Example 18
+  reads it: a 32 point window centered on the crossing the distance predicts.
+  Prints the bus time of both reads and the share the window saves, and
+  fails if the window does not hold the same points as the full record.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_Correlation.h"
+#include "LidarSim.h"
+
+#define WINDOW_POINTS 32
+
+// Measure once at distance on a fresh sensor, then time read on the bus
+static uint64_t timeRead(uint16_t distance, uint32_t clock, int16_t *points, uint8_t firstPoint, uint8_t count)
+{
+  SimLidar sim; // Same serial number every time, so the same noise
+  LIDARLite_v4LED lidar;
+
+  simReset();
+  sim.setDistance(distance);
+  simAttach(sim);
+  Wire.setClock(clock);
+  lidar.begin();
+  lidar.getDistance();
+
+  simClearBusStats();
+  if (firstPoint == 0 && count == 192)
+  {
+    if (!lidar.correlationRecordRead(points, 192))
+      return 0;
+  }
+  else if (!lidar.correlationRecordReadWindow(points, firstPoint, count))
+    return 0;
+  return simGetBusStats().busTimeNs;
+}
+
+int main()
+{
+  const uint16_t distances[] = {10, 100, 200, 400, 800, 1200};
+  const uint32_t clocks[] = {100000, 400000};
+  int failures = 0;
+
+  printf("| Distance cm | Window points | Bus clock | Full record us | Window us | Saved |\n");
+  printf("|------------:|--------------:|----------:|---------------:|----------:|------:|\n");
+
+  for (uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+  {
+    for (uint8_t d = 0; d < sizeof(distances) / sizeof(distances[0]); d++)
+    {
+      int16_t record[192];
+      int16_t window[WINDOW_POINTS];
+      uint8_t center = (uint8_t)SIM_CORR_POINT(distances[d]);
+      uint8_t firstPoint = (center > WINDOW_POINTS / 2) ? center - WINDOW_POINTS / 2 : 0;
+      if (firstPoint > 192 - WINDOW_POINTS)
+        firstPoint = 192 - WINDOW_POINTS;
+
+      uint64_t full = timeRead(distances[d], clocks[c], record, 0, 192);
+      uint64_t partial = timeRead(distances[d], clocks[c], window, firstPoint, WINDOW_POINTS);
+
+      if (full == 0 || partial == 0)
+      {
+        printf("FAILED read at %u cm\n", distances[d]);
+        failures++;
+        continue;
+      }
+      for (uint8_t i = 0; i < WINDOW_POINTS; i++)
+      {
+        if (window[i] != record[firstPoint + i])
+        {
+          printf("MISMATCH at %u cm, point %u\n", distances[d], firstPoint + i);
+          failures++;
+          break;
+        }
+      }
+
+      printf("| %u | %u-%u | %lu kHz | %lu | %lu | %lu%% |\n", distances[d], firstPoint,
+             firstPoint + WINDOW_POINTS - 1, (unsigned long)(clocks[c] / 1000), (unsigned long)(full / 1000),
+             (unsigned long)(partial / 1000), (unsigned long)(100 - partial * 100 / full));
+    }
+  }
+
+  return (failures == 0) ? 0 : 1;
+}
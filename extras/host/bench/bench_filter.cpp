@@ -0,0 +1,135 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  bench_filter.cpp
+
+  Nanoseconds per sample through each LIDARLite_v4LED_Filter.h stage on its
+  own and through the pipeline of all four, on a stream read from the
+  simulated sensor: a target drifting between 100 and 300 cm with 4 cm of
+  noise and a spike to 900 cm every 37th sample. Next to the cost, the RMS
+  error of each output against the true distance. The program fails if the
+  median, the outlier gate or the pipeline leaves more error than the raw
+  stream has, or if the smoothing stages do on a stream without spikes; the
+  rates are host CPU time, so they are printed, not checked.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_Filter.h"
+#include "LidarSim.h"
+
+#define NUM_SAMPLES 4096
+#define SPIKE_EVERY 37
+#define ITERATIONS 2000
+
+static uint16_t truth[NUM_SAMPLES];
+static uint16_t spiky[NUM_SAMPLES]; // Read from the simulator, with spikes
+static uint16_t clean[NUM_SAMPLES]; // Read from the simulator, without
+static int failures = 0;
+volatile uint32_t outputSum; // Keeps the timed calls from being optimized away
+
+static void readStream()
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  simReset();
+  sim.setMaxRange(4000);
+  sim.setNoise(4);
+  simAttach(sim);
+  lidar.begin();
+
+  for (uint16_t n = 0; n < NUM_SAMPLES; n++)
+  {
+    truth[n] = (uint16_t)(200 + 100 * sinf(2 * (float)M_PI * n / 2048) + 0.5f);
+    sim.setDistance(truth[n]);
+    clean[n] = lidar.getDistance();
+    if (n % SPIKE_EVERY == SPIKE_EVERY - 1)
+      sim.setDistance(900);
+    spiky[n] = lidar.getDistance();
+  }
+}
+
+static float rmsError(const uint16_t *output)
+{
+  double sum = 0;
+
+  for (uint16_t n = 0; n < NUM_SAMPLES; n++)
+  {
+    double error = (double)output[n] - truth[n];
+    sum += error * error;
+  }
+  return (float)sqrt(sum / NUM_SAMPLES);
+}
+
+// RMS error of filter on input, and the host time per sample over ITERATIONS passes
+template <class Filter>
+static void run(const uint16_t *input, float &error, double &nsPerSample)
+{
+  static uint16_t output[NUM_SAMPLES];
+  Filter filter;
+
+  for (uint16_t n = 0; n < NUM_SAMPLES; n++)
+    output[n] = filter.update(input[n]);
+  error = rmsError(output);
+
+  uint32_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t iteration = 0; iteration < ITERATIONS; iteration++)
+  {
+    filter.reset();
+    for (uint16_t n = 0; n < NUM_SAMPLES; n++)
+      sum += filter.update(input[n]);
+  }
+  auto end = std::chrono::steady_clock::now();
+  outputSum = sum;
+
+  nsPerSample = std::chrono::duration<double, std::nano>(end - start).count() / ((double)ITERATIONS * NUM_SAMPLES);
+}
+
+typedef LIDARLite_MedianFilter<5> Median;
+typedef LIDARLite_EMAFilter<2> EMA;
+typedef LIDARLite_OutlierGate<50, 3> Gate;
+typedef LIDARLite_KalmanCVFilter<64, 5> Kalman;
+typedef LIDARLite_FilterPipeline<Gate, Median, EMA, Kalman> Pipeline;
+
+// One table row. Fails the program if the stage is expected to improve on the raw stream and does not
+template <class Filter>
+static void row(const char *name, bool improvesSpiky, bool improvesClean)
+{
+  float spikyError, cleanError;
+  double spikyNs, cleanNs;
+
+  run<Filter>(spiky, spikyError, spikyNs);
+  run<Filter>(clean, cleanError, cleanNs);
+  printf("| %s | %.1f | %.2f | %.2f |\n", name, (spikyNs + cleanNs) / 2, spikyError, cleanError);
+
+  if ((improvesSpiky && spikyError >= rmsError(spiky)) || (improvesClean && cleanError >= rmsError(clean)))
+  {
+    printf("MISMATCH %s: RMS error %.2f with spikes, %.2f without\n", name, spikyError, cleanError);
+    failures++;
+  }
+}
+
+int main()
+{
+  readStream();
+
+  printf("%u samples, RMS error in cm against the true distance\n\n", NUM_SAMPLES);
+  printf("| Stage | ns/sample | Error, spikes | Error, no spikes |\n");
+  printf("|---|--:|--:|--:|\n");
+  printf("| Raw | - | %.2f | %.2f |\n", rmsError(spiky), rmsError(clean));
+
+  row<Gate>("OutlierGate<50, 3>", true, false);
+  row<Median>("MedianFilter<5>", true, true);
+  row<EMA>("EMAFilter<2>", false, true);
+  row<Kalman>("KalmanCVFilter<64, 5>", false, true);
+  row<Pipeline>("Pipeline of all four", true, true);
+
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  bench_fused.cpp
+
+  Bus cost per sample of the non-blocking measurement with separate reads
+  (getBusyFlag() then readDistance()) and with enableFusedReads(true), for
+  service() called back to back and every 500 us and 2 ms, at 100 kHz,
+  400 kHz and 1 MHz. Each cell is the average over SAMPLES measurements on
+  the simulated sensor. Each fused poll moves 17 bytes instead of 1, so the
+  fused reads win on transactions and lose on bytes and bus time. The program
+  fails if the fused reads do not save exactly the two transactions of the
+  distance read per sample, or if the two return different distances.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include "LIDARLite_v4LED.h"
+#include "LidarSim.h"
+
+#define SAMPLES 100
+
+static const uint32_t clocks[3] = {100000, 400000, 1000000};
+static const uint32_t pollIntervals[3] = {0, 500, 2000};
+static int failures = 0;
+
+struct Cost
+{
+  float polls;        // service() calls per sample
+  float transactions; // per sample
+  float bytes;        // per sample
+  float busTimeUs;    // per sample
+  uint32_t distanceSum;
+};
+
+static Cost measure(uint32_t clock, uint32_t pollInterval, bool fusedReads)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  Cost cost = {};
+  uint32_t polls = 0;
+
+  simReset();
+  sim.setDistance(250);
+  sim.setNoise(0);
+  simAttach(sim);
+  Wire.setClock(clock);
+  lidar.begin();
+  lidar.enableFusedReads(fusedReads);
+
+  simClearBusStats();
+  for (uint16_t n = 0; n < SAMPLES; n++)
+  {
+    lidar.startMeasurement();
+    do
+    {
+      delayMicroseconds(pollInterval);
+      polls++;
+    } while (lidar.service() == LIDARLITE_STATE_BUSY);
+    cost.distanceSum += lidar.fetch();
+  }
+
+  SimBusStats stats = simGetBusStats();
+  cost.polls = (float)polls / SAMPLES;
+  cost.transactions = (float)stats.transactions / SAMPLES;
+  cost.bytes = (float)stats.bytes / SAMPLES;
+  cost.busTimeUs = stats.busTimeNs / 1000.0f / SAMPLES;
+  return cost;
+}
+
+int main()
+{
+  printf("| Clock | Poll interval | Polls | Separate: transactions, bytes, bus us | Fused: transactions, bytes, bus us |\n");
+  printf("|--:|--:|--:|--:|--:|\n");
+
+  for (uint8_t c = 0; c < 3; c++)
+  {
+    for (uint8_t p = 0; p < 3; p++)
+    {
+      Cost separate = measure(clocks[c], pollIntervals[p], false);
+      Cost fused = measure(clocks[c], pollIntervals[p], true);
+
+      printf("| %lu kHz | %lu us | %.1f / %.1f | %.1f, %.1f, %.0f | %.1f, %.1f, %.0f |\n", (unsigned long)clocks[c] / 1000,
+             (unsigned long)pollIntervals[p], separate.polls, fused.polls, separate.transactions, separate.bytes,
+             separate.busTimeUs, fused.transactions, fused.bytes, fused.busTimeUs);
+
+      // The start write, 2 per poll, and 2 for the separate distance read
+      float expectedSeparate = 1 + 2 * separate.polls + 2;
+      float expectedFused = 1 + 2 * fused.polls;
+      if (separate.transactions != expectedSeparate || fused.transactions != expectedFused ||
+          separate.distanceSum != fused.distanceSum)
+      {
+        printf("MISMATCH %lu Hz, %lu us: %.1f/%.1f separate, %.1f/%.1f fused transactions\n", (unsigned long)clocks[c],
+               (unsigned long)pollIntervals[p], separate.transactions, expectedSeparate, fused.transactions, expectedFused);
+        failures++;
+      }
+    }
+  }
+
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  bench_power.cpp
+
+  The rate and latency trade-off of LIDARLite_v4LED_PowerScheduler: for
+  sample periods from 5 ms to 1 s and a tight and a loose latency budget,
+  the mode the scheduler settles in, the wake-up latency it measured, the
+  trigger-to-result latency and the coprocessor duty cycle it estimates,
+  next to the duty cycle the simulated sensor actually spent powered. Each
+  case runs for RUN_MS of simulated time with service() called every 100 us.
+  The program fails if the measured wake-up latency misses SIM_WAKE_US, if
+  the chosen mode does not follow the budget and the sample period, which a
+  woken acquisition no longer fits at 5 ms, if a trigger fails, or if the
+  duty cycle estimate is more than 3% of the time off the simulated one.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_Power.h"
+#include "LidarSim.h"
+
+#define RUN_MS 20000
+
+static const uint32_t samplePeriods[5] = {5000, 10000, 50000, 200000, 1000000};
+static int failures = 0;
+
+static void run(uint32_t samplePeriod, uint32_t latencyBudget)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_v4LED_PowerScheduler scheduler;
+  uint32_t samples = 0;
+
+  simReset();
+  sim.setDistance(250);
+  simAttach(sim);
+  lidar.begin();
+
+  uint64_t start = simNanos();
+  uint64_t awakeStart = sim.getAwakeTime();
+  scheduler.begin(lidar, samplePeriod, latencyBudget);
+  while (simNanos() - start < (uint64_t)RUN_MS * 1000000)
+  {
+    samples += scheduler.service();
+    delayMicroseconds(100);
+  }
+
+  uint32_t simDutyCycle = (sim.getAwakeTime() - awakeStart) * 1000 / (simNanos() - start);
+  uint32_t dutyCycle = scheduler.getDutyCycle();
+  uint32_t wakeLatency = scheduler.getWakeLatency();
+
+  printf("| %lu ms | %lu us | %s | %lu | %lu | %.1f | %.1f%% | %.1f%% |\n", (unsigned long)samplePeriod / 1000,
+         (unsigned long)latencyBudget, scheduler.isAsync() ? "async" : "always-on", (unsigned long)wakeLatency,
+         (unsigned long)scheduler.getLatency(), samples * 1000.0f / RUN_MS, dutyCycle / 10.0f, simDutyCycle / 10.0f);
+
+  // Asynchronous mode is tried at least once in every case
+  uint32_t asyncLatency = (scheduler.getLatency() - (scheduler.isAsync() ? wakeLatency : 0)) + SIM_WAKE_US;
+  bool asyncFits = asyncLatency <= latencyBudget && asyncLatency <= samplePeriod;
+  int32_t dutyError = (int32_t)dutyCycle - (int32_t)simDutyCycle;
+  if (wakeLatency < SIM_WAKE_US * 9 / 10 || wakeLatency > SIM_WAKE_US * 11 / 10 || scheduler.isAsync() != asyncFits ||
+      scheduler.getFailedTriggerCount() != 0 || dutyError < -30 || dutyError > 30)
+  {
+    printf("MISMATCH %lu us period, %lu us budget\n", (unsigned long)samplePeriod, (unsigned long)latencyBudget);
+    failures++;
+  }
+}
+
+int main()
+{
+  SimLidar probe;
+
+  printf("Acquisition %lu us always-on, %lu us more to wake in asynchronous mode\n\n",
+         (unsigned long)probe.acquisitionTimeUs(), (unsigned long)SIM_WAKE_US);
+  printf("| Period | Budget | Mode | Wake latency, us | Latency, us | Rate, Hz | Duty cycle | Simulated duty cycle |\n");
+  printf("|--:|--:|---|--:|--:|--:|--:|--:|\n");
+
+  for (uint8_t i = 0; i < 5; i++)
+  {
+    run(samplePeriods[i], probe.acquisitionTimeUs() + SIM_WAKE_US / 2);
+    run(samplePeriods[i], probe.acquisitionTimeUs() + SIM_WAKE_US * 2);
+  }
+
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  bench_profiles.cpp
+
+  Acquisition time of every built-in profile, plus one that sets
+  DETECTION_SENSITIVITY, measured on the simulated sensor for targets at 50,
+  250 and 600 cm: the duration the non-blocking state machine stamps on each
+  sample, averaged over SAMPLES samples, with the distance read (0 beyond the
+  profile's range). Next to it, the writes applyProfile() needed with the
+  shadow cache on, switching from the profile on the row above. The program
+  fails if a profile's minAcquisitionUs is longer than an acquisition it
+  runs, if a measured duration is further past the simulated acquisition
+  than the trigger write and one poll, or if applyProfile() writes a
+  register the cache knows already holds its value.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include "LIDARLite_v4LED.h"
+#include "LidarSim.h"
+
+#define SAMPLES 10
+#define POLL_US 20
+#define SLACK_US 200 // The trigger write, one STATUS read at 400 kHz and POLL_US
+
+// Long range on weak targets: fewer acquisitions, a lower detection threshold
+constexpr LIDARLite_Profile PROFILE_SENSITIVE = {0x40, 0x00, true, 0x20, 200};
+
+struct NamedProfile
+{
+  const char *name;
+  LIDARLite_Profile profile;
+};
+
+static const NamedProfile profiles[] = {
+    {"MAX_RANGE", LIDARLITE_PROFILE_MAX_RANGE},
+    {"BALANCED", LIDARLITE_PROFILE_BALANCED},
+    {"SHORT_RANGE", LIDARLITE_PROFILE_SHORT_RANGE},
+    {"MID_RANGE_QT", LIDARLITE_PROFILE_MID_RANGE_QT},
+    {"MAX_RANGE_QT", LIDARLITE_PROFILE_MAX_RANGE_QT},
+    {"VERY_SHORT_RANGE", LIDARLITE_PROFILE_VERY_SHORT_RANGE},
+    {"Sensitive, user defined", PROFILE_SENSITIVE},
+};
+#define NUM_PROFILES (sizeof(profiles) / sizeof(profiles[0]))
+
+static const uint16_t distances[3] = {50, 250, 600};
+static int failures = 0;
+
+// What the shadow cache knows of the device: nothing until a register is written
+struct Shadow
+{
+  LIDARLite_Profile values;
+  bool countKnown;
+  bool quickTerminationKnown;
+  bool sensitivityKnown;
+};
+
+// Writes applyProfile() cannot skip, then remember next as written
+static uint32_t neededWrites(Shadow &shadow, const LIDARLite_Profile &next)
+{
+  uint32_t writes = 0;
+
+  if (!shadow.countKnown || next.acquisitionCount != shadow.values.acquisitionCount)
+    writes++;
+  if (!shadow.quickTerminationKnown || next.quickTermination != shadow.values.quickTermination)
+    writes++;
+  if (next.setSensitivity && (!shadow.sensitivityKnown || next.detectionSensitivity != shadow.values.detectionSensitivity))
+    writes++;
+
+  shadow.values.acquisitionCount = next.acquisitionCount;
+  shadow.values.quickTermination = next.quickTermination;
+  shadow.countKnown = true;
+  shadow.quickTerminationKnown = true;
+  if (next.setSensitivity)
+  {
+    shadow.values.detectionSensitivity = next.detectionSensitivity;
+    shadow.sensitivityKnown = true;
+  }
+  return writes;
+}
+
+int main()
+{
+  SimLidar sims[3];
+  LIDARLite_v4LED lidars[3];
+  Shadow shadow = {};
+
+  // One sensor per target distance, each on its own address, walked through the profiles in order
+  simReset();
+  Wire.setClock(400000);
+  for (uint8_t d = 0; d < 3; d++)
+  {
+    sims[d].setDistance(distances[d]);
+    sims[d].setNoise(0);
+    simAttach(sims[d]);
+    sims[d].setPresent(false);
+  }
+  for (uint8_t d = 0; d < 3; d++)
+  {
+    sims[d].setPresent(true);
+    lidars[d].begin();
+    lidars[d].setI2Caddr(0x30 + d, true);
+    lidars[d].begin(0x30 + d);
+    lidars[d].enableShadowCache(true);
+  }
+
+  printf("Duration in us (distance in cm), averaged over %u samples polled every %u us at 400 kHz\n\n", SAMPLES,
+         POLL_US);
+  printf("| Profile | Writes to apply | minAcquisitionUs | 50 cm | 250 cm | 600 cm |\n");
+  printf("|---|--:|--:|--:|--:|--:|\n");
+
+  for (uint8_t p = 0; p < NUM_PROFILES; p++)
+  {
+    const LIDARLite_Profile &profile = profiles[p].profile;
+    uint32_t expected = neededWrites(shadow, profile);
+    uint32_t writes = 0;
+    char cells[3][32];
+
+    for (uint8_t d = 0; d < 3; d++)
+    {
+      LIDARLite_v4LED &lidar = lidars[d];
+
+      simClearBusStats();
+      lidar.applyProfile(profile);
+      writes = simGetBusStats().transactions;
+      if (writes != expected)
+      {
+        printf("MISMATCH %s: %lu writes, %lu needed\n", profiles[p].name, (unsigned long)writes,
+               (unsigned long)expected);
+        failures++;
+      }
+
+      uint32_t acquisition = sims[d].acquisitionTimeUs();
+      uint32_t durationSum = 0;
+      uint16_t distance = 0;
+      for (uint8_t n = 0; n < SAMPLES; n++)
+      {
+        LIDARLite_Sample sample;
+
+        lidar.startMeasurement();
+        while (lidar.service() == LIDARLITE_STATE_BUSY)
+          delayMicroseconds(POLL_US);
+        distance = lidar.fetch(sample);
+        durationSum += sample.duration;
+      }
+      uint32_t duration = durationSum / SAMPLES;
+      snprintf(cells[d], sizeof(cells[d]), "%lu (%u)", (unsigned long)duration, distance);
+
+      if (profile.minAcquisitionUs > acquisition || duration < acquisition || duration > acquisition + SLACK_US)
+      {
+        printf("MISMATCH %s at %u cm: duration %lu, simulated %lu, minAcquisitionUs %u\n", profiles[p].name,
+               distances[d], (unsigned long)duration, (unsigned long)acquisition, profile.minAcquisitionUs);
+        failures++;
+      }
+    }
+    printf("| %s | %lu | %u | %s | %s | %s |\n", profiles[p].name, (unsigned long)writes, profile.minAcquisitionUs,
+           cells[0], cells[1], cells[2]);
+  }
+
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  bench_scheduler.cpp
+
+  Aggregate sample rate of 1 to LIDARLITE_SCHEDULER_MAX_SENSORS simulated
+  sensors on one bus, read one after another with getDistance() as Example 3
+  does, and run together by LIDARLite_v4LED_Scheduler. Each pattern runs for
+  one second of simulated time at 400 kHz. The program fails if the
+  scheduler's speedup over the sequential loop stays below 80% of the sensor
+  count, or if getSensorHz() and getTotalHz() disagree with the samples
+  counted.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_Scheduler.h"
+#include "LidarSim.h"
+
+#define RUN_MS 1000
+#define SERIALS {0xB0000000, 0xB0000001, 0xB0000002, 0xB0000003, \
+                 0xB0000004, 0xB0000005, 0xB0000006, 0xB0000007}
+
+static int failures = 0;
+
+struct Rig
+{
+  SimLidar sims[LIDARLITE_SCHEDULER_MAX_SENSORS] = SERIALS;
+  LIDARLite_v4LED lidars[LIDARLITE_SCHEDULER_MAX_SENSORS];
+
+  // numSensors sensors on the default address, moved to 0x30 + i
+  explicit Rig(uint8_t numSensors)
+  {
+    LIDARLite_AddressAssignment table[LIDARLITE_SCHEDULER_MAX_SENSORS];
+    LIDARLite_v4LED shared;
+
+    simReset();
+    Wire.setClock(400000);
+    for (uint8_t i = 0; i < numSensors; i++)
+    {
+      sims[i].setDistance(100 + 20 * i);
+      simAttach(sims[i]);
+      for (uint8_t j = 0; j < 4; j++)
+        table[i].unitId[j] = sims[i].getRegister(0x16 + j);
+      table[i].address = 0x30 + i;
+    }
+    shared.begin();
+    if (shared.provisionAddresses(table, numSensors) != numSensors)
+    {
+      printf("MISMATCH %u sensors: provisioning failed\n", numSensors);
+      failures++;
+    }
+    for (uint8_t i = 0; i < numSensors; i++)
+      lidars[i].begin(0x30 + i);
+  }
+};
+
+// getDistance() on each sensor in turn
+static float sequentialHz(uint8_t numSensors)
+{
+  Rig rig(numSensors);
+  uint32_t samples = 0;
+  uint64_t end = simNanos() + (uint64_t)RUN_MS * 1000000;
+
+  while (simNanos() < end)
+    for (uint8_t i = 0; i < numSensors; i++)
+    {
+      rig.lidars[i].getDistance();
+      samples++;
+    }
+  return samples * 1000.0f / RUN_MS;
+}
+
+// The scheduler serviced every 50 us
+static float scheduledHz(uint8_t numSensors, float &slowestSensorHz)
+{
+  Rig rig(numSensors);
+  LIDARLite_v4LED_Scheduler scheduler;
+  uint32_t samples = 0;
+
+  for (uint8_t i = 0; i < numSensors; i++)
+    scheduler.addSensor(rig.lidars[i]);
+
+  uint64_t end = simNanos() + (uint64_t)RUN_MS * 1000000;
+  scheduler.start();
+  while (simNanos() < end)
+  {
+    samples += scheduler.service();
+    delayMicroseconds(50);
+  }
+
+  float sumHz = 0;
+  slowestSensorHz = scheduler.getSensorHz(0);
+  for (uint8_t i = 0; i < numSensors; i++)
+  {
+    sumHz += scheduler.getSensorHz(i);
+    if (scheduler.getSensorHz(i) < slowestSensorHz)
+      slowestSensorHz = scheduler.getSensorHz(i);
+  }
+
+  float totalHz = scheduler.getTotalHz();
+  float countedHz = samples * 1000.0f / RUN_MS;
+  if (totalHz < countedHz * 0.99f || totalHz > countedHz * 1.01f || sumHz < totalHz * 0.99f || sumHz > totalHz * 1.01f)
+  {
+    printf("MISMATCH %u sensors: getTotalHz() %.1f, sum of getSensorHz() %.1f, counted %.1f\n", numSensors, totalHz,
+           sumHz, countedHz);
+    failures++;
+  }
+  return totalHz;
+}
+
+int main()
+{
+  SimLidar probe;
+  printf("Acquisition %lu us at the default settings, 400 kHz bus\n\n", (unsigned long)probe.acquisitionTimeUs());
+  printf("| Sensors | Sequential, Hz | Scheduler, Hz | Slowest sensor, Hz | Speedup |\n");
+  printf("|--:|--:|--:|--:|--:|\n");
+
+  for (uint8_t numSensors = 1; numSensors <= LIDARLITE_SCHEDULER_MAX_SENSORS; numSensors *= 2)
+  {
+    float slowest;
+    float sequential = sequentialHz(numSensors);
+    float scheduled = scheduledHz(numSensors, slowest);
+    float speedup = scheduled / sequential;
+
+    printf("| %u | %.0f | %.0f | %.0f | %.2fx |\n", numSensors, sequential, scheduled, slowest, speedup);
+
+    // Even 8 sensors keep the bus idle for most of an acquisition at 400 kHz
+    if (speedup < 0.8f * numSensors)
+    {
+      printf("MISMATCH %u sensors: speedup %.2f\n", numSensors, speedup);
+      failures++;
+    }
+  }
+
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  bench_zero_crossing.cpp
+
+  Records per second through LIDARLite_findZeroCrossing(), for full 192 point
+  records and 32 point windows, against the single-pass compare-and-remember
+  scan it replaced, which is kept below as the reference. Records come from
+  the simulated sensor at distances across its range plus synthetic ones
+  with ties, flat stretches and extreme values. The program fails if the two
+  disagree on any field of any record; the rates are host CPU time, so they
+  are printed, not checked. Build with -O3 -march=native to see the
+  vectorized scans at full width.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_Correlation.h"
+#include "LidarSim.h"
+
+#define NUM_RECORDS 64
+#define ITERATIONS 20000
+
+static int16_t records[NUM_RECORDS][192];
+volatile uint32_t crossingSum; // Keeps the timed calls from being optimized away
+
+// The original scan: one loop per lobe remembering the index of the best point
+static bool referenceZeroCrossing(const int16_t *correlationArray, uint8_t numberOfReadings,
+                                  LIDARLite_ZeroCrossing &result)
+{
+  uint8_t i;
+  uint8_t peakIndex = 0;
+  uint8_t troughIndex;
+  int16_t peak;
+  int16_t trough;
+
+  result.found = false;
+  result.crossing = 0;
+  result.peak = 0;
+  result.trough = 0;
+  result.confidence = 0;
+
+  if (numberOfReadings < 2)
+    return false;
+
+  peak = correlationArray[0];
+  for (i = 1; i < numberOfReadings; i++)
+  {
+    if (correlationArray[i] > peak)
+    {
+      peak = correlationArray[i];
+      peakIndex = i;
+    }
+  }
+
+  troughIndex = peakIndex;
+  trough = peak;
+  for (i = peakIndex + 1; i < numberOfReadings; i++)
+  {
+    if (correlationArray[i] < trough)
+    {
+      trough = correlationArray[i];
+      troughIndex = i;
+    }
+  }
+
+  if (peak <= 0 || trough >= 0)
+    return false;
+
+  for (i = peakIndex; i < troughIndex; i++)
+  {
+    if (correlationArray[i] > 0 && correlationArray[i + 1] <= 0)
+      break;
+  }
+
+  int32_t above = correlationArray[i];
+  int32_t below = correlationArray[i + 1];
+  uint16_t fraction = (uint16_t)((above << 8) / (above - below));
+
+  result.crossing = ((uint16_t)i << 8) + fraction;
+  result.peak = peak;
+  result.trough = trough;
+  result.found = true;
+
+  uint8_t width = troughIndex - peakIndex;
+  uint16_t noiseFloor = 0;
+  for (i = 0; i < numberOfReadings; i++)
+  {
+    if ((uint16_t)i + width >= peakIndex && i <= (uint16_t)troughIndex + width)
+      continue;
+
+    int16_t value = correlationArray[i];
+    uint16_t magnitude = (value < 0) ? -(int32_t)value : value;
+    if (magnitude > noiseFloor)
+      noiseFloor = magnitude;
+  }
+
+  uint32_t amplitude = (int32_t)peak - trough;
+  uint32_t confidence = (amplitude << 4) / (2 * (uint32_t)noiseFloor + 1);
+  result.confidence = (confidence > 255) ? 255 : confidence;
+
+  return true;
+}
+
+static void makeRecords()
+{
+  uint8_t n = 0;
+
+  // Simulated sensor, 0.1 m to 12 m
+  for (; n < 40; n++)
+  {
+    SimLidar sim(0x1000 + n);
+    LIDARLite_v4LED lidar;
+
+    simReset();
+    sim.setDistance(10 + 30 * n);
+    simAttach(sim);
+    lidar.begin();
+    lidar.getDistance();
+    lidar.correlationRecordRead(records[n], 192);
+  }
+
+  // Synthetic: noise, ties, flat stretches, full scale values
+  srand(1);
+  for (; n < NUM_RECORDS; n++)
+  {
+    int16_t scale = (n % 3 == 0) ? 32767 : 2000;
+    for (uint8_t i = 0; i < 192; i++)
+      records[n][i] = (int16_t)((rand() % (2 * scale + 1)) - scale);
+    if (n % 4 == 0)
+      for (uint8_t i = 50; i < 70; i++)
+        records[n][i] = records[n][50];
+    if (n % 5 == 0)
+    {
+      records[n][20] = 32767;
+      records[n][120] = 32767;
+      records[n][150] = -32768;
+      records[n][170] = -32768;
+    }
+    if (n % 7 == 0)
+      for (uint8_t i = 0; i < 192; i++)
+        records[n][i] = (int16_t)(i & 1);
+  }
+}
+
+static int compare()
+{
+  int mismatches = 0;
+
+  for (uint8_t n = 0; n < NUM_RECORDS; n++)
+  {
+    for (uint16_t length = 2; length <= 192; length += 5)
+    {
+      LIDARLite_ZeroCrossing expected;
+      LIDARLite_ZeroCrossing actual;
+      bool expectedFound = referenceZeroCrossing(records[n], length, expected);
+      bool actualFound = LIDARLite_findZeroCrossing(records[n], length, actual);
+
+      if (expectedFound != actualFound || expected.found != actual.found ||
+          expected.crossing != actual.crossing || expected.peak != actual.peak ||
+          expected.trough != actual.trough || expected.confidence != actual.confidence)
+      {
+        printf("MISMATCH record %u length %u: crossing %u/%u confidence %u/%u\n", n, length,
+               expected.crossing, actual.crossing, expected.confidence, actual.confidence);
+        mismatches++;
+      }
+    }
+  }
+  return mismatches;
+}
+
+typedef bool (*Finder)(const int16_t *, uint8_t, LIDARLite_ZeroCrossing &);
+
+// Records per second over ITERATIONS passes of every record, numberOfReadings points each
+static double recordsPerSecond(Finder finder, uint8_t firstPoint, uint8_t numberOfReadings)
+{
+  uint32_t sum = 0;
+  LIDARLite_ZeroCrossing result;
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t iteration = 0; iteration < ITERATIONS; iteration++)
+    for (uint8_t n = 0; n < NUM_RECORDS; n++)
+    {
+      finder(records[n] + firstPoint, numberOfReadings, result);
+      sum += result.crossing;
+    }
+  auto end = std::chrono::steady_clock::now();
+  crossingSum = sum;
+
+  double seconds = std::chrono::duration<double>(end - start).count();
+  return (double)ITERATIONS * NUM_RECORDS / seconds;
+}
+
+int main()
+{
+  makeRecords();
+  int mismatches = compare();
+
+  printf("| Record | Reference scan, records/s | Reductions, records/s | Speedup |\n");
+  printf("|---|--:|--:|--:|\n");
+
+  static const uint8_t lengths[2] = {192, 32};
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    uint8_t firstPoint = (lengths[i] == 192) ? 0 : 40;
+    double reference = recordsPerSecond(referenceZeroCrossing, firstPoint, lengths[i]);
+    double reductions = recordsPerSecond(LIDARLite_findZeroCrossing, firstPoint, lengths[i]);
+    printf("| %u points | %.0f | %.0f | %.2fx |\n", lengths[i], reference, reductions, reductions / reference);
+  }
+
+  return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  FakeI2CDev.cpp
+
+------------------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <string.h>
+#include "FakeI2CDev.h"
+
+#define ACQ_COMMANDS 0x00
+#define STATUS 0x01
+#define FULL_DELAY_LOW 0x10
+#define FULL_DELAY_HIGH 0x11
+
+static FakeI2CDevice devices[FAKE_I2C_MAX_DEVICES];
+static uint8_t numDevices = 0;
+static FakeI2CStats stats;
+static bool noZeroLength = false;
+
+void fakeI2CReset()
+{
+    numDevices = 0;
+    noZeroLength = false;
+    fakeI2CClearStats();
+}
+
+FakeI2CDevice *fakeI2CAdd(uint8_t address)
+{
+    if (numDevices == FAKE_I2C_MAX_DEVICES)
+        return NULL;
+
+    FakeI2CDevice *device = &devices[numDevices++];
+    memset(device, 0, sizeof(*device));
+    device->address = address;
+    device->present = true;
+    return device;
+}
+
+FakeI2CStats fakeI2CStats()
+{
+    return stats;
+}
+
+void fakeI2CClearStats()
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+void fakeI2CSetNoZeroLength(bool refuse)
+{
+    noZeroLength = refuse;
+}
+
+static FakeI2CDevice *findDevice(uint16_t address)
+{
+    for (uint8_t i = 0; i < numDevices; i++)
+        if (devices[i].present && devices[i].address == address)
+            return &devices[i];
+    return NULL;
+}
+
+static void writeByte(FakeI2CDevice *device, uint8_t value)
+{
+    device->registers[device->pointer] = value;
+    if (device->pointer == ACQ_COMMANDS && value == 0x04)
+    {
+        device->registers[FULL_DELAY_LOW] = device->distance & 0xFF;
+        device->registers[FULL_DELAY_HIGH] = device->distance >> 8;
+        device->busyLeft = device->busyReads;
+        device->triggers++;
+    }
+    device->pointer++;
+}
+
+static uint8_t readByte(FakeI2CDevice *device)
+{
+    uint8_t value = device->registers[device->pointer];
+    if (device->pointer == STATUS)
+    {
+        value = (device->busyLeft > 0) ? 0x01 : 0x00;
+        if (device->busyLeft > 0)
+            device->busyLeft--;
+    }
+    device->pointer++;
+    return value;
+}
+
+int fakeI2CTransfer(int fd, struct i2c_rdwr_ioctl_data *transfer)
+{
+    stats.transfers++;
+    stats.messages += transfer->nmsgs;
+
+    if (fd != FAKE_I2C_FD || transfer->nmsgs == 0 || transfer->nmsgs > I2C_RDWR_IOCTL_MAX_MSGS)
+    {
+        stats.failures++;
+        errno = EINVAL;
+        return -1;
+    }
+
+    // The kernel checks the adapter's quirks against every message first
+    for (uint32_t i = 0; i < transfer->nmsgs && noZeroLength; i++)
+    {
+        if (transfer->msgs[i].len == 0)
+        {
+            stats.failures++;
+            errno = EOPNOTSUPP;
+            return -1;
+        }
+    }
+
+    for (uint32_t i = 0; i < transfer->nmsgs; i++)
+    {
+        struct i2c_msg *message = &transfer->msgs[i];
+        FakeI2CDevice *device = findDevice(message->addr);
+
+        if (device == NULL)
+        {
+            stats.failures++;
+            errno = ENXIO;
+            return -1;
+        }
+
+        if (message->flags & I2C_M_RD)
+        {
+            for (uint16_t j = 0; j < message->len; j++)
+                message->buf[j] = readByte(device);
+        }
+        else if (message->len > 0)
+        {
+            // First byte of a write sets the register pointer
+            device->pointer = message->buf[0];
+            for (uint16_t j = 1; j < message->len; j++)
+                writeByte(device, message->buf[j]);
+        }
+    }
+
+    return (int)transfer->nmsgs;
+}
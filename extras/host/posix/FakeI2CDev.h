@@ -0,0 +1,63 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  FakeI2CDev.h
+
+  In-process stand-in for a /dev/i2c-N adapter, for the build without an
+  Arduino core. fakeI2CTransfer() goes in place of the I2C_RDWR ioctl through
+  LIDARLite_LinuxI2CBus::setTransferFunction(), and the bus is attached to
+  FAKE_I2C_FD, so no device file is opened and the library under test runs
+  unchanged down to the ioctl.
+
+    fakeI2CReset();
+    FakeI2CDevice *sensor = fakeI2CAdd(0x62);
+    bus.attach(FAKE_I2C_FD);
+    bus.setTransferFunction(fakeI2CTransfer);
+
+  Each device is a 256 byte register file with an auto-incrementing
+  register pointer. Writing 0x04 to ACQ_COMMANDS latches distance into
+  FULL_DELAY and keeps STATUS bit 0 set for the next busyReads reads of
+  STATUS. Like the kernel, a transfer stops at the first message whose
+  address nobody acknowledges and fails with ENXIO. fakeI2CSetNoZeroLength()
+  makes the adapter refuse zero length messages with EOPNOTSUPP, as adapters
+  with the I2C_AQ_NO_ZERO_LEN quirk do, before any message goes out.
+
+------------------------------------------------------------------------------*/
+#ifndef FakeI2CDev_h
+#define FakeI2CDev_h
+
+#include <stdint.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#define FAKE_I2C_FD 1000       //File descriptor the fake answers on
+#define FAKE_I2C_MAX_DEVICES 8
+
+struct FakeI2CDevice
+{
+  uint8_t address;
+  bool present;
+  uint8_t registers[256];
+  uint8_t pointer;      //Register the next data byte is read from or written to
+  uint16_t distance;    //Latched into FULL_DELAY by the next trigger
+  uint16_t busyReads;   //STATUS reads that report busy after each trigger
+  uint16_t busyLeft;    //Busy STATUS reads left in the current measurement
+  uint32_t triggers;    //Measurements started
+};
+
+struct FakeI2CStats
+{
+  uint32_t transfers; //ioctl calls
+  uint32_t messages;  //i2c_msg entries in them
+  uint32_t failures;  //Calls that returned an error
+};
+
+void fakeI2CReset();
+FakeI2CDevice *fakeI2CAdd(uint8_t address); //A present, idle device with busyReads 0
+FakeI2CStats fakeI2CStats();
+void fakeI2CClearStats();
+void fakeI2CSetNoZeroLength(bool refuse); //Cleared by fakeI2CReset()
+
+int fakeI2CTransfer(int fd, struct i2c_rdwr_ioctl_data *transfer);
+
+#endif
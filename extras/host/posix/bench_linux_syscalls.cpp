@@ -0,0 +1,153 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  bench_linux_syscalls.cpp
+
+  System calls per sample over LIDARLite_LinuxI2CTransport, counted at the
+  fake adapter in FakeI2CDev.h, for the ways of taking a sample: blocking
+  getDistance(), startMeasurement() and service() with and without fused
+  reads, and the distance reads of a group of sensors one by one or with
+  readBatch(). Each sample is a context switch into the kernel per ioctl on
+  a real bus, so this count, not the bytes, bounds the rate on Linux. The
+  program fails if a count does not match the formula in the table.
+
+------------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_LinuxI2C.h"
+#include "FakeI2CDev.h"
+
+#define SAMPLES 200
+#define GROUP_SIZE 4
+
+static int failures = 0;
+
+static void check(const char *name, uint32_t polls, uint32_t measured, uint32_t expected)
+{
+  if (measured != expected)
+  {
+    printf("MISMATCH %s, %lu polls: %lu ioctls per sample, expected %lu\n", name, (unsigned long)polls,
+           (unsigned long)measured, (unsigned long)expected);
+    failures++;
+  }
+}
+
+struct Rig
+{
+  LIDARLite_LinuxI2CBus bus;
+  LIDARLite_v4LED lidar;
+  FakeI2CDevice *sensor;
+
+  // One sensor whose STATUS reads busy busyReads times after each trigger
+  explicit Rig(uint16_t busyReads)
+  {
+    fakeI2CReset();
+    bus.attach(FAKE_I2C_FD);
+    bus.setTransferFunction(fakeI2CTransfer);
+    sensor = fakeI2CAdd(LIDARLITE_ADDR_DEFAULT);
+    sensor->distance = 250;
+    sensor->busyReads = busyReads;
+    lidar.begin(LIDARLITE_ADDR_DEFAULT, bus);
+    lidar.configure(5);
+    bus.clearTransferCount();
+  }
+
+  uint32_t perSample() { return bus.getTransferCount() / SAMPLES; }
+};
+
+static uint32_t blocking(uint16_t busyReads)
+{
+  Rig rig(busyReads);
+  for (uint16_t i = 0; i < SAMPLES; i++)
+    rig.lidar.getDistance();
+  return rig.perSample();
+}
+
+static uint32_t nonBlocking(uint16_t busyReads, bool fused)
+{
+  Rig rig(busyReads);
+  rig.lidar.enableFusedReads(fused);
+  for (uint16_t i = 0; i < SAMPLES; i++)
+  {
+    rig.lidar.startMeasurement();
+    while (rig.lidar.service() == LIDARLITE_STATE_BUSY)
+      ;
+    rig.lidar.fetch();
+  }
+  return rig.perSample();
+}
+
+// Distance reads only, for GROUP_SIZE sensors that finished together
+static uint32_t groupRead(bool batch)
+{
+  LIDARLite_LinuxI2CBus bus;
+  LIDARLite_v4LED lidars[GROUP_SIZE];
+  uint8_t addresses[GROUP_SIZE];
+  uint8_t data[2 * GROUP_SIZE];
+
+  fakeI2CReset();
+  bus.attach(FAKE_I2C_FD);
+  bus.setTransferFunction(fakeI2CTransfer);
+  for (uint8_t i = 0; i < GROUP_SIZE; i++)
+  {
+    addresses[i] = LIDARLITE_ADDR_DEFAULT + i;
+    fakeI2CAdd(addresses[i])->distance = 100 + i;
+    lidars[i].begin(addresses[i], bus);
+  }
+
+  bus.clearTransferCount();
+  for (uint16_t i = 0; i < SAMPLES; i++)
+  {
+    if (batch)
+      bus.readBatch(addresses, GROUP_SIZE, 0x10, data, 2);
+    else
+      for (uint8_t j = 0; j < GROUP_SIZE; j++)
+        lidars[j].readDistance();
+  }
+  return bus.getTransferCount() / SAMPLES;
+}
+
+int main()
+{
+  printf("| Sample, P busy polls | P = 1 | P = 2 | P = 4 | Formula |\n");
+  printf("|---|---|---|---|---|\n");
+
+  uint32_t row[3];
+  static const uint16_t polls[3] = {1, 2, 4};
+
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    row[i] = blocking(polls[i] - 1);
+    check("getDistance()", polls[i], row[i], 2 + polls[i]);
+  }
+  printf("| `getDistance()` | %lu | %lu | %lu | 2 + P |\n", (unsigned long)row[0], (unsigned long)row[1],
+         (unsigned long)row[2]);
+
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    row[i] = nonBlocking(polls[i] - 1, false);
+    check("service()", polls[i], row[i], 2 + polls[i]);
+  }
+  printf("| `startMeasurement()`, `service()` | %lu | %lu | %lu | 2 + P |\n", (unsigned long)row[0],
+         (unsigned long)row[1], (unsigned long)row[2]);
+
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    row[i] = nonBlocking(polls[i] - 1, true);
+    check("fused service()", polls[i], row[i], 1 + polls[i]);
+  }
+  printf("| `startMeasurement()`, fused `service()` | %lu | %lu | %lu | 1 + P |\n", (unsigned long)row[0],
+         (unsigned long)row[1], (unsigned long)row[2]);
+
+  uint32_t separate = groupRead(false);
+  uint32_t batched = groupRead(true);
+  check("readDistance() per sensor", 0, separate, GROUP_SIZE);
+  check("readBatch()", 0, batched, 1);
+  printf("\n| Distances of %d sensors | ioctls |\n", GROUP_SIZE);
+  printf("|---|---|\n");
+  printf("| `readDistance()` each | %lu |\n", (unsigned long)separate);
+  printf("| `readBatch()` | %lu |\n", (unsigned long)batched);
+
+  return (failures == 0) ? 0 : 1;
+}
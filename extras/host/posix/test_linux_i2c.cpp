@@ -0,0 +1,209 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_linux_i2c.cpp
+
+  The library built without an Arduino core, over LIDARLite_LinuxI2CTransport,
+  against the in-process fake adapter in FakeI2CDev.h: one ioctl per
+  transaction, untouched buffers on failure, batch reads, the probe on
+  adapters that refuse zero length messages, and the real ioctl path failing
+  cleanly on a descriptor that is not an I2C adapter.
+
+------------------------------------------------------------------------------*/
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <type_traits>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_LinuxI2C.h"
+#include "FakeI2CDev.h"
+#include "HostTest.h"
+
+static_assert(LIDARLITE_ARDUINO == 0, "built against an Arduino.h");
+static_assert(!std::is_copy_constructible<LIDARLite_LinuxI2CBus>::value, "a copy would close the descriptor twice");
+static_assert(!std::is_copy_assignable<LIDARLite_LinuxI2CBus>::value, "a copy would close the descriptor twice");
+
+static void attachFake(LIDARLite_LinuxI2CBus &bus)
+{
+  fakeI2CReset();
+  bus.attach(FAKE_I2C_FD);
+  bus.setTransferFunction(fakeI2CTransfer);
+}
+
+TEST(begin_pingsWithOneIoctl)
+{
+  LIDARLite_LinuxI2CBus bus;
+  LIDARLite_v4LED lidar;
+
+  attachFake(bus);
+  fakeI2CAdd(LIDARLITE_ADDR_DEFAULT);
+
+  CHECK(lidar.begin(LIDARLITE_ADDR_DEFAULT, bus));
+  CHECK_EQUAL(1, bus.getTransferCount());
+  CHECK_EQUAL(1, fakeI2CStats().messages);
+  CHECK(!lidar.begin(0x10, bus));
+  CHECK_EQUAL(LIDARLITE_LINUX_NACK, lidar.getLastError());
+}
+
+TEST(begin_probesWithReadWhenZeroLengthIsRefused)
+{
+  LIDARLite_LinuxI2CBus bus;
+  LIDARLite_v4LED lidar;
+
+  attachFake(bus);
+  fakeI2CSetNoZeroLength(true);
+  fakeI2CAdd(LIDARLITE_ADDR_DEFAULT);
+
+  // The refused zero length write, then a one byte read
+  CHECK(lidar.begin(LIDARLITE_ADDR_DEFAULT, bus));
+  CHECK_EQUAL(2, bus.getTransferCount());
+  CHECK_EQUAL(1, fakeI2CStats().failures);
+
+  // Remembered for the bus: one ioctl per probe from now on, and a missing device still NACKs
+  bus.clearTransferCount();
+  CHECK(lidar.isConnected());
+  CHECK_EQUAL(1, bus.getTransferCount());
+  CHECK(!lidar.begin(0x10, bus));
+  CHECK_EQUAL(LIDARLITE_LINUX_NACK, lidar.getLastError());
+  CHECK_EQUAL(2, bus.getTransferCount());
+
+  // A new adapter is tried with the zero length write again
+  fakeI2CSetNoZeroLength(false);
+  bus.attach(FAKE_I2C_FD);
+  fakeI2CClearStats();
+  CHECK(lidar.begin(LIDARLITE_ADDR_DEFAULT, bus));
+  CHECK_EQUAL(1, fakeI2CStats().transfers);
+  CHECK_EQUAL(0, fakeI2CStats().failures);
+}
+
+TEST(begin_failsOnUnopenedDefaultPort)
+{
+  LIDARLite_v4LED lidar;
+
+  CHECK(!lidar.begin());
+  CHECK_EQUAL(LIDARLITE_LINUX_ERROR, lidar.getLastError());
+}
+
+TEST(getDistance_oneIoctlPerTransaction)
+{
+  LIDARLite_LinuxI2CBus bus;
+  LIDARLite_v4LED lidar;
+
+  attachFake(bus);
+  FakeI2CDevice *sensor = fakeI2CAdd(LIDARLITE_ADDR_DEFAULT);
+  sensor->distance = 1234;
+  sensor->busyReads = 2;
+  lidar.begin(LIDARLITE_ADDR_DEFAULT, bus);
+  lidar.configure(5);
+
+  bus.clearTransferCount();
+  fakeI2CClearStats();
+  CHECK_EQUAL(1234, lidar.getDistance());
+
+  // Trigger, three STATUS polls, and the distance register write and read in one ioctl
+  CHECK_EQUAL(3, lidar.getLastWaitPolls());
+  CHECK_EQUAL(1 + 3 + 1, bus.getTransferCount());
+  CHECK_EQUAL(1 + 2 * 3 + 2, fakeI2CStats().messages);
+  CHECK_EQUAL(1, sensor->triggers);
+}
+
+TEST(write_sendsRegisterAndDataInOneMessage)
+{
+  LIDARLite_LinuxI2CBus bus;
+  LIDARLite_v4LED lidar;
+  uint8_t data[3] = {0x11, 0x22, 0x33};
+
+  attachFake(bus);
+  FakeI2CDevice *sensor = fakeI2CAdd(LIDARLITE_ADDR_DEFAULT);
+  lidar.begin(LIDARLITE_ADDR_DEFAULT, bus);
+
+  fakeI2CClearStats();
+  CHECK(lidar.write(0x16, data, 3));
+  CHECK_EQUAL(1, fakeI2CStats().messages);
+  CHECK_EQUAL(0x11, sensor->registers[0x16]);
+  CHECK_EQUAL(0x33, sensor->registers[0x18]);
+}
+
+TEST(read_leavesBufferUntouchedOnNack)
+{
+  LIDARLite_LinuxI2CBus bus;
+  LIDARLite_v4LED lidar;
+  uint8_t data[2] = {0x5A, 0x5A};
+
+  attachFake(bus);
+  FakeI2CDevice *sensor = fakeI2CAdd(LIDARLITE_ADDR_DEFAULT);
+  sensor->registers[0xE0] = 0x17;
+  lidar.begin(LIDARLITE_ADDR_DEFAULT, bus);
+
+  sensor->present = false;
+  CHECK(!lidar.read(0xE0, data, 2));
+  CHECK_EQUAL(LIDARLITE_LINUX_NACK, lidar.getLastError());
+  CHECK_EQUAL(0x5A, data[0]);
+  CHECK_EQUAL(0x5A, data[1]);
+
+  sensor->present = true;
+  CHECK(lidar.read(0xE0, data, 1));
+  CHECK_EQUAL(0x17, data[0]);
+}
+
+TEST(readBatch_readsEverySensorInOneIoctl)
+{
+  LIDARLite_LinuxI2CBus bus;
+  const uint8_t addresses[3] = {0x62, 0x63, 0x64};
+  uint8_t data[6];
+
+  attachFake(bus);
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    FakeI2CDevice *sensor = fakeI2CAdd(addresses[i]);
+    sensor->registers[0x10] = 10 * (i + 1);
+    sensor->registers[0x11] = i;
+  }
+
+  CHECK_EQUAL(0, bus.readBatch(addresses, 3, 0x10, data, 2));
+  CHECK_EQUAL(1, bus.getTransferCount());
+  CHECK_EQUAL(6, fakeI2CStats().messages);
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    CHECK_EQUAL(10 * (i + 1), data[2 * i]);
+    CHECK_EQUAL(i, data[2 * i + 1]);
+  }
+}
+
+TEST(readBatch_reportsMissingSensorAndOversizedBatch)
+{
+  LIDARLite_LinuxI2CBus bus;
+  uint8_t addresses[LIDARLITE_LINUX_MAX_BATCH + 1] = {0x62, 0x63};
+  uint8_t data[2 * (LIDARLITE_LINUX_MAX_BATCH + 1)];
+
+  attachFake(bus);
+  fakeI2CAdd(0x62);
+
+  CHECK_EQUAL(LIDARLITE_LINUX_NACK, bus.readBatch(addresses, 2, 0x10, data, 2));
+  CHECK_EQUAL(LIDARLITE_LINUX_ERROR, bus.readBatch(addresses, LIDARLITE_LINUX_MAX_BATCH + 1, 0x10, data, 2));
+  CHECK_EQUAL(LIDARLITE_LINUX_ERROR, bus.readBatch(addresses, 0, 0x10, data, 2));
+  CHECK_EQUAL(1, bus.getTransferCount());
+}
+
+TEST(setTransferFunction_nullRestoresIoctl)
+{
+  LIDARLite_LinuxI2CBus bus;
+  LIDARLite_v4LED lidar;
+
+  attachFake(bus);
+  fakeI2CAdd(LIDARLITE_ADDR_DEFAULT);
+  bus.setTransferFunction(NULL);
+
+  // The real I2C_RDWR on a descriptor that is not an adapter fails with ENOTTY
+  int fd = open("/dev/null", O_RDWR);
+  CHECK(fd >= 0);
+  bus.attach(fd);
+  CHECK(!lidar.begin(LIDARLITE_ADDR_DEFAULT, bus));
+  CHECK_EQUAL(LIDARLITE_LINUX_ERROR, lidar.getLastError());
+  CHECK_EQUAL(0, fakeI2CStats().transfers);
+
+  bus.close();
+  CHECK(!bus.isOpen());
+  CHECK(fcntl(fd, F_GETFD) != -1); // attach() does not hand over the descriptor
+  close(fd);
+}
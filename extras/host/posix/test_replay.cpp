@@ -0,0 +1,152 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_replay.cpp
+
+  LIDARLite_ReplayTransport in the library built without an Arduino core:
+  a recording made on the sensor, here written out by hand in the format
+  described in LIDARLite_v4LED_Record.h, replays through the unmodified
+  driver on a Linux host, and requests that differ from it, or a log cut
+  short, are reported as mismatches.
+
+------------------------------------------------------------------------------*/
+
+#include <string.h>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_Record.h"
+#include "HostTest.h"
+
+static_assert(LIDARLITE_ARDUINO == 0, "built against an Arduino.h");
+
+typedef LIDARLite_v4LED_T<LIDARLite_ReplayTransport> ReplayLidar;
+
+// A log under construction
+struct Log
+{
+  uint8_t data[256];
+  uint32_t length = 0;
+
+  Log() { put4('L', 'L', 'R', 0x01); }
+
+  void put(uint8_t value) { data[length++] = value; }
+  void put4(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { put(a); put(b); put(c); put(d); }
+
+  // Type, one byte time delta under 128 us, address
+  void header(uint8_t type, uint8_t deltaUs)
+  {
+    put(type);
+    put(deltaUs);
+    put(LIDARLITE_ADDR_DEFAULT);
+  }
+
+  void ping(uint8_t deltaUs, uint8_t status)
+  {
+    header(LIDARLITE_RECORD_PING, deltaUs);
+    put(status);
+  }
+
+  void transfer(uint8_t type, uint8_t deltaUs, uint8_t regAddr, uint8_t status, const uint8_t *dataBytes, uint8_t numBytes)
+  {
+    header(type, deltaUs);
+    put(regAddr);
+    put(status);
+    put(numBytes);
+    if (type == LIDARLITE_RECORD_WRITE || status == 0)
+      for (uint8_t i = 0; i < numBytes; i++)
+        put(dataBytes[i]);
+  }
+
+  void sample(uint8_t deltaUs, uint16_t distance)
+  {
+    header(LIDARLITE_RECORD_SAMPLE, deltaUs);
+    put(distance & 0xFF);
+    put(distance >> 8);
+  }
+
+  LIDARLite_Recording recording() { return {data, length}; }
+};
+
+// begin(), then takeRange(), two STATUS polls and the distance read of one measurement of 1234 cm
+static void recordMeasurement(Log &log)
+{
+  const uint8_t trigger = 0x04;
+  const uint8_t busy = 0x01;
+  const uint8_t idle = 0x00;
+  const uint8_t distance[2] = {1234 & 0xFF, 1234 >> 8};
+
+  log.ping(10, 0);
+  log.transfer(LIDARLITE_RECORD_WRITE, 20, 0x00, 0, &trigger, 1);
+  log.transfer(LIDARLITE_RECORD_READ, 100, 0x01, 0, &busy, 1);
+  log.transfer(LIDARLITE_RECORD_READ, 100, 0x01, 0, &idle, 1);
+  log.transfer(LIDARLITE_RECORD_READ, 50, 0x10, 0, distance, 2);
+  log.sample(5, 1234);
+}
+
+TEST(replay_reproducesTheDriverResults)
+{
+  Log log;
+  ReplayLidar lidar;
+
+  recordMeasurement(log);
+  LIDARLite_Recording recording = log.recording();
+
+  CHECK(lidar.begin(LIDARLITE_ADDR_DEFAULT, recording));
+  lidar.takeRange();
+  CHECK_EQUAL(1, lidar.getBusyFlag());
+  CHECK_EQUAL(0, lidar.getBusyFlag());
+  uint16_t distance = lidar.readDistance();
+  CHECK_EQUAL(1234, distance);
+  CHECK(lidar.getTransport().verifySample(distance));
+
+  CHECK_EQUAL(0, lidar.getTransport().getMismatches());
+  CHECK_EQUAL(10 + 20 + 100 + 100 + 50 + 5, lidar.getTransport().getRecordedTime());
+  CHECK(lidar.getTransport().atEnd());
+}
+
+TEST(replay_reportsRequestsThatDiffer)
+{
+  Log log;
+  ReplayLidar lidar;
+  uint8_t value = 0x05;
+
+  recordMeasurement(log);
+  LIDARLite_Recording recording = log.recording();
+
+  // A write where the recording has the trigger
+  CHECK(lidar.begin(LIDARLITE_ADDR_DEFAULT, recording));
+  CHECK(!lidar.write(0x00, &value, 1));
+  CHECK_EQUAL(LIDARLITE_REPLAY_MISMATCH, lidar.getLastError());
+  CHECK_EQUAL(1, lidar.getTransport().getMismatches());
+
+  // A sample the driver did not decode
+  lidar.getBusyFlag();
+  lidar.getBusyFlag();
+  lidar.readDistance();
+  CHECK(!lidar.getTransport().verifySample(1000));
+  CHECK_EQUAL(2, lidar.getTransport().getMismatches());
+}
+
+TEST(replay_stopsAtTruncatedLog)
+{
+  Log log;
+  ReplayLidar lidar;
+
+  recordMeasurement(log);
+
+  // Cut inside the distance read, as an interrupted write to a card leaves it
+  LIDARLite_Recording recording = log.recording();
+  recording.length -= 6 + 1;
+
+  CHECK(lidar.begin(LIDARLITE_ADDR_DEFAULT, recording));
+  lidar.takeRange();
+  lidar.getBusyFlag();
+  lidar.getBusyFlag();
+  CHECK_EQUAL(0, lidar.readDistance());
+  CHECK_EQUAL(1, lidar.getTransport().getMismatches());
+  CHECK(lidar.getTransport().atEnd());
+
+  // A log without the header replays as empty
+  LIDARLite_Recording headless = {log.data + 4, log.length - 4};
+  CHECK(!lidar.begin(LIDARLITE_ADDR_DEFAULT, headless));
+  CHECK(lidar.getTransport().atEnd());
+}
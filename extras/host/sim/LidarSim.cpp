@@ -0,0 +1,910 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  LidarSim.cpp
+
+  The sensor model, the simulated bus and clock, and the fake Arduino core
+  functions declared in ../arduino that run on them.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <SD.h>
+#include <math.h>
+#include "LidarSim.h"
+
+//Register map, as in LIDARLite_v4LED.h
+enum
+{
+    ACQ_COMMANDS = 0x00,
+    STATUS = 0x01,
+    ACQUISITION_COUNT = 0x05,
+    FULL_DELAY_LOW = 0x10,
+    FULL_DELAY_HIGH = 0x11,
+    UNIT_ID_0 = 0x16,
+    UNIT_ID_3 = 0x19,
+    I2C_SEC_ADDR = 0x1A,
+    I2C_CONFIG = 0x1B,
+    DETECTION_SENSITIVITY = 0x1C,
+    LIB_VERSION = 0x30,
+    CORR_DATA = 0x52,
+    CORR_DATA_SIGN = 0x53,
+    CP_VER_LO = 0x72,
+    CP_VER_HI = 0x73,
+    BOARD_TEMPERATURE = 0xE0,
+    HARDWARE_VERSION = 0xE1,
+    POWER_MODE = 0xE2,
+    MEASUREMENT_INTERVAL = 0xE3,
+    FACTORY_RESET = 0xE4,
+    QUICK_TERMINATION = 0xE5,
+    ENABLE_FLASH_STORAGE = 0xEA,
+    HIGH_ACCURACY_MODE = 0xEB,
+    SOC_TEMPERATURE = 0xEC,
+};
+
+#define DEFAULT_ADDRESS 0x62
+#define NEVER UINT64_MAX
+
+struct SimPin
+{
+    uint8_t mode;
+    uint8_t output; //Level written with digitalWrite()
+    int8_t input;   //Level driven from outside with simSetPin(), -1 if none
+    void (*isr)();
+    int isrMode;
+    bool pending;   //Edge seen while interrupts were off
+};
+
+static uint64_t simTime = 0;
+static SimLidar *devices[SIM_MAX_DEVICES];
+static uint8_t numDevices = 0;
+static uint32_t busClock = 100000;
+static SimBusStats busStats;
+static uint8_t sdaHold = 0;
+static SimPin pins[SIM_MAX_PINS];
+static bool interruptsEnabled = true;
+static uint32_t randomState = 1;
+
+HardwareSerial Serial;
+TwoWire Wire;
+TwoWire Wire1;
+SDClass SD;
+
+/*------------------------------------------------------------------------------
+  Sensor model
+------------------------------------------------------------------------------*/
+SimLidar::SimLidar(uint32_t serial)
+{
+    _random = serial | 1;
+    _regs[UNIT_ID_0] = serial & 0xFF;
+    _regs[UNIT_ID_0 + 1] = (serial >> 8) & 0xFF;
+    _regs[UNIT_ID_0 + 2] = (serial >> 16) & 0xFF;
+    _regs[UNIT_ID_3] = serial >> 24;
+    resetRegisters();
+    memcpy(_flash, _regs, sizeof(_regs));
+    memset(_record, 0, sizeof(_record));
+}
+
+// Power-up defaults, keeping the serial number
+void SimLidar::resetRegisters()
+{
+    uint8_t unitId[4];
+
+    memcpy(unitId, &_regs[UNIT_ID_0], 4);
+    memset(_regs, 0, sizeof(_regs));
+    memcpy(&_regs[UNIT_ID_0], unitId, 4);
+
+    _regs[ACQUISITION_COUNT] = 0xFF;
+    _regs[LIB_VERSION] = 0x01;
+    _regs[CP_VER_LO] = 0x10;
+    _regs[CP_VER_HI] = 0x02;
+    _regs[BOARD_TEMPERATURE] = 25;
+    _regs[HARDWARE_VERSION] = 0x10;
+    _regs[POWER_MODE] = 0xFF;
+    _regs[QUICK_TERMINATION] = 0x08;
+    _regs[HIGH_ACCURACY_MODE] = 0x14;
+    _regs[SOC_TEMPERATURE] = 32;
+}
+
+void SimLidar::setSecondReturn(uint16_t distance, uint8_t percent)
+{
+    _secondDistance = distance;
+    _secondPercent = percent;
+}
+
+void SimLidar::nackTransactions(uint16_t count, uint32_t after)
+{
+    _nackCount = count;
+    _nackAfter = after;
+}
+
+void SimLidar::nackWrites(uint8_t regAddr, uint16_t count)
+{
+    _nackWriteReg = regAddr;
+    _nackWriteCount = count;
+}
+
+void SimLidar::powerCycle()
+{
+    account(simTime);
+    memcpy(_regs, _flash, sizeof(_regs));
+    _regs[ENABLE_FLASH_STORAGE] = 0;
+    _config = _flashConfig;
+    _secondary = _flashSecondary;
+    _restartStart = 0;
+    _restartEnd = 0;
+    _pointer = 0;
+    _busy = false;
+    _hung = false;
+    _triggered = false;
+    _pinTriggerTime = 0;
+    _result = 0;
+    _recordIndex = 0;
+    memset(_record, 0, sizeof(_record));
+    if (_monitorPin >= 0)
+        simSetPin(_monitorPin, LOW);
+}
+
+void SimLidar::attachPins(uint8_t triggerPin, uint8_t monitorPin)
+{
+    _triggerPin = triggerPin;
+    _monitorPin = monitorPin;
+    simSetPin(monitorPin, _busy ? HIGH : LOW);
+}
+
+// Coprocessor on-time: always in always-on mode, only while measuring in asynchronous mode
+void SimLidar::account(uint64_t now)
+{
+    if (_regs[POWER_MODE] != 0x00 || _busy)
+        _awakeNs += now - _accountTime;
+    _accountTime = now;
+}
+
+uint64_t SimLidar::getAwakeTime()
+{
+    account(simTime);
+    return _awakeNs;
+}
+
+// Acquisitions the next measurement runs. Quick termination stops once a near target's signal is strong enough
+uint16_t SimLidar::acquisitionCount()
+{
+    uint16_t count = (_regs[ACQUISITION_COUNT] == 0) ? 1 : _regs[ACQUISITION_COUNT];
+
+    if (_regs[QUICK_TERMINATION] == 0x00)
+    {
+        uint16_t needed = (_distance / 4 < 4) ? 4 : _distance / 4;
+        if (needed < count)
+            count = needed;
+    }
+    return count;
+}
+
+uint32_t SimLidar::acquisitionTimeUs()
+{
+    uint32_t time = SIM_ACQ_BASE_US + (uint32_t)acquisitionCount() * SIM_ACQ_COUNT_US;
+
+    if (_regs[POWER_MODE] == 0x00)
+        time += SIM_WAKE_US;
+    return time;
+}
+
+uint64_t SimLidar::intervalNs()
+{
+    return (uint64_t)_regs[MEASUREMENT_INTERVAL] * _intervalUnitNs;
+}
+
+// Approximately normal, mean 0 and standard deviation 1, from four xorshift uniforms
+float SimLidar::gaussian()
+{
+    float sum = 0;
+
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        _random ^= _random << 13;
+        _random ^= _random >> 17;
+        _random ^= _random << 5;
+        sum += (_random & 0xFFFF) / 32768.0f - 1.0f;
+    }
+    return sum * 0.866f;
+}
+
+void SimLidar::trigger(uint64_t now)
+{
+    account(now);
+
+    _busy = true;
+    _triggered = true;
+    _startTime = now;
+    _lastTrigger = now;
+    _completeTime = now + (uint64_t)acquisitionTimeUs() * 1000;
+    _measurements++;
+
+    if (_monitorPin >= 0)
+        simSetPin(_monitorPin, HIGH);
+}
+
+/*------------------------------------------------------------------------------
+  Complete
+
+  Latch the result of the measurement that just finished: the distance with
+  noise that shrinks with the square root of the acquisitions run, or 0 when
+  the target is beyond the range of the configured acquisition count, and a
+  new correlation record.
+------------------------------------------------------------------------------*/
+void SimLidar::complete()
+{
+    uint16_t count = (_regs[ACQUISITION_COUNT] == 0) ? 1 : _regs[ACQUISITION_COUNT];
+    float range = _maxRange * sqrtf(count / 255.0f);
+
+    account(_completeTime);
+    _busy = false;
+
+    if (_regs[DETECTION_SENSITIVITY] != 0)
+        range *= 1.25f;
+
+    if (_distance > range)
+    {
+        _result = 0;
+        fillRecord(-1);
+    }
+    else
+    {
+        float distance = _distance + gaussian() * _noise * sqrtf(255.0f / acquisitionCount());
+        if (distance < 1)
+            distance = 1;
+        _result = (uint16_t)(distance + 0.5f);
+        fillRecord(distance);
+    }
+    _recordIndex = 0;
+
+    if (_monitorPin >= 0)
+        simSetPin(_monitorPin, LOW);
+}
+
+// Bipolar pulse, positive lobe before the crossing, plus a small noise floor. distance < 0 leaves only noise
+void SimLidar::fillRecord(float distance)
+{
+    const float width = 2.5f;
+
+    for (uint16_t i = 0; i < SIM_CORR_POINTS; i++)
+    {
+        float value = gaussian() * 8;
+
+        if (distance >= 0)
+        {
+            float amplitude = 8000.0f * 100 / (distance + 100);
+            float x = (i - SIM_CORR_POINT(distance)) / width;
+            value -= amplitude * x * expf(0.5f - x * x / 2);
+
+            if (_secondDistance != 0)
+            {
+                x = (i - SIM_CORR_POINT(_secondDistance)) / width;
+                value -= amplitude * _secondPercent / 100 * x * expf(0.5f - x * x / 2);
+            }
+        }
+
+        if (value > 32767)
+            value = 32767;
+        if (value < -32768)
+            value = -32768;
+        _record[i] = (int16_t)value;
+    }
+}
+
+bool SimLidar::responds(uint8_t address, uint64_t now)
+{
+    if (!_present)
+        return false;
+    if (_restartEnd != 0 && now >= _restartStart && now < _restartEnd)
+        return false;
+
+    bool match = ((_config == 0 || _config == 2) && address == DEFAULT_ADDRESS) ||
+                 ((_config == 1 || _config == 2) && _secondary != 0 && address == _secondary);
+    if (!match)
+        return false;
+
+    if (_nackCount > 0 && _nackAfter > 0)
+        _nackAfter--;
+    else if (_nackCount > 0)
+    {
+        _nackCount--;
+        return false;
+    }
+    return true;
+}
+
+uint8_t SimLidar::readRegister(uint8_t regAddr)
+{
+    switch (regAddr)
+    {
+    case STATUS:
+        return (_busy || _hung) ? 0x01 : 0x00;
+    case FULL_DELAY_LOW:
+        return _result & 0xFF;
+    case FULL_DELAY_HIGH:
+        return _result >> 8;
+    case I2C_SEC_ADDR:
+        return _secondary;
+    case I2C_CONFIG:
+        return _config;
+    case CORR_DATA:
+        return (_recordIndex < SIM_CORR_POINTS) ? (_record[_recordIndex] & 0xFF) : 0;
+    case CORR_DATA_SIGN:
+    {
+        uint8_t value = (_recordIndex < SIM_CORR_POINTS) ? ((uint16_t)_record[_recordIndex] >> 8) : 0;
+        if (_recordIndex < SIM_CORR_POINTS)
+            _recordIndex++;
+        return value;
+    }
+    default:
+        return _regs[regAddr];
+    }
+}
+
+uint8_t SimLidar::busRead(uint64_t now)
+{
+    (void)now;
+    return readRegister(_pointer++);
+}
+
+void SimLidar::writeRegister(uint8_t regAddr, uint8_t value)
+{
+    bool flash = (_regs[ENABLE_FLASH_STORAGE] == 0x11);
+
+    switch (regAddr)
+    {
+    case ACQ_COMMANDS:
+        if (value == 0x04)
+            trigger(simTime);
+        break;
+
+    // Read only
+    case STATUS:
+    case FULL_DELAY_LOW:
+    case FULL_DELAY_HIGH:
+    case UNIT_ID_0:
+    case UNIT_ID_0 + 1:
+    case UNIT_ID_0 + 2:
+    case UNIT_ID_3:
+    case I2C_SEC_ADDR:
+    case CORR_DATA:
+    case CORR_DATA_SIGN:
+    case BOARD_TEMPERATURE:
+    case HARDWARE_VERSION:
+    case SOC_TEMPERATURE:
+        break;
+
+    case I2C_CONFIG:
+        _pendingConfig = value;
+        _pendingSecondary = _secondary;
+        _restartStart = simTime + (uint64_t)SIM_RESTART_DELAY_US * 1000;
+        _restartEnd = _restartStart + (uint64_t)SIM_RESTART_US * 1000;
+        if (flash)
+            _flashConfig = value;
+        break;
+
+    case FACTORY_RESET:
+        account(simTime);
+        resetRegisters();
+        memcpy(_flash, _regs, sizeof(_regs));
+        _flashConfig = 0;
+        _flashSecondary = 0;
+        _pendingConfig = 0;
+        _pendingSecondary = 0;
+        _restartStart = simTime + (uint64_t)SIM_RESTART_DELAY_US * 1000;
+        _restartEnd = _restartStart + (uint64_t)SIM_RESTART_US * 1000;
+        break;
+
+    case POWER_MODE:
+        account(simTime);
+        _regs[regAddr] = value;
+        if (flash)
+            _flash[regAddr] = value;
+        break;
+
+    case ENABLE_FLASH_STORAGE:
+        _regs[regAddr] = value;
+        break;
+
+    default:
+        _regs[regAddr] = value;
+        if (flash)
+            _flash[regAddr] = value;
+        break;
+    }
+}
+
+/*------------------------------------------------------------------------------
+  Bus Write
+
+  The first byte sets the register pointer, the rest are written from there
+  on. The serial number write to UNIT_ID_0 is the one multi-byte command:
+  only the sensor whose serial number it carries takes the address, and
+  answers on it (alongside the default address, unless that was already
+  turned off) once its I2C peripheral has restarted.
+------------------------------------------------------------------------------*/
+bool SimLidar::busWrite(const uint8_t *dataBytes, uint8_t numBytes, uint64_t now)
+{
+    (void)now;
+
+    if (numBytes == 0)
+        return true;
+
+    if (_nackWriteCount > 0 && numBytes > 1 && dataBytes[0] == _nackWriteReg)
+    {
+        _nackWriteCount--;
+        return false;
+    }
+
+    _pointer = dataBytes[0];
+
+    if (_pointer == UNIT_ID_0 && numBytes == 6)
+    {
+        if (memcmp(&dataBytes[1], &_regs[UNIT_ID_0], 4) == 0)
+        {
+            _pendingSecondary = dataBytes[5];
+            _pendingConfig = (_config == 0) ? 2 : _config;
+            _restartStart = simTime + (uint64_t)SIM_RESTART_DELAY_US * 1000;
+            _restartEnd = _restartStart + (uint64_t)SIM_RESTART_US * 1000;
+            if (_regs[ENABLE_FLASH_STORAGE] == 0x11)
+            {
+                _flashSecondary = _pendingSecondary;
+                _flashConfig = _pendingConfig;
+            }
+        }
+        return true;
+    }
+
+    for (uint8_t i = 1; i < numBytes; i++)
+        writeRegister(_pointer++, dataBytes[i]);
+
+    return true;
+} /* SimLidar::busWrite */
+
+// Either edge of the trigger pin starts a measurement
+void SimLidar::onPinEdge(uint8_t pin, uint64_t now)
+{
+    if (_present && pin == _triggerPin)
+        _pinTriggerTime = now + SIM_TRIGGER_LATENCY_NS;
+}
+
+uint64_t SimLidar::nextEvent()
+{
+    uint64_t next = NEVER;
+
+    if (_pinTriggerTime != 0)
+        next = _pinTriggerTime;
+    if (_busy && !_hung && _completeTime < next)
+        next = _completeTime;
+    if (_restartEnd != 0 && _restartEnd < next)
+        next = _restartEnd;
+    if (_triggered && intervalNs() != 0 && _lastTrigger + intervalNs() < next)
+        next = _lastTrigger + intervalNs();
+
+    return next;
+}
+
+// A self-triggered measurement that falls due while the previous one is still running is skipped
+void SimLidar::runEvents(uint64_t now)
+{
+    if (_pinTriggerTime != 0 && now >= _pinTriggerTime)
+    {
+        _pinTriggerTime = 0;
+        trigger(now);
+    }
+
+    if (_busy && !_hung && now >= _completeTime)
+        complete();
+
+    if (_restartEnd != 0 && now >= _restartEnd)
+    {
+        _config = _pendingConfig;
+        _secondary = _pendingSecondary;
+        _restartStart = 0;
+        _restartEnd = 0;
+    }
+
+    if (_triggered && intervalNs() != 0 && now >= _lastTrigger + intervalNs())
+    {
+        if (_busy)
+            _lastTrigger += intervalNs();
+        else
+            trigger(now);
+    }
+}
+
+/*------------------------------------------------------------------------------
+  Clock
+------------------------------------------------------------------------------*/
+void simReset()
+{
+    simTime = 0;
+    numDevices = 0;
+    busClock = 100000;
+    memset(&busStats, 0, sizeof(busStats));
+    sdaHold = 0;
+    interruptsEnabled = true;
+    randomState = 1;
+
+    for (uint8_t i = 0; i < SIM_MAX_PINS; i++)
+    {
+        pins[i].mode = INPUT;
+        pins[i].output = LOW;
+        pins[i].input = -1;
+        pins[i].isr = NULL;
+        pins[i].isrMode = 0;
+        pins[i].pending = false;
+    }
+}
+
+void simAttach(SimLidar &lidar)
+{
+    if (numDevices < SIM_MAX_DEVICES)
+        devices[numDevices++] = &lidar;
+}
+
+uint64_t simNanos()
+{
+    return simTime;
+}
+
+// Step from event to event so every pin edge and completion happens at its own time
+void simAdvance(uint64_t ns)
+{
+    uint64_t target = simTime + ns;
+
+    while (1)
+    {
+        uint64_t next = NEVER;
+        for (uint8_t i = 0; i < numDevices; i++)
+        {
+            uint64_t event = devices[i]->nextEvent();
+            if (event < next)
+                next = event;
+        }
+        if (next > target)
+            break;
+
+        if (next > simTime)
+            simTime = next;
+        for (uint8_t i = 0; i < numDevices; i++)
+            devices[i]->runEvents(simTime);
+    }
+
+    simTime = target;
+}
+
+uint32_t simGetClock()
+{
+    return busClock;
+}
+
+SimBusStats simGetBusStats()
+{
+    return busStats;
+}
+
+void simClearBusStats()
+{
+    memset(&busStats, 0, sizeof(busStats));
+}
+
+void simHoldSda(uint8_t clocks)
+{
+    sdaHold = clocks;
+}
+
+/*------------------------------------------------------------------------------
+  Bus
+
+  Each transaction costs 9 clocks per byte and 2 for START and STOP. A
+  write's effect, such as a trigger, happens at the end of its transaction;
+  read data is sampled at the start.
+------------------------------------------------------------------------------*/
+static void chargeBus(uint32_t numBytes)
+{
+    uint64_t clocks = 9 * (uint64_t)numBytes + 2;
+    uint64_t ns = clocks * 1000000000ULL / busClock;
+
+    busStats.transactions++;
+    busStats.bytes += numBytes;
+    busStats.clocks += clocks;
+    busStats.busTimeNs += ns;
+    simAdvance(ns);
+}
+
+void TwoWire::begin()
+{
+}
+
+void TwoWire::end()
+{
+}
+
+void TwoWire::setClock(uint32_t frequency)
+{
+    busClock = frequency;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    _address = address;
+    _txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t value)
+{
+    if (_txLength >= BUFFER_LENGTH)
+        return 0;
+    _txBuffer[_txLength++] = value;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *buffer, size_t size)
+{
+    size_t written = 0;
+    while (written < size && write(buffer[written]))
+        written++;
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+    SimLidar *responders[SIM_MAX_DEVICES];
+    uint8_t numResponders = 0;
+    bool refused = false;
+
+    (void)sendStop;
+
+    if (sdaHold > 0)
+    {
+        chargeBus(1);
+        busStats.nacks++;
+        return 4;
+    }
+
+    for (uint8_t i = 0; i < numDevices; i++)
+        if (devices[i]->responds(_address, simTime))
+            responders[numResponders++] = devices[i];
+
+    if (numResponders == 0)
+    {
+        chargeBus(1);
+        busStats.nacks++;
+        return 2;
+    }
+
+    chargeBus(1 + _txLength);
+    for (uint8_t i = 0; i < numResponders; i++)
+        if (!responders[i]->busWrite(_txBuffer, _txLength, simTime))
+            refused = true;
+
+    if (refused)
+    {
+        busStats.nacks++;
+        return 3;
+    }
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop)
+{
+    SimLidar *responders[SIM_MAX_DEVICES];
+    uint8_t numResponders = 0;
+
+    (void)sendStop;
+    _rxLength = 0;
+    _rxIndex = 0;
+
+    if (quantity > BUFFER_LENGTH)
+        quantity = BUFFER_LENGTH;
+
+    if (sdaHold > 0)
+    {
+        chargeBus(1);
+        busStats.nacks++;
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < numDevices; i++)
+        if (devices[i]->responds(address, simTime))
+            responders[numResponders++] = devices[i];
+
+    if (numResponders == 0)
+    {
+        chargeBus(1);
+        busStats.nacks++;
+        return 0;
+    }
+
+    // Open drain: a 0 from any sensor wins
+    for (uint8_t i = 0; i < quantity; i++)
+    {
+        uint8_t value = 0xFF;
+        for (uint8_t j = 0; j < numResponders; j++)
+            value &= responders[j]->busRead(simTime);
+        _rxBuffer[i] = value;
+    }
+    chargeBus(1 + quantity);
+
+    _rxLength = quantity;
+    return quantity;
+}
+
+int TwoWire::available()
+{
+    return _rxLength - _rxIndex;
+}
+
+int TwoWire::read()
+{
+    if (_rxIndex >= _rxLength)
+        return -1;
+    return _rxBuffer[_rxIndex++];
+}
+
+/*------------------------------------------------------------------------------
+  Arduino core
+------------------------------------------------------------------------------*/
+unsigned long micros()
+{
+    return (unsigned long)(simTime / 1000);
+}
+
+unsigned long millis()
+{
+    return (unsigned long)(simTime / 1000000);
+}
+
+void delay(unsigned long ms)
+{
+    simAdvance((uint64_t)ms * 1000000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    simAdvance((uint64_t)us * 1000);
+}
+
+void yield()
+{
+}
+
+// SDA reads low while a sensor holds it; everything else follows the pull-ups unless driven
+static uint8_t pinLevel(uint8_t pin)
+{
+    const SimPin &p = pins[pin];
+
+    if (p.mode == OUTPUT)
+        return p.output;
+    if (p.input >= 0)
+        return p.input;
+    if (pin == PIN_WIRE_SDA && sdaHold > 0)
+        return LOW;
+    if (p.mode == INPUT_PULLUP || pin == PIN_WIRE_SDA || pin == PIN_WIRE_SCL)
+        return HIGH;
+    return p.output;
+}
+
+// A sensor holding SDA lets go of one bit for every SCL clock
+static void pinChanged(uint8_t pin, uint8_t before)
+{
+    uint8_t after = pinLevel(pin);
+
+    if (before == after)
+        return;
+
+    if (pin == PIN_WIRE_SCL && after == HIGH && sdaHold > 0)
+        sdaHold--;
+
+    for (uint8_t i = 0; i < numDevices; i++)
+        devices[i]->onPinEdge(pin, simTime);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin >= SIM_MAX_PINS)
+        return;
+
+    uint8_t before = pinLevel(pin);
+    pins[pin].mode = mode;
+    pinChanged(pin, before);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin >= SIM_MAX_PINS)
+        return;
+
+    uint8_t before = pinLevel(pin);
+    pins[pin].output = value ? HIGH : LOW;
+    pinChanged(pin, before);
+}
+
+int digitalRead(uint8_t pin)
+{
+    simAdvance(SIM_GPIO_READ_NS);
+    return (pin < SIM_MAX_PINS) ? pinLevel(pin) : LOW;
+}
+
+void simSetPin(uint8_t pin, uint8_t level)
+{
+    if (pin >= SIM_MAX_PINS)
+        return;
+
+    SimPin &p = pins[pin];
+    uint8_t before = pinLevel(pin);
+
+    p.input = level;
+    uint8_t after = pinLevel(pin);
+    if (before == after || p.isr == NULL)
+        return;
+
+    if (p.isrMode == CHANGE || (p.isrMode == FALLING && after == LOW) || (p.isrMode == RISING && after == HIGH))
+    {
+        if (interruptsEnabled)
+            p.isr();
+        else
+            p.pending = true;
+    }
+}
+
+void attachInterrupt(int interruptNumber, void (*isr)(), int mode)
+{
+    if (interruptNumber < 0 || interruptNumber >= SIM_MAX_PINS)
+        return;
+    pins[interruptNumber].isr = isr;
+    pins[interruptNumber].isrMode = mode;
+    pins[interruptNumber].pending = false;
+}
+
+void detachInterrupt(int interruptNumber)
+{
+    if (interruptNumber < 0 || interruptNumber >= SIM_MAX_PINS)
+        return;
+    pins[interruptNumber].isr = NULL;
+}
+
+void noInterrupts()
+{
+    interruptsEnabled = false;
+}
+
+// Edges that arrived while interrupts were off run now, once each like a hardware flag
+void interrupts()
+{
+    interruptsEnabled = true;
+    for (uint8_t i = 0; i < SIM_MAX_PINS; i++)
+    {
+        if (pins[i].pending && pins[i].isr != NULL)
+        {
+            pins[i].pending = false;
+            pins[i].isr();
+        }
+    }
+}
+
+long random(long howBig)
+{
+    randomState = randomState * 1103515245 + 12345;
+    return (howBig > 0) ? (long)((randomState >> 8) % howBig) : 0;
+}
+
+long random(long howSmall, long howBig)
+{
+    return (howBig > howSmall) ? howSmall + random(howBig - howSmall) : howSmall;
+}
@@ -0,0 +1,197 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  LidarSim.h
+
+  Register-level model of LIDAR-Lite v4 LED sensors on a simulated I2C bus,
+  with a simulated clock. The fake Arduino core in ../arduino runs on top of
+  it: micros() reads the simulated clock, and Wire transactions, delay(),
+  delayMicroseconds() and digitalRead() advance it, so the unmodified library
+  can be timed and tested on a host.
+
+  What is modeled
+  ------------------------------------------------------------------------------
+  Bus:      9 clocks per byte plus 2 per transaction for START and STOP at
+            the Wire.setClock() rate. Several devices answering the same
+            address all receive writes and their read data is wire-ANDed.
+            Register pointer auto-increments on every byte.
+  STATUS:   bit 0 set from a trigger until the acquisition completes.
+  Timing:   acquisition takes SIM_ACQ_BASE_US plus SIM_ACQ_COUNT_US per
+            acquisition. Quick termination stops near targets early.
+            Asynchronous power mode adds SIM_WAKE_US before each one.
+  Results:  FULL_DELAY latches the target distance plus noise that shrinks
+            with the acquisition count, or 0 when the target is beyond the
+            range of the acquisition count. CORR_DATA holds a 192 point
+            bipolar pulse whose zero crossing is at SIM_CORR_POINT(distance).
+  CORR_DATA: a 2 byte read of 0x52 returns one point, low byte from 0x52 and
+            high byte from 0x53. The record index advances after 0x53 has
+            been read, and starts over when a measurement completes. Reading
+            on past 0x53 returns the registers that follow it.
+  Address:  a 5 byte write of UNIT_ID_0..3 plus an address to UNIT_ID_0 is
+            only taken by the sensor with that serial number. I2C_CONFIG
+            takes effect when the sensor restarts its I2C peripheral,
+            SIM_RESTART_DELAY_US after the write and for SIM_RESTART_US, in
+            which time it does not acknowledge; reading I2C_CONFIG returns
+            the configuration in effect.
+  Flash:    with ENABLE_FLASH_STORAGE set to 0x11, register writes and the
+            address settings survive powerCycle().
+  Pins:     a trigger pin edge starts a measurement after the trigger
+            latency. The monitor pin is high while busy and its falling edge
+            runs an attachInterrupt() handler at the completion time.
+  Continuous: a non-zero MEASUREMENT_INTERVAL makes the sensor trigger
+            itself every interval * setIntervalUnit() after the previous
+            trigger.
+
+  Not modeled: clock stretching, high accuracy mode averaging, the timing of
+  register accesses in asynchronous mode and the CPU time of the host code.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef LidarSim_h
+#define LidarSim_h
+
+#include <stdint.h>
+
+#define SIM_MAX_DEVICES 32
+#define SIM_MAX_PINS 64
+
+#define SIM_ACQ_BASE_US 600       //Fixed part of every acquisition
+#define SIM_ACQ_COUNT_US 14       //Per acquisition, up to ACQUISITION_COUNT of them
+#define SIM_WAKE_US 2500          //Coprocessor wake-up before a measurement in asynchronous power mode
+#define SIM_RESTART_DELAY_US 200  //From an address change to the I2C peripheral restart
+#define SIM_RESTART_US 2000       //I2C peripheral restart, no acknowledge meanwhile
+#define SIM_TRIGGER_LATENCY_NS 1500 //Trigger pin edge to monitor pin high
+#define SIM_GPIO_READ_NS 500      //Time one digitalRead() takes
+#define SIM_CORR_POINTS 192       //Points in the correlation record
+
+//Record point of the zero crossing for a target at distance centimeters
+#define SIM_CORR_POINT(distance) (10.0 + (distance) / 8.0)
+
+//Bus traffic since the last simClearBusStats()
+struct SimBusStats
+{
+  uint32_t transactions; //START...STOP sequences, an address write and its repeated-start read count as two
+  uint32_t bytes;        //Bytes on the wire, address bytes included
+  uint32_t nacks;        //Transactions no device acknowledged
+  uint64_t clocks;       //SCL clocks
+  uint64_t busTimeNs;    //Time the bus was busy at the clock rate in use
+};
+
+class SimLidar
+{
+private:
+  uint8_t _regs[256];
+  uint8_t _flash[256];    //Register values restored by powerCycle()
+  uint8_t _pointer = 0;   //Register pointer
+  uint8_t _config = 0;    //I2C_CONFIG in effect
+  uint8_t _secondary = 0; //I2C_SEC_ADDR in effect
+  uint8_t _flashConfig = 0;
+  uint8_t _flashSecondary = 0;
+  uint8_t _pendingConfig = 0;
+  uint8_t _pendingSecondary = 0;
+  uint64_t _restartStart = 0; //Simulated ns at which a pending restart begins, 0 if none
+  uint64_t _restartEnd = 0;
+
+  bool _present = true;
+  bool _hung = false;
+  uint16_t _nackCount = 0;     //Transactions still to refuse
+  uint32_t _nackAfter = 0;     //Transactions to acknowledge before refusing them
+  int16_t _nackWriteReg = -1;  //Register whose next writes are refused
+  uint16_t _nackWriteCount = 0;
+
+  bool _busy = false;
+  uint64_t _startTime = 0;      //Trigger of the measurement in progress
+  uint64_t _completeTime = 0;   //When it completes
+  uint64_t _lastTrigger = 0;    //Start of the most recent measurement, for the interval
+  bool _triggered = false;      //A measurement has been started since power-up
+  uint64_t _pinTriggerTime = 0; //Pending trigger from the trigger pin, 0 if none
+  uint32_t _measurements = 0;
+  uint64_t _awakeNs = 0;
+  uint64_t _accountTime = 0;
+  uint64_t _intervalUnitNs = 1000000;
+
+  uint16_t _distance = 100;       //Target distance in centimeters
+  float _noise = 1.0;             //Standard deviation in cm at ACQUISITION_COUNT 255
+  uint16_t _maxRange = 1000;      //Range in cm at ACQUISITION_COUNT 255
+  uint16_t _secondDistance = 0;   //Second return, 0 for none
+  uint8_t _secondPercent = 0;     //Its amplitude relative to the first
+  uint16_t _result = 0;           //Latched FULL_DELAY
+  int16_t _record[SIM_CORR_POINTS];
+  uint8_t _recordIndex = 0;
+  uint32_t _random;
+
+  int16_t _triggerPin = -1;
+  int16_t _monitorPin = -1;
+
+  void resetRegisters();
+  void writeRegister(uint8_t regAddr, uint8_t value);
+  uint8_t readRegister(uint8_t regAddr);
+  void trigger(uint64_t now);
+  void complete();
+  void account(uint64_t now);
+  uint16_t acquisitionCount();
+  float gaussian();
+  void fillRecord(float distance);
+  uint64_t intervalNs();
+
+public:
+  SimLidar(uint32_t serial = 0x01020304);
+
+  //Scene
+  void setDistance(uint16_t distance) { _distance = distance; }
+  void setNoise(float noiseCm) { _noise = noiseCm; }
+  void setMaxRange(uint16_t range) { _maxRange = range; }
+  void setSecondReturn(uint16_t distance, uint8_t percent);
+  void setIntervalUnit(uint32_t unitNs) { _intervalUnitNs = unitNs; } //Length of one MEASUREMENT_INTERVAL count
+
+  //Faults
+  void setPresent(bool present) { _present = present; } //A sensor that is not present never acknowledges
+  void setHung(bool hung) { _hung = hung; }              //A hung sensor stays busy until powerCycle()
+  void nackTransactions(uint16_t count, uint32_t after = 0); //Refuse count transactions, after acknowledging the next after of them
+  void nackWrites(uint8_t regAddr, uint16_t count);      //Refuse the next count writes that start at regAddr
+  void powerCycle();                                     //Back to the flash contents, idle
+
+  //Pins
+  void attachPins(uint8_t triggerPin, uint8_t monitorPin);
+
+  //Called by the bus and the clock
+  bool responds(uint8_t address, uint64_t now);
+  bool busWrite(const uint8_t *dataBytes, uint8_t numBytes, uint64_t now); //False if the write was refused
+  uint8_t busRead(uint64_t now);
+  void onPinEdge(uint8_t pin, uint64_t now);
+  uint64_t nextEvent();          //Time of the next internal event, or UINT64_MAX
+  void runEvents(uint64_t now);  //Run every event due at now
+
+  //Inspection
+  uint8_t getRegister(uint8_t regAddr) { return _regs[regAddr]; }
+  uint8_t getConfig() { return _config; }
+  uint8_t getSecondaryAddress() { return _secondary; }
+  bool isBusy() { return _busy; }
+  uint32_t getMeasurementCount() { return _measurements; }
+  uint64_t getLastTriggerTime() { return _lastTrigger; } //Simulated ns
+  uint64_t getAwakeTime();                               //ns the coprocessor was powered
+  uint32_t acquisitionTimeUs();                          //Length of the next acquisition at the current settings
+};
+
+void simReset();                        //Remove all sensors, clear pins, bus, clock and statistics
+void simAttach(SimLidar &lidar);        //Put a sensor on the bus. It must stay in scope until simReset()
+uint64_t simNanos();                    //Simulated time in nanoseconds
+void simAdvance(uint64_t ns);           //Let time pass, running sensor events and interrupts on the way
+uint32_t simGetClock();                 //Wire.setClock() frequency in Hz
+SimBusStats simGetBusStats();
+void simClearBusStats();
+void simHoldSda(uint8_t clocks);        //A sensor holds SDA low for this many SCL clocks; transactions fail meanwhile
+void simSetPin(uint8_t pin, uint8_t level); //Drive an input pin, running its interrupt on a matching edge
+
+#endif
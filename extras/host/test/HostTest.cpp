@@ -0,0 +1,55 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  HostTest.cpp
+
+------------------------------------------------------------------------------*/
+
+#include "HostTest.h"
+
+#define MAX_TESTS 64
+
+static const char *testNames[MAX_TESTS];
+static HostTestFunction testFunctions[MAX_TESTS];
+static int numTests = 0;
+
+void hostTestRegister(const char *name, HostTestFunction function)
+{
+    if (numTests < MAX_TESTS)
+    {
+        testNames[numTests] = name;
+        testFunctions[numTests] = function;
+        numTests++;
+    }
+}
+
+void hostTestFail(const char *file, int line, const char *expression, long long expected, long long actual)
+{
+    printf("%s:%d: CHECK failed: %s (expected %lld, got %lld)\n", file, line, expression, expected, actual);
+    throw HostTestFailure();
+}
+
+int main()
+{
+    int failures = 0;
+
+    for (int i = 0; i < numTests; i++)
+    {
+#if HOSTTEST_SIM
+        simReset();
+#endif
+        try
+        {
+            testFunctions[i]();
+            printf("PASS %s\n", testNames[i]);
+        }
+        catch (HostTestFailure &)
+        {
+            printf("FAIL %s\n", testNames[i]);
+            failures++;
+        }
+    }
+
+    printf("%d of %d tests passed\n", numTests - failures, numTests);
+    return (failures == 0) ? 0 : 1;
+}
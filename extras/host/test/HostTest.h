@@ -0,0 +1,67 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  HostTest.h
+
+  Minimal test runner. Each TEST() starts from simReset(), so every test
+  sees an empty bus at time 0. A failed CHECK() reports and ends the test.
+  Built with HOSTTEST_SIM 0 for the tests that run without the simulator.
+
+    TEST(startMeasurement_goesBusy)
+    {
+      SimLidar lidar;
+      simAttach(lidar);
+      ...
+      CHECK_EQUAL(LIDARLITE_STATE_BUSY, myLIDAR.service());
+    }
+
+------------------------------------------------------------------------------*/
+#ifndef HostTest_h
+#define HostTest_h
+
+#include <stdio.h>
+
+#ifndef HOSTTEST_SIM
+#define HOSTTEST_SIM 1
+#endif
+
+#if HOSTTEST_SIM
+#include "LidarSim.h"
+#endif
+
+typedef void (*HostTestFunction)();
+
+struct HostTestFailure
+{
+};
+
+void hostTestRegister(const char *name, HostTestFunction function);
+void hostTestFail(const char *file, int line, const char *expression, long long expected, long long actual);
+
+struct HostTestRegistrar
+{
+  HostTestRegistrar(const char *name, HostTestFunction function) { hostTestRegister(name, function); }
+};
+
+#define TEST(name)                                                   \
+  static void name();                                                \
+  static HostTestRegistrar name##_registrar(#name, name);            \
+  static void name()
+
+#define CHECK(condition)                                             \
+  do                                                                 \
+  {                                                                  \
+    if (!(condition))                                                \
+      hostTestFail(__FILE__, __LINE__, #condition, 1, 0);            \
+  } while (0)
+
+#define CHECK_EQUAL(expected, actual)                                \
+  do                                                                 \
+  {                                                                  \
+    long long hostTestExpected = (long long)(expected);              \
+    long long hostTestActual = (long long)(actual);                  \
+    if (hostTestExpected != hostTestActual)                          \
+      hostTestFail(__FILE__, __LINE__, #actual, hostTestExpected, hostTestActual); \
+  } while (0)
+
+#endif
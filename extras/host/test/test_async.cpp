@@ -0,0 +1,204 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_async.cpp
+
+  The callback event loop: results, queueing per sensor, and sensors that do
+  not acknowledge their trigger, including callbacks and coroutines that
+  measure again straight away.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <new>
+#include <string.h>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_Async.h"
+#include "HostTest.h"
+
+static LIDARLite_v4LED_Async loop;
+static LIDARLite_v4LED *rearmSensor;
+static uint32_t calls;
+static uint8_t depth;
+static uint8_t maxDepth;
+static uint8_t lastStatus;
+static uint16_t lastDistance;
+static uint8_t order[8];
+
+static void record(void *context, uint8_t status, uint16_t distance)
+{
+  order[calls++] = (uint8_t)(uintptr_t)context;
+  lastStatus = status;
+  lastDistance = distance;
+}
+
+// Measures again from inside the callback, as Example 15 does
+static void rearm(void *context, uint8_t status, uint16_t distance)
+{
+  (void)context;
+  (void)distance;
+
+  depth++;
+  if (depth > maxDepth)
+    maxDepth = depth;
+  calls++;
+  lastStatus = status;
+  loop.measure(*rearmSensor, rearm, NULL);
+  depth--;
+}
+
+static void resetLoop()
+{
+  loop = LIDARLite_v4LED_Async();
+  calls = 0;
+  depth = 0;
+  maxDepth = 0;
+}
+
+TEST(measure_callsBackWithDistance)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  resetLoop();
+  sim.setDistance(420);
+  sim.setNoise(0);
+  simAttach(sim);
+  lidar.begin();
+
+  CHECK(loop.measure(lidar, record, (void *)1));
+  CHECK_EQUAL(0, calls);
+  while (loop.getPending() > 0)
+    loop.service();
+
+  CHECK_EQUAL(1, calls);
+  CHECK_EQUAL(LIDARLITE_ASYNC_OK, lastStatus);
+  CHECK_EQUAL(420, lastDistance);
+}
+
+TEST(measure_loopOnTheStackStartsEmpty)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  alignas(LIDARLite_v4LED_Async) uint8_t storage[sizeof(LIDARLite_v4LED_Async)];
+
+  simAttach(sim);
+  lidar.begin();
+
+  // Default initialized over leftover stack contents, as a local loop is
+  memset(storage, 0xA5, sizeof(storage));
+  LIDARLite_v4LED_Async *local = new (storage) LIDARLite_v4LED_Async;
+
+  for (uint16_t i = 0; i < LIDARLITE_ASYNC_MAX_PENDING; i++)
+    CHECK(local->measure(lidar, record, NULL));
+  CHECK(!local->measure(lidar, record, NULL));
+  CHECK_EQUAL(LIDARLITE_ASYNC_MAX_PENDING, local->getPending());
+}
+
+TEST(nack_completesFromServiceNotMeasure)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  resetLoop();
+  simAttach(sim);
+  lidar.begin();
+  sim.setPresent(false);
+
+  CHECK(loop.measure(lidar, record, (void *)1));
+  CHECK_EQUAL(0, calls);
+  CHECK_EQUAL(1, loop.getPending());
+
+  CHECK_EQUAL(1, loop.service());
+  CHECK_EQUAL(1, calls);
+  CHECK_EQUAL(LIDARLITE_ASYNC_NACK, lastStatus);
+  CHECK_EQUAL(0, loop.getPending());
+}
+
+TEST(nack_queuedRequestsCompleteInOrder)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  resetLoop();
+  simAttach(sim);
+  lidar.begin();
+  sim.setPresent(false);
+
+  for (uintptr_t i = 0; i < 5; i++)
+    CHECK(loop.measure(lidar, record, (void *)i));
+
+  for (uint8_t pass = 0; pass < 10 && loop.getPending() > 0; pass++)
+    loop.service();
+
+  CHECK_EQUAL(5, calls);
+  for (uint8_t i = 0; i < 5; i++)
+    CHECK_EQUAL(i, order[i]);
+}
+
+TEST(nack_rearmingCallbackDoesNotRecurse)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  resetLoop();
+  simAttach(sim);
+  lidar.begin();
+  sim.setPresent(false);
+  rearmSensor = &lidar;
+
+  loop.measure(lidar, rearm, NULL);
+  for (uint32_t i = 0; i < 100000; i++)
+    loop.service();
+
+  CHECK_EQUAL(100000, calls);
+  CHECK_EQUAL(1, maxDepth);
+  CHECK_EQUAL(1, loop.getPending());
+}
+
+#if LIDARLITE_ASYNC_COROUTINES
+// Fire-and-forget coroutine: starts at once, frees its frame when it returns
+struct Task
+{
+  struct promise_type
+  {
+    Task get_return_object() { return Task(); }
+    std::suspend_never initial_suspend() { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() {}
+  };
+};
+
+static Task measureForever(LIDARLite_v4LED &lidar, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+  {
+    LIDARLite_AsyncResult result = co_await loop.measure(lidar);
+    lastStatus = result.status;
+    calls++;
+  }
+}
+
+TEST(coroutine_nackLoopRunsFromService)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  resetLoop();
+  simAttach(sim);
+  lidar.begin();
+  sim.setPresent(false);
+
+  // Used to overflow the stack at about 2 million iterations: every failed
+  // trigger resumed the coroutine from inside the previous co_await
+  measureForever(lidar, 3000000);
+  CHECK_EQUAL(0, calls);
+  while (loop.getPending() > 0)
+    loop.service();
+
+  CHECK_EQUAL(3000000, calls);
+  CHECK_EQUAL(LIDARLITE_ASYNC_NACK, lastStatus);
+}
+#endif
@@ -0,0 +1,153 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_autopreset.cpp
+
+  The automatic preset ladder. Most tests feed distances to update() with a
+  spread chosen per preset, so each test controls exactly how noisy every
+  preset looks; the dropout test measures through the simulated sensor's
+  range model instead.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_AutoPreset.h"
+#include "HostTest.h"
+
+// Feed one window around distance whose mean absolute deviation is jitter
+static void feedWindow(LIDARLite_v4LED_AutoPreset &autoPreset, uint16_t distance, uint16_t jitter)
+{
+  for (uint8_t i = 0; i < LIDARLITE_AUTO_WINDOW; i++)
+    autoPreset.update((i & 1) ? distance + jitter : distance - jitter);
+}
+
+// The fastest preset is too noisy for the target, the next one is well within it
+static uint16_t jitterOf(uint8_t preset)
+{
+  return (preset == 5) ? 5 : 1;
+}
+
+TEST(accuracy_doesNotThrashBetweenPresets)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_v4LED_AutoPreset autoPreset;
+
+  simAttach(sim);
+  lidar.begin();
+  autoPreset.begin(lidar, 3);
+
+  // Walks down from the maximum range preset to preset 5 and back up to 2
+  uint8_t windows = 0;
+  while (windows < 20 && autoPreset.getPreset() != 5)
+  {
+    feedWindow(autoPreset, 50, jitterOf(autoPreset.getPreset()));
+    windows++;
+  }
+  CHECK_EQUAL(5, autoPreset.getPreset());
+  feedWindow(autoPreset, 50, jitterOf(5));
+  CHECK_EQUAL(2, autoPreset.getPreset());
+
+  // Held at 2 instead of switching every window
+  uint16_t switches = 0;
+  uint8_t preset = autoPreset.getPreset();
+  for (uint16_t i = 0; i < 4 * LIDARLITE_AUTO_HOLD_WINDOWS; i++)
+  {
+    feedWindow(autoPreset, 50, jitterOf(autoPreset.getPreset()));
+    if (autoPreset.getPreset() != preset)
+      switches++;
+    preset = autoPreset.getPreset();
+  }
+
+  // One try of preset 5 and the switch back per hold, at most
+  CHECK(switches <= 2 * 4);
+  CHECK_EQUAL(2, preset);
+}
+
+TEST(accuracy_retriesFasterPresetAfterHold)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_v4LED_AutoPreset autoPreset;
+
+  simAttach(sim);
+  lidar.begin();
+  autoPreset.begin(lidar, 3);
+
+  while (autoPreset.getPreset() != 5)
+    feedWindow(autoPreset, 50, jitterOf(autoPreset.getPreset()));
+  feedWindow(autoPreset, 50, jitterOf(5));
+  CHECK_EQUAL(2, autoPreset.getPreset());
+
+  // The target got quieter: preset 5 would now do, but only after the hold
+  for (uint8_t i = 0; i < LIDARLITE_AUTO_HOLD_WINDOWS - 1; i++)
+  {
+    feedWindow(autoPreset, 50, 1);
+    CHECK_EQUAL(2, autoPreset.getPreset());
+  }
+  feedWindow(autoPreset, 50, 1);
+  CHECK_EQUAL(5, autoPreset.getPreset());
+}
+
+TEST(rangeUp_ignoresHold)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_v4LED_AutoPreset autoPreset;
+
+  simAttach(sim);
+  lidar.begin();
+  autoPreset.begin(lidar, 3);
+
+  while (autoPreset.getPreset() != 5)
+    feedWindow(autoPreset, 50, jitterOf(autoPreset.getPreset()));
+  feedWindow(autoPreset, 50, jitterOf(5));
+  CHECK_EQUAL(2, autoPreset.getPreset());
+
+  // Target moves out of range of preset 2: range wins straight away
+  feedWindow(autoPreset, 800, 1);
+  CHECK_EQUAL(3, autoPreset.getPreset());
+  CHECK_EQUAL(0x80, sim.getRegister(0x05));
+  CHECK_EQUAL(0x00, sim.getRegister(0xE5));
+}
+
+TEST(rangeUp_dropoutsClimbBackToLongRangePreset)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_v4LED_AutoPreset autoPreset;
+  LIDARLite_PresetSwitch entry;
+
+  // Measured by the simulated sensor, whose range shrinks with the acquisition count
+  sim.setDistance(50);
+  sim.setNoise(0);
+  simAttach(sim);
+  lidar.begin();
+  autoPreset.begin(lidar, 3);
+
+  for (uint16_t i = 0; i < 20 * LIDARLITE_AUTO_WINDOW && autoPreset.getPreset() != 5; i++)
+    autoPreset.getDistance();
+  CHECK_EQUAL(5, autoPreset.getPreset());
+  while (autoPreset.readLog(entry))
+    ;
+
+  // Beyond the very short range preset, which now reads only dropouts
+  sim.setDistance(800);
+  uint16_t distance = 0;
+  for (uint16_t i = 0; i < 10 * LIDARLITE_AUTO_WINDOW && distance == 0; i++)
+    distance = autoPreset.getDistance();
+  CHECK_EQUAL(800, distance);
+  CHECK_EQUAL(0xFF, sim.getRegister(0x05));
+
+  // One step per window of dropouts, each logged as range up
+  uint8_t steps = 0;
+  while (autoPreset.readLog(entry))
+  {
+    CHECK_EQUAL(LIDARLITE_REASON_RANGE_UP, entry.reason);
+    CHECK_EQUAL(0, entry.median);
+    steps++;
+  }
+  CHECK(steps >= 2);
+}
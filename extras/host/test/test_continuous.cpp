@@ -0,0 +1,197 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_continuous.cpp
+
+  Free-running mode: the period measured from the device rather than trusted
+  from the register units, every measurement read exactly once, and
+  measurements the host was too slow for counted as missed.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "HostTest.h"
+
+// Call serviceContinuous() every stepUs for ms of simulated time, draining
+// the ring into block. Returns the number of samples collected
+static uint32_t run(LIDARLite_v4LED &lidar, uint32_t ms, uint32_t stepUs, LIDARLite_SampleBlock &block)
+{
+  uint32_t samples = 0;
+  uint64_t end = simNanos() + (uint64_t)ms * 1000000;
+
+  while (simNanos() < end)
+  {
+    samples += lidar.serviceContinuous();
+    if (block.count == LIDARLITE_BLOCK_SIZE)
+      block.count = 0;
+    lidar.readSamples(block);
+    delayMicroseconds(stepUs);
+  }
+  return samples;
+}
+
+static void begin(LIDARLite_v4LED &lidar, SimLidar &sim)
+{
+  sim.setNoise(0);
+  simAttach(sim);
+  lidar.begin();
+  lidar.configure(2);
+}
+
+TEST(startContinuous_measuresPeriodFromRegisterUnits)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim);
+  CHECK(lidar.startContinuous(20));
+  CHECK_EQUAL(20, sim.getRegister(0xE3));
+
+  // 20 counts of 1 ms, found to within a STATUS read at 100 kHz
+  CHECK(lidar.getSamplePeriod() > 19600);
+  CHECK(lidar.getSamplePeriod() < 20400);
+}
+
+TEST(startContinuous_measuresPeriodWhenUnitsDiffer)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  // Firmware counting 1.25 ms per count: 25 ms, not the 20 ms the units suggest
+  sim.setIntervalUnit(1250000);
+  begin(lidar, sim);
+  CHECK(lidar.startContinuous(20));
+  CHECK(lidar.getSamplePeriod() > 24600);
+  CHECK(lidar.getSamplePeriod() < 25400);
+}
+
+TEST(startContinuous_failsWhenDeviceDoesNotSelfTrigger)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  // Five times the nominal period: nothing starts within four
+  sim.setIntervalUnit(5000000);
+  begin(lidar, sim);
+  CHECK(!lidar.startContinuous(20));
+  CHECK_EQUAL(0, sim.getRegister(0xE3));
+}
+
+TEST(serviceContinuous_readsEveryMeasurementOnce)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  static LIDARLite_SampleBlock block;
+
+  sim.setIntervalUnit(1250000);
+  begin(lidar, sim);
+  CHECK(lidar.startContinuous(20));
+  uint32_t before = sim.getMeasurementCount();
+
+  // Serviced far more often than samples arrive: no duplicates, none missed
+  uint32_t samples = run(lidar, 2000, 100, block);
+  uint32_t measured = sim.getMeasurementCount() - before;
+
+  // The measurement in progress at the end has not been read yet
+  CHECK(samples == measured || samples + 1 == measured);
+  CHECK(samples >= 2000 / 25 - 1);
+  CHECK_EQUAL(0, lidar.getMissedCount());
+  CHECK_EQUAL(0, lidar.getOverrunCount());
+}
+
+TEST(serviceContinuous_twoStatusReadsAndOneDistanceReadPerSample)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  static LIDARLite_SampleBlock block;
+
+  begin(lidar, sim);
+  CHECK(lidar.startContinuous(20));
+  run(lidar, 100, 100, block);
+
+  simClearBusStats();
+  uint32_t samples = run(lidar, 1000, 100, block);
+  CHECK(samples >= 49);
+
+  // 2 transactions per read; allow an occasional extra STATUS read
+  uint32_t transactions = simGetBusStats().transactions;
+  CHECK(transactions >= samples * 6);
+  CHECK(transactions <= samples * 6 + samples / 2);
+}
+
+TEST(serviceContinuous_countsMeasurementsMissedWhileAway)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_Sample sample;
+
+  begin(lidar, sim);
+  CHECK(lidar.startContinuous(20));
+  while (lidar.serviceContinuous() == 0)
+    delayMicroseconds(100);
+  CHECK(lidar.readSample(sample));
+  uint16_t first = sample.sequence;
+
+  // Away for 5.5 periods: five measurements finish, only the newest can be read
+  uint32_t before = sim.getMeasurementCount();
+  delay(110);
+  while (lidar.serviceContinuous() == 0)
+    delayMicroseconds(100);
+  uint32_t finished = sim.getMeasurementCount() - before;
+  if (sim.isBusy())
+    finished--;
+
+  CHECK(lidar.readSample(sample));
+  CHECK_EQUAL(finished - 1, lidar.getMissedCount());
+  CHECK_EQUAL(first + finished, sample.sequence);
+
+  // Back on schedule afterwards
+  static LIDARLite_SampleBlock block;
+  run(lidar, 500, 100, block);
+  CHECK_EQUAL(finished - 1, lidar.getMissedCount());
+}
+
+TEST(serviceContinuous_flagsGapAfterMissedMeasurements)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  static LIDARLite_SampleBlock block;
+
+  begin(lidar, sim);
+  CHECK(lidar.startContinuous(20));
+  block.count = 0;
+  run(lidar, 100, 100, block);
+  uint16_t count = block.count;
+  CHECK(count >= 4);
+  for (uint16_t i = 1; i < count; i++)
+    CHECK_EQUAL(0, block.status[i]);
+
+  delay(70);
+  run(lidar, 50, 100, block);
+  CHECK(block.count > count);
+  CHECK_EQUAL(LIDARLITE_SAMPLE_GAP, block.status[count]);
+}
+
+TEST(serviceContinuous_timestampsFollowTheDevice)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_Sample sample;
+
+  begin(lidar, sim);
+  CHECK(lidar.startContinuous(20));
+  for (uint8_t i = 0; i < 20; i++)
+  {
+    while (lidar.serviceContinuous() == 0)
+      delayMicroseconds(100);
+    CHECK(lidar.readSample(sample));
+
+    // Middle of the acquisition the simulator ran, to within a STATUS read
+    uint64_t trigger = sim.getLastTriggerTime() / 1000;
+    uint64_t middle = trigger + sim.acquisitionTimeUs() / 2;
+    CHECK(sample.timestamp + 400 > middle);
+    CHECK(sample.timestamp < middle + 400);
+  }
+}
@@ -0,0 +1,137 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_correlation.cpp
+
+  Reading the correlation record: one 2 byte read of CORR_DATA per point, and
+  what happens when a read fails part way through.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "HostTest.h"
+
+static const int16_t UNTOUCHED = 0x5A5A;
+
+static void measure(LIDARLite_v4LED &lidar, SimLidar &sim, uint16_t distance)
+{
+  sim.setDistance(distance);
+  sim.setNoise(0);
+  simAttach(sim);
+  lidar.begin();
+  lidar.getDistance();
+}
+
+TEST(correlationRecordRead_readsEveryPointInOrder)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  int16_t record[192];
+
+  measure(lidar, sim, 300);
+
+  simClearBusStats();
+  CHECK(lidar.correlationRecordRead(record, 192));
+  CHECK_EQUAL(384, simGetBusStats().transactions);
+
+  // Zero crossing where the simulator put the target, well above the noise floor
+  int16_t crossing = (int16_t)SIM_CORR_POINT(300);
+  CHECK(record[crossing - 2] > 0);
+  CHECK(record[crossing + 2] < 0);
+  CHECK(record[crossing - 2] > record[0] + 1000);
+}
+
+TEST(correlationRecordRead_longerReadIsNotTheNextPoint)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  int16_t points[2];
+  int16_t nextPoint;
+
+  // Register pointer auto-increment: bytes 3 and 4 of a read of 0x52 come
+  // from 0x54 and 0x55, not from the next record point
+  measure(lidar, sim, 8);
+  CHECK(lidar.read(0x52, (uint8_t *)points, 4));
+  CHECK_EQUAL(sim.getRegister(0x54) | (sim.getRegister(0x55) << 8), (uint16_t)points[1]);
+
+  CHECK(lidar.correlationRecordRead(&nextPoint, 1));
+  CHECK(nextPoint != points[1]);
+}
+
+TEST(correlationRecordRead_failsWithoutSensor)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  int16_t record[4] = {UNTOUCHED, UNTOUCHED, UNTOUCHED, UNTOUCHED};
+
+  measure(lidar, sim, 300);
+  sim.setPresent(false);
+
+  CHECK(!lidar.correlationRecordRead(record, 4));
+  CHECK_EQUAL(UNTOUCHED, record[0]);
+}
+
+TEST(correlationRecordRead_stopsAtFailedRead)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  int16_t record[192];
+
+  measure(lidar, sim, 300);
+  for (uint8_t i = 0; i < 192; i++)
+    record[i] = UNTOUCHED;
+
+  // 10 points of 2 transactions each, then the sensor stops answering
+  sim.nackTransactions(1000, 20);
+  simClearBusStats();
+  CHECK(!lidar.correlationRecordRead(record, 192));
+
+  CHECK(record[9] != UNTOUCHED);
+  for (uint8_t i = 10; i < 192; i++)
+    CHECK_EQUAL(UNTOUCHED, record[i]);
+  // The failed point's address write and read, then no more
+  CHECK_EQUAL(22, simGetBusStats().transactions);
+}
+
+TEST(correlationRecordReadWindow_matchesFullRecord)
+{
+  SimLidar full;
+  SimLidar partial; // Same serial number, so the same record
+  LIDARLite_v4LED lidar;
+  int16_t record[192];
+  int16_t window[16];
+
+  measure(lidar, full, 300);
+  CHECK(lidar.correlationRecordRead(record, 192));
+
+  simReset();
+  measure(lidar, partial, 300);
+  simClearBusStats();
+  CHECK(lidar.correlationRecordReadWindow(window, 40, 16));
+  CHECK_EQUAL(2 * (40 + 16), simGetBusStats().transactions);
+  for (uint8_t i = 0; i < 16; i++)
+    CHECK_EQUAL(record[40 + i], window[i]);
+}
+
+TEST(correlationRecordReadWindow_reportsFailedRead)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  int16_t window[16];
+
+  measure(lidar, sim, 300);
+  CHECK(!lidar.correlationRecordReadWindow(window, 192, 16));
+
+  // Fails while skipping the points before the window
+  lidar.getDistance();
+  sim.nackTransactions(1000, 10);
+  CHECK(!lidar.correlationRecordReadWindow(window, 40, 16));
+
+  // And while reading the window itself
+  sim.nackTransactions(0);
+  lidar.getDistance();
+  sim.nackTransactions(1000, 2 * 40 + 10);
+  CHECK(!lidar.correlationRecordReadWindow(window, 40, 16));
+}
@@ -0,0 +1,163 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_faults.cpp
+
+  Fault injection for the scheduler: a sensor unplugged and plugged back in,
+  a sensor stuck busy, and a bus held low by a sensor, recovered with
+  LIDARLite_recoverBus() as Example 19 does.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_Scheduler.h"
+#include "HostTest.h"
+
+#define SECOND_ADDRESS 0x5B
+
+static bool recoverBus(void *context)
+{
+  (void)context;
+  Wire.end();
+  bool recovered = LIDARLite_recoverBus(PIN_WIRE_SDA, PIN_WIRE_SCL);
+  Wire.begin();
+  return recovered;
+}
+
+// Two sensors, the first moved to SECOND_ADDRESS in flash like Example 2 does
+struct Rig
+{
+  SimLidar sim1{0x11111111};
+  SimLidar sim2{0x22222222};
+  LIDARLite_v4LED lidar1;
+  LIDARLite_v4LED lidar2;
+  LIDARLite_v4LED_Scheduler scheduler;
+
+  Rig()
+  {
+    simAttach(sim1);
+    simAttach(sim2);
+    sim2.setPresent(false);
+    lidar1.begin();
+    lidar1.setI2Caddr(SECOND_ADDRESS);
+    sim2.setPresent(true);
+
+    CHECK(lidar1.begin(SECOND_ADDRESS));
+    CHECK(lidar2.begin());
+    lidar1.configure(2);
+    lidar2.configure(2);
+
+    scheduler.addSensor(lidar1);
+    scheduler.addSensor(lidar2);
+    scheduler.setFaultPolicy(3, 100000);
+    scheduler.setBusRecovery(recoverBus);
+    scheduler.start();
+  }
+
+  // Service for ms of simulated time
+  void run(uint32_t ms)
+  {
+    uint64_t end = simNanos() + (uint64_t)ms * 1000000;
+    while (simNanos() < end)
+    {
+      scheduler.service();
+      delayMicroseconds(100);
+    }
+  }
+};
+
+TEST(unplugged_quarantinedWhileOtherKeepsRate)
+{
+  Rig rig;
+
+  rig.run(100);
+  uint32_t before = rig.scheduler.getSampleCount(1);
+
+  rig.sim1.setPresent(false);
+  rig.run(100);
+  CHECK_EQUAL(LIDARLITE_HEALTH_QUARANTINED, rig.scheduler.getHealth(0));
+  CHECK_EQUAL(LIDARLITE_HEALTH_OK, rig.scheduler.getHealth(1));
+
+  // The healthy sensor's rate is unaffected
+  uint32_t during = rig.scheduler.getSampleCount(1) - before;
+  CHECK(during * 10 >= before * 9);
+}
+
+TEST(unplugged_probesBackOff)
+{
+  Rig rig;
+
+  rig.sim1.setPresent(false);
+  rig.run(50);
+  CHECK_EQUAL(LIDARLITE_HEALTH_QUARANTINED, rig.scheduler.getHealth(0));
+
+  // 10 ms, 20 ms, 40 ms ... up to 1 s: a handful of probes in 3 s, not one per cycle
+  rig.run(3000);
+  simClearBusStats();
+  rig.run(3000);
+  CHECK(simGetBusStats().nacks <= 4);
+}
+
+TEST(replugged_reattachesWithConfiguration)
+{
+  Rig rig;
+
+  rig.sim1.setPresent(false);
+  rig.run(100);
+  CHECK_EQUAL(LIDARLITE_HEALTH_QUARANTINED, rig.scheduler.getHealth(0));
+
+  // Back on its flash address, but with the register defaults
+  rig.sim1.powerCycle();
+  rig.sim1.setPresent(true);
+  CHECK_EQUAL(0xFF, rig.sim1.getRegister(0x05));
+
+  rig.run(1500);
+  CHECK_EQUAL(LIDARLITE_HEALTH_OK, rig.scheduler.getHealth(0));
+  CHECK_EQUAL(1, rig.scheduler.getReattachCount(0));
+  CHECK_EQUAL(0x18, rig.sim1.getRegister(0x05));
+  CHECK_EQUAL(0x00, rig.sim1.getRegister(0xE5));
+  CHECK(rig.scheduler.available(0));
+}
+
+TEST(hung_timesOutAndRecoversAfterPowerCycle)
+{
+  Rig rig;
+
+  // Three 100 ms timeouts. A hung sensor still acknowledges, so the probe
+  // takes it back out of quarantine until it times out again
+  rig.sim2.setHung(true);
+  uint64_t start = simNanos();
+  bool quarantined = false;
+  for (uint16_t ms = 0; ms < 400 && !quarantined; ms++)
+  {
+    rig.run(1);
+    quarantined = (rig.scheduler.getHealth(1) == LIDARLITE_HEALTH_QUARANTINED);
+  }
+  CHECK(quarantined);
+  CHECK(simNanos() - start > 300000000ULL);
+  CHECK_EQUAL(LIDARLITE_HEALTH_OK, rig.scheduler.getHealth(0));
+
+  rig.sim2.powerCycle();
+  rig.run(1500);
+  CHECK_EQUAL(LIDARLITE_HEALTH_OK, rig.scheduler.getHealth(1));
+  CHECK_EQUAL(0x18, rig.sim2.getRegister(0x05));
+}
+
+TEST(stuckBus_recoveredByClockingScl)
+{
+  Rig rig;
+
+  rig.run(50);
+
+  // A sensor reset mid-byte holds SDA for 5 more clocks: every transaction fails
+  simHoldSda(5);
+  rig.run(100);
+
+  CHECK(rig.scheduler.getBusRecoveryCount() >= 1);
+  rig.run(100);
+  CHECK_EQUAL(LIDARLITE_HEALTH_OK, rig.scheduler.getHealth(0));
+  CHECK_EQUAL(LIDARLITE_HEALTH_OK, rig.scheduler.getHealth(1));
+  CHECK_EQUAL(HIGH, digitalRead(PIN_WIRE_SDA));
+}
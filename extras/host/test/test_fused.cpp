@@ -0,0 +1,163 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_fused.cpp
+
+  readStatusDistance(), readTelemetry() and service() with fused reads
+  against the simulated register map: the same values as the separate reads,
+  in fewer transactions.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "HostTest.h"
+
+static void begin(LIDARLite_v4LED &lidar, SimLidar &sim)
+{
+  sim.setDistance(250);
+  sim.setNoise(0);
+  simAttach(sim);
+  lidar.begin();
+}
+
+TEST(readStatusDistance_busyUntilDistanceIsValid)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_Reading reading;
+
+  begin(lidar, sim);
+  lidar.takeRange();
+  CHECK(!lidar.readStatusDistance(reading));
+  CHECK(reading.busy);
+  CHECK_EQUAL(1, reading.status & 0x01);
+
+  delayMicroseconds(sim.acquisitionTimeUs());
+  simClearBusStats();
+  CHECK(lidar.readStatusDistance(reading));
+  CHECK(!reading.busy);
+  CHECK_EQUAL(250, reading.distance);
+  CHECK_EQUAL(sim.getRegister(0x01), reading.status);
+
+  // One register write and one 17 byte read
+  CHECK_EQUAL(2, simGetBusStats().transactions);
+  CHECK_EQUAL(2 + 18, simGetBusStats().bytes);
+
+  CHECK_EQUAL(lidar.readDistance(), reading.distance);
+}
+
+TEST(readStatusDistance_missingSensorReadsBusy)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_Reading reading;
+
+  begin(lidar, sim);
+  lidar.getDistance();
+  sim.setPresent(false);
+  CHECK(!lidar.readStatusDistance(reading));
+  CHECK(reading.busy);
+  CHECK_EQUAL(0, reading.distance);
+  CHECK(lidar.getLastError() != 0);
+}
+
+TEST(readStatusDistance_failedReadIsNotIdle)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_Reading reading;
+
+  // The register pointer is set, then the burst read is refused: nothing in the buffer says idle
+  begin(lidar, sim);
+  lidar.getDistance();
+  sim.nackTransactions(1, 1);
+  CHECK(!lidar.readStatusDistance(reading));
+  CHECK(reading.busy);
+  CHECK_EQUAL(0, reading.distance);
+
+  CHECK(lidar.readStatusDistance(reading));
+  CHECK_EQUAL(250, reading.distance);
+}
+
+TEST(readTelemetry_failedReadLeavesReadingUntouched)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_Reading reading;
+
+  begin(lidar, sim);
+  reading.boardTemp = 99;
+  reading.hardwareVersion = 0xAA;
+  reading.socTemp = 99;
+  sim.setPresent(false);
+  CHECK(!lidar.readTelemetry(reading));
+  CHECK_EQUAL(99, reading.boardTemp);
+  CHECK_EQUAL(0xAA, reading.hardwareVersion);
+  CHECK_EQUAL(99, reading.socTemp);
+  CHECK(lidar.getLastError() != 0);
+}
+
+TEST(readTelemetry_matchesSeparateReads)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_Reading reading;
+
+  begin(lidar, sim);
+  simClearBusStats();
+  CHECK(lidar.readTelemetry(reading));
+  CHECK_EQUAL(2, simGetBusStats().transactions);
+
+  CHECK_EQUAL((int8_t)lidar.getBoardTemp(), reading.boardTemp);
+  CHECK_EQUAL((int8_t)lidar.getSOCTemp(), reading.socTemp);
+  CHECK_EQUAL(sim.getRegister(0xE1), reading.hardwareVersion);
+  CHECK_EQUAL(2 + 4, simGetBusStats().transactions);
+}
+
+TEST(service_fusedReadsSaveTheDistanceRead)
+{
+  SimLidar sim;
+  LIDARLite_v4LED separate;
+  LIDARLite_v4LED fused;
+
+  begin(separate, sim);
+  fused.begin();
+  fused.enableFusedReads(true);
+
+  // Two transactions per poll; the separate reads add the distance read after the last one
+  LIDARLite_v4LED *lidars[2] = {&separate, &fused};
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    uint32_t polls = 1;
+
+    lidars[i]->startMeasurement();
+    simClearBusStats();
+    while (lidars[i]->service() == LIDARLITE_STATE_BUSY)
+    {
+      delayMicroseconds(500);
+      polls++;
+    }
+    CHECK(polls > 1);
+    CHECK_EQUAL(2 * polls + ((i == 0) ? 2 : 0), simGetBusStats().transactions);
+    CHECK_EQUAL(250, lidars[i]->fetch());
+  }
+  CHECK_EQUAL(2, sim.getMeasurementCount());
+}
+
+TEST(service_fusedReadsSensorLostGoesIdle)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim);
+  lidar.enableFusedReads(true);
+  lidar.startMeasurement();
+  CHECK_EQUAL(LIDARLITE_STATE_BUSY, lidar.service());
+
+  sim.setPresent(false);
+  delayMicroseconds(sim.acquisitionTimeUs());
+  CHECK_EQUAL(LIDARLITE_STATE_IDLE, lidar.service());
+  CHECK(!lidar.measurementReady());
+}
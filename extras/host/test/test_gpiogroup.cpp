@@ -0,0 +1,177 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_gpiogroup.cpp
+
+  LIDARLite_v4LED_GpioGroup on simulated sensors wired to their own trigger
+  and monitor pins: the skew between the pin flips and the acknowledgements,
+  the trigger, acknowledge and completion sequence, and samples stamped from
+  the group trigger rather than from each sensor's last takeRange().
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_GpioGroup.h"
+#include "HostTest.h"
+
+#define GROUP_SENSORS 4
+#define TRIGGER_PIN(i) (20 + 2 * (i))
+#define MONITOR_PIN(i) (21 + 2 * (i))
+
+struct Rig
+{
+  SimLidar sims[GROUP_SENSORS] = {0xE0000000, 0xE0000001, 0xE0000002, 0xE0000003};
+  LIDARLite_v4LED lidars[GROUP_SENSORS];
+  LIDARLite_v4LED_GpioGroup group;
+
+  // Sensors moved to 0x30 + i, each on its own pin pair, at 100 + 20 * i cm
+  bool begin()
+  {
+    LIDARLite_AddressAssignment table[GROUP_SENSORS];
+    LIDARLite_v4LED shared;
+
+    Wire.setClock(400000);
+    for (uint8_t i = 0; i < GROUP_SENSORS; i++)
+    {
+      sims[i].setDistance(100 + 20 * i);
+      sims[i].setNoise(0);
+      sims[i].attachPins(TRIGGER_PIN(i), MONITOR_PIN(i));
+      simAttach(sims[i]);
+      for (uint8_t j = 0; j < 4; j++)
+        table[i].unitId[j] = sims[i].getRegister(0x16 + j);
+      table[i].address = 0x30 + i;
+    }
+    shared.begin();
+    if (shared.provisionAddresses(table, GROUP_SENSORS) != GROUP_SENSORS)
+      return false;
+    for (uint8_t i = 0; i < GROUP_SENSORS; i++)
+    {
+      lidars[i].begin(0x30 + i);
+      if (!group.addSensor(lidars[i], TRIGGER_PIN(i), MONITOR_PIN(i)))
+        return false;
+    }
+    return true;
+  }
+};
+
+TEST(gpioGroup_triggersTogether)
+{
+  Rig rig;
+
+  CHECK(rig.begin());
+  CHECK_EQUAL(GROUP_SENSORS, rig.group.getNumSensors());
+
+  uint64_t start = simNanos();
+  CHECK(rig.group.trigger());
+
+  // One digitalRead() and digitalWrite() per pin flip, nothing in between
+  uint64_t first = rig.sims[0].getLastTriggerTime();
+  uint64_t last = first;
+  for (uint8_t i = 0; i < GROUP_SENSORS; i++)
+  {
+    CHECK(rig.sims[i].isBusy());
+    CHECK(rig.sims[i].getLastTriggerTime() >= start);
+    if (rig.sims[i].getLastTriggerTime() < first)
+      first = rig.sims[i].getLastTriggerTime();
+    if (rig.sims[i].getLastTriggerTime() > last)
+      last = rig.sims[i].getLastTriggerTime();
+  }
+  CHECK(last - first <= (GROUP_SENSORS - 1) * SIM_GPIO_READ_NS);
+
+  // Every acknowledgement after the sensor's latency, seen within one poll pass of each other
+  for (uint8_t i = 0; i < GROUP_SENSORS; i++)
+    CHECK(rig.group.getAckTime(i) * 1000UL + 1000 >= SIM_TRIGGER_LATENCY_NS);
+  CHECK(rig.group.getTriggerSkew() <= (2 * GROUP_SENSORS * SIM_GPIO_READ_NS) / 1000 + 1);
+
+  // Nothing finished yet
+  for (uint8_t i = 0; i < GROUP_SENSORS; i++)
+  {
+    CHECK_EQUAL(0, rig.group.getDistance(i));
+    CHECK_EQUAL(0, rig.group.getCompletionTime(i));
+  }
+  CHECK(rig.group.wait());
+}
+
+TEST(gpioGroup_scanReadsEverySensorAsItFinishes)
+{
+  Rig rig;
+
+  CHECK(rig.begin());
+  simClearBusStats();
+  CHECK(rig.group.scan());
+
+  // No I2C until the first sensor finishes, then one distance read each
+  uint32_t acquisitionUs = rig.sims[0].acquisitionTimeUs();
+  for (uint8_t i = 0; i < GROUP_SENSORS; i++)
+  {
+    CHECK_EQUAL(100 + 20 * i, rig.group.getDistance(i));
+    CHECK(rig.group.getCompletionTime(i) >= acquisitionUs);
+    CHECK(rig.group.getCompletionTime(i) <= acquisitionUs + GROUP_SENSORS * 200);
+    CHECK(!rig.sims[i].isBusy());
+  }
+  CHECK_EQUAL(2 * GROUP_SENSORS, simGetBusStats().transactions);
+
+  // A second scan starts over
+  rig.sims[2].setDistance(300);
+  CHECK(rig.group.scan());
+  CHECK_EQUAL(300, rig.group.getDistance(2));
+  CHECK_EQUAL(2, rig.sims[2].getMeasurementCount());
+}
+
+TEST(gpioGroup_samplesAreStampedFromTheGroupTrigger)
+{
+  Rig rig;
+  LIDARLite_Sample sample;
+
+  CHECK(rig.begin());
+
+  // An earlier takeRange() on one sensor must not leak into the group's timestamps
+  rig.lidars[1].takeRange();
+  rig.lidars[1].waitForBusy();
+  delay(50);
+
+  unsigned long triggerTime = micros();
+  CHECK(rig.group.scan());
+  uint32_t acquisitionUs = rig.sims[0].acquisitionTimeUs();
+
+  for (uint8_t i = 0; i < GROUP_SENSORS; i++)
+  {
+    CHECK(rig.group.getSample(i, sample));
+    CHECK_EQUAL(100 + 20 * i, sample.distance);
+    CHECK(sample.duration >= acquisitionUs - 100);
+    CHECK(sample.duration <= rig.group.getCompletionTime(i));
+    CHECK(sample.timestamp - triggerTime <= 1 + sample.duration / 2);
+    CHECK(sample.timestamp - triggerTime + 1 >= sample.duration / 2);
+  }
+
+  // readDistance(sample) after the scan carries the same stamps
+  CHECK_EQUAL(120, rig.lidars[1].readDistance(sample));
+  CHECK(sample.duration >= acquisitionUs - 100);
+  CHECK(sample.duration <= rig.group.getCompletionTime(1));
+  CHECK(sample.timestamp - triggerTime <= 1 + sample.duration / 2);
+}
+
+TEST(gpioGroup_silentSensorTimesOut)
+{
+  Rig rig;
+  LIDARLite_v4LED missing;
+  LIDARLite_Sample sample;
+
+  CHECK(rig.begin());
+
+  // A pin pair with no sensor behind it never acknowledges
+  missing.begin(0x50);
+  CHECK(rig.group.addSensor(missing, 60, 61));
+  CHECK(!rig.group.trigger(200));
+  CHECK_EQUAL(0, rig.group.getAckTime(GROUP_SENSORS));
+
+  // The others are still read, but the scan reports the failure
+  CHECK(!rig.group.wait());
+  for (uint8_t i = 0; i < GROUP_SENSORS; i++)
+    CHECK_EQUAL(100 + 20 * i, rig.group.getDistance(i));
+  CHECK_EQUAL(0, rig.group.getDistance(GROUP_SENSORS));
+  CHECK(!rig.group.getSample(GROUP_SENSORS, sample));
+  CHECK(!rig.group.scan());
+}
@@ -0,0 +1,204 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_interrupt.cpp
+
+  Interrupt mode against a simulated monitor pin: the falling edge at the end
+  of the simulated acquisition runs the ISR through attachInterrupt(), only
+  the latest completion is kept, as the sensor only keeps the latest
+  distance, and nothing touches the bus or the pins while a measurement runs.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "HostTest.h"
+
+#define TRIGGER_PIN 2
+#define MONITOR_PIN 3
+
+// Detaches on the way out, even when a CHECK ends the test, so the
+// interrupt slots are free for the next one
+struct InterruptLidar : LIDARLite_v4LED
+{
+  ~InterruptLidar() { endInterrupt(); }
+};
+
+static void begin(InterruptLidar &lidar, SimLidar &sim, uint8_t triggerPin, uint8_t monitorPin)
+{
+  sim.setDistance(250);
+  sim.setNoise(0);
+  sim.attachPins(triggerPin, monitorPin);
+  simAttach(sim);
+  pinMode(triggerPin, OUTPUT);
+  pinMode(monitorPin, INPUT);
+  lidar.begin();
+}
+
+TEST(takeRangeInterrupt_queuesSimulatedCompletion)
+{
+  SimLidar sim;
+  InterruptLidar lidar;
+  LIDARLite_Sample sample;
+
+  begin(lidar, sim, TRIGGER_PIN, MONITOR_PIN);
+  CHECK(lidar.beginInterrupt(TRIGGER_PIN, MONITOR_PIN));
+
+  lidar.takeRangeInterrupt();
+  CHECK(!lidar.interruptSampleAvailable());
+  CHECK(!lidar.readInterruptSample(sample));
+
+  // Queued by the ISR the moment the simulated acquisition ends
+  delayMicroseconds(sim.acquisitionTimeUs() - 10);
+  CHECK(!lidar.interruptSampleAvailable());
+  delayMicroseconds(20);
+  CHECK(lidar.interruptSampleAvailable());
+
+  CHECK(lidar.readInterruptSample(sample));
+  CHECK_EQUAL(250, sample.distance);
+  CHECK(!lidar.interruptSampleAvailable());
+
+  // Completion taken by the ISR, not estimated from polls
+  uint32_t acquisition = sim.acquisitionTimeUs() + SIM_TRIGGER_LATENCY_NS / 1000;
+  CHECK(sample.duration >= acquisition - 1);
+  CHECK(sample.duration <= acquisition + 1);
+  CHECK(sample.timestamp + 2 >= sim.getLastTriggerTime() / 1000 + sim.acquisitionTimeUs() / 2);
+}
+
+TEST(takeRangeInterrupt_nothingRunsWhileAcquiring)
+{
+  SimLidar sim;
+  InterruptLidar lidar;
+  LIDARLite_Sample sample;
+
+  begin(lidar, sim, TRIGGER_PIN, MONITOR_PIN);
+  lidar.beginInterrupt(TRIGGER_PIN, MONITOR_PIN);
+  simClearBusStats();
+
+  // One digitalRead() to toggle the pin, no wait for the acknowledge
+  uint64_t start = simNanos();
+  lidar.takeRangeInterrupt();
+  CHECK_EQUAL(SIM_GPIO_READ_NS, simNanos() - start);
+  CHECK(!sim.isBusy());
+
+  // The whole acquisition passes without the library running at all
+  delayMicroseconds(sim.acquisitionTimeUs() + 100);
+  CHECK_EQUAL(0, simGetBusStats().transactions);
+
+  // Only the distance read, no STATUS polls
+  CHECK(lidar.readInterruptSample(sample));
+  CHECK_EQUAL(2, simGetBusStats().transactions);
+  CHECK_EQUAL(1, sim.getMeasurementCount());
+}
+
+TEST(isrCompletion_latestReplacesUnread)
+{
+  SimLidar sim;
+  InterruptLidar lidar;
+  LIDARLite_Sample sample;
+
+  begin(lidar, sim, TRIGGER_PIN, MONITOR_PIN);
+  lidar.beginInterrupt(TRIGGER_PIN, MONITOR_PIN);
+
+  // Three measurements, none read: the sensor now only holds the third distance
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    sim.setDistance(200 + 50 * i);
+    lidar.takeRangeInterrupt();
+    delayMicroseconds(sim.acquisitionTimeUs() + 100);
+  }
+  CHECK_EQUAL(2, lidar.getInterruptDroppedCount());
+
+  // One sample, the third, stamped with the third trigger
+  uint32_t acquisition = sim.acquisitionTimeUs() + SIM_TRIGGER_LATENCY_NS / 1000;
+  CHECK(lidar.readInterruptSample(sample));
+  CHECK_EQUAL(300, sample.distance);
+  CHECK(sample.duration >= acquisition - 1);
+  CHECK(sample.duration <= acquisition + 1);
+  CHECK(!lidar.readInterruptSample(sample));
+
+  // Read in time, nothing more is dropped
+  lidar.takeRangeInterrupt();
+  delayMicroseconds(sim.acquisitionTimeUs() + 100);
+  CHECK(lidar.readInterruptSample(sample));
+  CHECK_EQUAL(2, lidar.getInterruptDroppedCount());
+
+  // beginInterrupt() starts the count over
+  lidar.beginInterrupt(TRIGGER_PIN, MONITOR_PIN);
+  CHECK_EQUAL(0, lidar.getInterruptDroppedCount());
+}
+
+TEST(isrCompletion_completionDuringReadIsKept)
+{
+  SimLidar sim;
+  InterruptLidar lidar;
+  LIDARLite_Sample sample;
+
+  begin(lidar, sim, TRIGGER_PIN, MONITOR_PIN);
+  lidar.beginInterrupt(TRIGGER_PIN, MONITOR_PIN);
+  lidar.takeRangeInterrupt();
+  delayMicroseconds(sim.acquisitionTimeUs() + 100);
+
+  // The next measurement ends 200 us into the distance read of this one,
+  // so the ISR records it after readInterruptSample() took this one
+  lidar.takeRangeInterrupt();
+  delayMicroseconds(sim.acquisitionTimeUs() - 200);
+  uint64_t start = simNanos();
+  CHECK(lidar.readInterruptSample(sample));
+  CHECK(simNanos() - start > 200000 + SIM_TRIGGER_LATENCY_NS);
+
+  CHECK(lidar.interruptSampleAvailable());
+  CHECK(lidar.readInterruptSample(sample));
+  CHECK(!lidar.readInterruptSample(sample));
+  CHECK_EQUAL(0, lidar.getInterruptDroppedCount());
+}
+
+TEST(isrCompletion_edgeWhileInterruptsOffIsKeptOnce)
+{
+  SimLidar sim;
+  InterruptLidar lidar;
+  LIDARLite_Sample sample;
+
+  begin(lidar, sim, TRIGGER_PIN, MONITOR_PIN);
+  lidar.beginInterrupt(TRIGGER_PIN, MONITOR_PIN);
+  lidar.takeRangeInterrupt();
+
+  noInterrupts();
+  delayMicroseconds(sim.acquisitionTimeUs() + 100);
+  CHECK(!lidar.interruptSampleAvailable());
+  interrupts();
+
+  CHECK(lidar.readInterruptSample(sample));
+  CHECK(!lidar.readInterruptSample(sample));
+}
+
+TEST(beginInterrupt_oneQueuePerSensor)
+{
+  SimLidar sims[LIDARLITE_MAX_INTERRUPT_SENSORS + 1];
+  InterruptLidar lidars[LIDARLITE_MAX_INTERRUPT_SENSORS + 1];
+  LIDARLite_Sample sample;
+
+  // Each sensor on its own pair of pins, all answering 0x62; only the pins matter here
+  for (uint8_t i = 0; i < LIDARLITE_MAX_INTERRUPT_SENSORS + 1; i++)
+    begin(lidars[i], sims[i], 10 + 2 * i, 11 + 2 * i);
+  for (uint8_t i = 0; i < LIDARLITE_MAX_INTERRUPT_SENSORS; i++)
+    CHECK(lidars[i].beginInterrupt(10 + 2 * i, 11 + 2 * i));
+
+  // Every trampoline is taken
+  uint8_t last = LIDARLITE_MAX_INTERRUPT_SENSORS;
+  CHECK(!lidars[last].beginInterrupt(10 + 2 * last, 11 + 2 * last));
+
+  // Only the sensor that was triggered has a completion
+  lidars[2].takeRangeInterrupt();
+  delayMicroseconds(sims[2].acquisitionTimeUs() + 100);
+  for (uint8_t i = 0; i < LIDARLITE_MAX_INTERRUPT_SENSORS; i++)
+    CHECK_EQUAL(i == 2, lidars[i].interruptSampleAvailable());
+
+  // A freed slot can be reused
+  lidars[0].endInterrupt();
+  CHECK(lidars[last].beginInterrupt(10 + 2 * last, 11 + 2 * last));
+  lidars[last].takeRangeInterrupt();
+  delayMicroseconds(sims[last].acquisitionTimeUs() + 100);
+  CHECK(lidars[last].readInterruptSample(sample));
+}
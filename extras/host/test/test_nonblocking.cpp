@@ -0,0 +1,205 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_nonblocking.cpp
+
+  The startMeasurement() / service() / fetch() state machine against the
+  simulated busy time: READY no earlier than the acquisition allows, one
+  STATUS read per service() call while busy, and no bus traffic at all
+  while the caller is doing something else.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "HostTest.h"
+
+static void begin(LIDARLite_v4LED &lidar, SimLidar &sim, uint8_t preset)
+{
+  sim.setDistance(250);
+  sim.setMaxRange(4000); // In range of every preset
+  sim.setNoise(0);
+  simAttach(sim);
+  lidar.begin();
+  lidar.configure(preset);
+}
+
+// Call service() every stepUs until it leaves BUSY. Returns the microseconds taken
+static uint32_t serviceUntilDone(LIDARLite_v4LED &lidar, uint32_t stepUs)
+{
+  uint64_t start = simNanos();
+
+  while (lidar.service() == LIDARLITE_STATE_BUSY)
+    delayMicroseconds(stepUs);
+  return (simNanos() - start) / 1000;
+}
+
+TEST(service_readyAfterSimulatedBusyTime)
+{
+  static const uint8_t presets[4] = {0, 2, 4, 5};
+
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    SimLidar sim;
+    LIDARLite_v4LED lidar;
+
+    simReset();
+    begin(lidar, sim, presets[i]);
+    uint32_t acquisition = sim.acquisitionTimeUs();
+
+    uint64_t start = simNanos();
+    CHECK(lidar.startMeasurement());
+    CHECK_EQUAL(LIDARLITE_STATE_BUSY, lidar.getMeasurementState());
+    serviceUntilDone(lidar, 50);
+    uint32_t elapsed = (simNanos() - start) / 1000;
+
+    // Not before the device finished, and within the trigger, one poll and the distance read of it
+    CHECK_EQUAL(LIDARLITE_STATE_READY, lidar.getMeasurementState());
+    CHECK(elapsed >= acquisition);
+    CHECK(elapsed < acquisition + 1500);
+    CHECK_EQUAL(250, lidar.fetch());
+    CHECK_EQUAL(LIDARLITE_STATE_IDLE, lidar.getMeasurementState());
+    CHECK_EQUAL(1, sim.getMeasurementCount());
+  }
+}
+
+TEST(service_oneStatusReadPerCallWhileBusy)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim, 0);
+  lidar.startMeasurement();
+
+  uint32_t busyCalls = 0;
+  while (1)
+  {
+    simClearBusStats();
+    uint8_t state = lidar.service();
+    if (state != LIDARLITE_STATE_BUSY)
+    {
+      // The last STATUS read and the distance read
+      CHECK_EQUAL(LIDARLITE_STATE_READY, state);
+      CHECK_EQUAL(4, simGetBusStats().transactions);
+      break;
+    }
+    CHECK_EQUAL(2, simGetBusStats().transactions);
+    busyCalls++;
+    delayMicroseconds(100);
+  }
+  CHECK(busyCalls > 0);
+
+  // READY and IDLE do not touch the bus
+  simClearBusStats();
+  CHECK(lidar.measurementReady());
+  CHECK_EQUAL(LIDARLITE_STATE_READY, lidar.service());
+  lidar.fetch();
+  CHECK_EQUAL(LIDARLITE_STATE_IDLE, lidar.service());
+  CHECK_EQUAL(0, simGetBusStats().transactions);
+}
+
+TEST(startMeasurement_busIsFreeWhileAcquiring)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim, 0);
+  simClearBusStats();
+  CHECK(lidar.startMeasurement());
+  CHECK_EQUAL(1, simGetBusStats().transactions);
+
+  // Other work for the whole acquisition: nothing on the bus
+  delayMicroseconds(sim.acquisitionTimeUs() + 100);
+  CHECK_EQUAL(1, simGetBusStats().transactions);
+  CHECK(!lidar.measurementReady());
+
+  // One call collects it
+  CHECK_EQUAL(LIDARLITE_STATE_READY, lidar.service());
+  CHECK_EQUAL(1 + 4, simGetBusStats().transactions);
+  CHECK_EQUAL(250, lidar.fetch());
+}
+
+TEST(startMeasurement_fewerPollsThanBlockingWait)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim, 0);
+  simClearBusStats();
+  lidar.getDistance();
+  uint32_t blocking = simGetBusStats().transactions;
+
+  // Serviced once per millisecond from a main loop
+  simClearBusStats();
+  lidar.startMeasurement();
+  serviceUntilDone(lidar, 1000);
+  lidar.fetch();
+  uint32_t serviced = simGetBusStats().transactions;
+
+  CHECK(serviced < blocking);
+}
+
+TEST(startMeasurement_notAcknowledgedStaysIdle)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim, 0);
+  sim.setPresent(false);
+  CHECK(!lidar.startMeasurement());
+  CHECK_EQUAL(LIDARLITE_STATE_IDLE, lidar.getMeasurementState());
+  CHECK_EQUAL(0, sim.getMeasurementCount());
+}
+
+TEST(service_sensorLostWhileBusyGoesIdle)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim, 0);
+  lidar.startMeasurement();
+  CHECK_EQUAL(LIDARLITE_STATE_BUSY, lidar.service());
+
+  sim.setPresent(false);
+  delayMicroseconds(sim.acquisitionTimeUs());
+  CHECK_EQUAL(LIDARLITE_STATE_IDLE, lidar.service());
+  CHECK(!lidar.measurementReady());
+}
+
+TEST(startMeasurement_discardsPendingResult)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim, 0);
+  lidar.startMeasurement();
+  serviceUntilDone(lidar, 100);
+  CHECK(lidar.measurementReady());
+
+  sim.setDistance(275);
+  CHECK(lidar.startMeasurement());
+  CHECK_EQUAL(LIDARLITE_STATE_BUSY, lidar.getMeasurementState());
+  serviceUntilDone(lidar, 100);
+  CHECK_EQUAL(275, lidar.fetch());
+  CHECK_EQUAL(2, sim.getMeasurementCount());
+}
+
+TEST(fetch_stampsMiddleOfSimulatedAcquisition)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_Sample sample;
+
+  begin(lidar, sim, 2);
+  lidar.startMeasurement();
+  serviceUntilDone(lidar, 50);
+  CHECK_EQUAL(250, lidar.fetch(sample));
+
+  // Trigger taken before the write, completion between the last two polls
+  uint64_t middle = sim.getLastTriggerTime() / 1000 + sim.acquisitionTimeUs() / 2;
+  CHECK(sample.timestamp + 500 > middle);
+  CHECK(sample.timestamp < middle + 500);
+  CHECK(sample.duration >= sim.acquisitionTimeUs());
+  CHECK(sample.duration < sim.acquisitionTimeUs() + 1000);
+}
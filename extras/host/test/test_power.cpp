@@ -0,0 +1,102 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_power.cpp
+
+  LIDARLite_v4LED_PowerScheduler's mode decisions when asynchronous mode
+  cannot keep the sample period or the sensor refuses a write or a trigger.
+  bench_power covers the latency and duty cycle it settles on.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_Power.h"
+#include "HostTest.h"
+
+// Service every 100 us until count samples are ready. Returns how many of them left the sensor in asynchronous mode
+static uint32_t runSamples(LIDARLite_v4LED_PowerScheduler &scheduler, uint32_t count)
+{
+  uint32_t async = 0;
+
+  while (count > 0)
+  {
+    if (scheduler.service())
+    {
+      async += scheduler.isAsync() ? 1 : 0;
+      count--;
+    }
+    delayMicroseconds(100);
+  }
+  return async;
+}
+
+TEST(async_leftWhenItCannotKeepThePeriod)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_v4LED_PowerScheduler scheduler;
+
+  simAttach(sim);
+  lidar.begin();
+
+  // A generous budget, but a woken acquisition takes longer than the period
+  uint32_t period = sim.acquisitionTimeUs() + SIM_WAKE_US / 2;
+  CHECK(scheduler.begin(lidar, period, 10 * period));
+
+  // Tried once, then never again: the measured latency does not fit
+  CHECK_EQUAL(1, runSamples(scheduler, 4 * LIDARLITE_POWER_REPROBE_SAMPLES));
+  CHECK(!scheduler.isAsync());
+  CHECK_EQUAL(0xFF, sim.getRegister(0xE2));
+}
+
+TEST(setAsync_refusedWriteKeepsAlwaysOn)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_v4LED_PowerScheduler scheduler;
+
+  simAttach(sim);
+  lidar.begin();
+  CHECK(scheduler.begin(lidar, 20000, 20000));
+
+  // The first probe's POWER_MODE write is refused
+  sim.nackWrites(0xE2, 1);
+  CHECK_EQUAL(0, runSamples(scheduler, LIDARLITE_POWER_REPROBE_SAMPLES));
+  CHECK_EQUAL(0xFF, sim.getRegister(0xE2));
+
+  // The next probe gets through
+  runSamples(scheduler, LIDARLITE_POWER_REPROBE_SAMPLES);
+  CHECK(scheduler.isAsync());
+  CHECK_EQUAL(0x00, sim.getRegister(0xE2));
+}
+
+TEST(service_failedTriggerSkipsOnePeriod)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  LIDARLite_v4LED_PowerScheduler scheduler;
+
+  simAttach(sim);
+  lidar.begin();
+  CHECK(scheduler.begin(lidar, 10000, 20000));
+  runSamples(scheduler, 1);
+
+  // Ten periods with the sensor gone: one refused trigger each and nothing else on the bus
+  sim.setPresent(false);
+  simClearBusStats();
+  uint64_t end = simNanos() + 10 * 10000 * 1000ULL;
+  while (simNanos() < end)
+  {
+    CHECK(!scheduler.service());
+    delayMicroseconds(100);
+  }
+  CHECK(scheduler.getFailedTriggerCount() >= 9);
+  CHECK(scheduler.getFailedTriggerCount() <= 10);
+  CHECK_EQUAL(scheduler.getFailedTriggerCount(), simGetBusStats().transactions);
+
+  // Sampling resumes when the sensor answers again
+  sim.setPresent(true);
+  runSamples(scheduler, 2);
+}
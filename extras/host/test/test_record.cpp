@@ -0,0 +1,225 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_record.cpp
+
+  Recording to a Print that runs out of room, and replaying what it kept.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "LIDARLite_v4LED_Record.h"
+#include "HostTest.h"
+
+// Buffer with a fixed capacity. reportRoom makes it answer availableForWrite()
+// the way HardwareSerial does; without it, it answers 0 like Print and
+// accepts what fits when written, the way a full SD card or USB port does.
+class LimitedPrint : public Print
+{
+public:
+  uint8_t data[4096];
+  size_t length = 0;
+  size_t capacity = sizeof(data);
+  uint32_t writes = 0;
+  size_t writeEnds[512]; //length after each write
+  bool reportRoom = false;
+
+  size_t write(uint8_t value) { return write(&value, 1); }
+  size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t accepted = (capacity - length < size) ? capacity - length : size;
+    memcpy(&data[length], buffer, accepted);
+    length += accepted;
+    if (writes < 512)
+      writeEnds[writes] = length;
+    writes++;
+    return accepted;
+  }
+  int availableForWrite() { return reportRoom ? (int)(capacity - length) : 0; }
+};
+
+// Length of the record at data, following the format in LIDARLite_v4LED_Record.h. 0 if truncated
+static size_t recordLength(const uint8_t *data, size_t available)
+{
+  size_t length = 1;
+
+  while (length < available && (data[length] & 0x80))
+    length++;
+  length += 2; // Last time byte, address
+  if (length > available)
+    return 0;
+
+  switch (data[0])
+  {
+  case LIDARLITE_RECORD_PING:
+    length += 1;
+    break;
+  case LIDARLITE_RECORD_WRITE:
+  case LIDARLITE_RECORD_READ:
+    if (length + 3 > available)
+      return 0;
+    length += 3 + ((data[0] == LIDARLITE_RECORD_WRITE || data[length + 1] == 0) ? data[length + 2] : 0);
+    break;
+  case LIDARLITE_RECORD_SAMPLE:
+    length += 2;
+    break;
+  }
+  return (length > available) ? 0 : length;
+}
+
+// After the 4 byte header, every record is written by one write() of its
+// fixed fields followed, if it has data bytes, by one write() of those, and
+// no write() runs across a record boundary. A write() that added nothing
+// because out was exactly full is skipped.
+static void checkWholeRecords(const LimitedPrint &out)
+{
+  size_t position = 4;
+  size_t previousEnd = 4;
+  uint8_t writesInRecord = 0;
+
+  CHECK(out.writes <= 512);
+  CHECK_EQUAL(4, out.writeEnds[0]);
+  for (uint32_t i = 1; i < out.writes; i++)
+  {
+    if (out.writeEnds[i] == previousEnd)
+      continue;
+    previousEnd = out.writeEnds[i];
+    size_t length = recordLength(&out.data[position], out.length - position);
+    CHECK(length != 0);
+    CHECK(out.writeEnds[i] <= position + length);
+    writesInRecord++;
+    CHECK(writesInRecord <= 2);
+    if (out.writeEnds[i] == position + length)
+    {
+      position += length;
+      writesInRecord = 0;
+    }
+  }
+  CHECK_EQUAL(out.length, position);
+}
+
+typedef LIDARLite_v4LED_T<LIDARLite_RecordingTransport<> > RecordingLidar;
+typedef LIDARLite_v4LED_T<LIDARLite_ReplayTransport> ReplayLidar;
+
+// Record begin() and count getDistance() calls into out. Returns the distances
+static void recordSession(LimitedPrint &out, LIDARLite_Recorder &recorder, uint16_t *distances, uint8_t count)
+{
+  SimLidar sim;
+  RecordingLidar lidar;
+
+  sim.setDistance(321);
+  simAttach(sim);
+  CHECK(recorder.begin(out));
+  lidar.getTransport().setRecorder(&recorder);
+  lidar.begin();
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    distances[i] = lidar.getDistance();
+    recorder.recordSample(LIDARLITE_ADDR_DEFAULT, distances[i]);
+  }
+}
+
+TEST(record_atMostTwoWritesPerRecord)
+{
+  LimitedPrint out;
+  LIDARLite_Recorder recorder;
+  uint16_t distances[4];
+
+  recordSession(out, recorder, distances, 4);
+
+  // Header, ping, then for each sample: trigger write, STATUS polls, distance read, sample.
+  // The trigger write, and each read, also write their data bytes
+  CHECK_EQUAL(0, recorder.getDroppedRecords());
+  CHECK(out.writes >= 1 + 1 + 4 * (4 + 2));
+  CHECK_EQUAL(out.length, recorder.getBytesWritten());
+  checkWholeRecords(out);
+}
+
+TEST(record_replayMatchesRecording)
+{
+  LimitedPrint out;
+  LIDARLite_Recorder recorder;
+  uint16_t distances[4];
+
+  recordSession(out, recorder, distances, 4);
+
+  simReset();
+  LIDARLite_Recording recording = {out.data, (uint32_t)out.length};
+  ReplayLidar replay;
+  CHECK(replay.begin(LIDARLITE_ADDR_DEFAULT, recording));
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    uint16_t distance = replay.getDistance();
+    CHECK_EQUAL(distances[i], distance);
+    CHECK(replay.getTransport().verifySample(distance));
+  }
+  CHECK_EQUAL(0, replay.getTransport().getMismatches());
+  CHECK(replay.getTransport().atEnd());
+}
+
+TEST(record_reportedRoomDropsWholeRecords)
+{
+  LimitedPrint out;
+  LIDARLite_Recorder recorder;
+  uint16_t distances[8];
+
+  out.reportRoom = true;
+  out.capacity = 100;
+  recordSession(out, recorder, distances, 8);
+
+  // Records that did not fit were never started, so the log parses to its end
+  CHECK(recorder.getDroppedRecords() > 0);
+  CHECK(out.length <= 100);
+  checkWholeRecords(out);
+}
+
+TEST(record_tornWriteStopsTheLog)
+{
+  LimitedPrint out;
+  LIDARLite_Recorder recorder;
+  uint16_t distances[8];
+
+  out.capacity = 100;
+  recordSession(out, recorder, distances, 8);
+
+  // The one record that tore filled the buffer; nothing was written after it
+  CHECK_EQUAL(100, out.length);
+  CHECK_EQUAL(100, out.writeEnds[out.writes - 1]);
+  CHECK(out.writeEnds[out.writes - 2] < 100);
+  uint32_t writes = out.writes;
+  recorder.recordSample(LIDARLITE_ADDR_DEFAULT, 1);
+  CHECK_EQUAL(writes, out.writes);
+  CHECK(recorder.getDroppedRecords() > 1);
+}
+
+TEST(record_deltasSurviveDroppedRecords)
+{
+  LimitedPrint out;
+  LIDARLite_Recorder recorder;
+  uint8_t status = 0;
+
+  out.reportRoom = true;
+  recorder.begin(out);
+
+  delay(5);
+  recorder.recordPing(0x62, status);
+  size_t room = out.capacity;
+  out.capacity = out.length + 1; // Not enough room: the next record is dropped
+  delay(7);
+  recorder.recordPing(0x62, status);
+  CHECK_EQUAL(1, recorder.getDroppedRecords());
+  out.capacity = room;
+  delay(11);
+  recorder.recordPing(0x62, status);
+
+  LIDARLite_ReplayTransport replay;
+  LIDARLite_Recording recording = {out.data, (uint32_t)out.length};
+  replay.begin(recording);
+  replay.ping(0x62);
+  replay.ping(0x62);
+  CHECK(replay.atEnd());
+  CHECK_EQUAL(23000, replay.getRecordedTime());
+}
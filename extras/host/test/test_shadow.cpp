@@ -0,0 +1,123 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_shadow.cpp
+
+  The register shadow cache: configuration writes that would not change the
+  register never reach the bus, and a new address or a factory reset makes
+  the next writes go through again.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "HostTest.h"
+
+static void begin(LIDARLite_v4LED &lidar, SimLidar &sim)
+{
+  simAttach(sim);
+  lidar.begin();
+  lidar.enableShadowCache(true);
+}
+
+TEST(configure_redundantCallWritesNothing)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim);
+  simClearBusStats();
+  lidar.configure(2);
+  CHECK_EQUAL(2, simGetBusStats().transactions);
+
+  simClearBusStats();
+  lidar.configure(2);
+  CHECK_EQUAL(0, simGetBusStats().transactions);
+  CHECK_EQUAL(2, lidar.getShadowWritesSaved());
+
+  // Preset 3 shares QUICK_TERMINATION with preset 2: only the count is written
+  simClearBusStats();
+  lidar.configure(3);
+  CHECK_EQUAL(1, simGetBusStats().transactions);
+  CHECK_EQUAL(3, lidar.getShadowWritesSaved());
+  CHECK_EQUAL(0x80, sim.getRegister(0x05));
+  CHECK_EQUAL(0x00, sim.getRegister(0xE5));
+}
+
+TEST(setPowerMode_redundantCallWritesNothing)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim);
+  CHECK(lidar.setPowerModeAsync());
+
+  simClearBusStats();
+  CHECK(lidar.setPowerModeAsync());
+  CHECK_EQUAL(0, simGetBusStats().transactions);
+  CHECK_EQUAL(1, lidar.getShadowWritesSaved());
+
+  CHECK(lidar.setPowerModeAlwaysOn());
+  CHECK(lidar.setPowerModeAlwaysOn());
+  CHECK_EQUAL(1, simGetBusStats().transactions);
+  CHECK_EQUAL(2, lidar.getShadowWritesSaved());
+  CHECK_EQUAL(0xFF, sim.getRegister(0xE2));
+}
+
+TEST(shadowCacheOff_everyWriteReachesTheDevice)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  simAttach(sim);
+  lidar.begin();
+  lidar.configure(2);
+
+  simClearBusStats();
+  lidar.configure(2);
+  CHECK_EQUAL(2, simGetBusStats().transactions);
+  CHECK_EQUAL(0, lidar.getShadowWritesSaved());
+}
+
+TEST(setI2Caddr_invalidatesShadowCache)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim);
+  lidar.configure(2);
+  lidar.setI2Caddr(0x40);
+
+  // The shadow described the device at 0x62; the writes to 0x40 all go out
+  simClearBusStats();
+  lidar.configure(2);
+  CHECK_EQUAL(2, simGetBusStats().transactions);
+  CHECK_EQUAL(0, lidar.getShadowWritesSaved());
+  CHECK_EQUAL(0x18, sim.getRegister(0x05));
+
+  lidar.configure(2);
+  CHECK_EQUAL(2, lidar.getShadowWritesSaved());
+}
+
+TEST(factoryReset_invalidatesShadowCache)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim);
+  lidar.configure(2);
+  lidar.setPowerModeAsync();
+  CHECK(lidar.factoryReset());
+  delay(5);
+  CHECK_EQUAL(0xFF, sim.getRegister(0x05));
+
+  // Back at the defaults on the device, so the same settings have to be written again
+  simClearBusStats();
+  lidar.configure(2);
+  CHECK(lidar.setPowerModeAsync());
+  CHECK_EQUAL(3, simGetBusStats().transactions);
+  CHECK_EQUAL(0, lidar.getShadowWritesSaved());
+  CHECK_EQUAL(0x18, sim.getRegister(0x05));
+  CHECK_EQUAL(0x00, sim.getRegister(0xE2));
+}
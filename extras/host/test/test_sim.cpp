@@ -0,0 +1,259 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_sim.cpp
+
+  The unmodified driver against the simulated sensor: measurements, the
+  register map, address switching and the simulated clock.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "HostTest.h"
+
+TEST(getDistance_returnsTargetDistance)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  sim.setDistance(250);
+  sim.setNoise(0);
+  simAttach(sim);
+
+  CHECK(lidar.begin());
+  CHECK_EQUAL(250, lidar.getDistance());
+  CHECK_EQUAL(1, sim.getMeasurementCount());
+}
+
+TEST(getDistance_takesAcquisitionTime)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  simAttach(sim);
+  lidar.begin();
+
+  uint64_t start = simNanos();
+  lidar.getDistance();
+  uint64_t elapsed = simNanos() - start;
+
+  CHECK(elapsed >= (uint64_t)sim.acquisitionTimeUs() * 1000);
+  CHECK(elapsed < (uint64_t)sim.acquisitionTimeUs() * 1000 + 2000000);
+}
+
+TEST(beyondRange_readsZero)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  sim.setDistance(900);
+  sim.setMaxRange(1000);
+  simAttach(sim);
+  lidar.begin();
+
+  lidar.configure(2); // ACQUISITION_COUNT 0x18 reaches about 300 cm
+  CHECK_EQUAL(0, lidar.getDistance());
+}
+
+TEST(missingSensor_isNotConnected)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  sim.setPresent(false);
+  simAttach(sim);
+
+  CHECK(!lidar.begin());
+  CHECK_EQUAL(1, simGetBusStats().nacks);
+}
+
+TEST(busyFlag_followsAcquisition)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  simAttach(sim);
+  lidar.begin();
+
+  lidar.takeRange();
+  CHECK_EQUAL(1, lidar.getBusyFlag());
+  delayMicroseconds(sim.acquisitionTimeUs());
+  CHECK_EQUAL(0, lidar.getBusyFlag());
+}
+
+TEST(setI2Caddr_movesOnlyMatchingSerial)
+{
+  SimLidar first(0x11111111);
+  SimLidar second(0x22222222);
+  LIDARLite_v4LED lidar;
+
+  simAttach(first);
+  simAttach(second);
+  lidar.begin();
+
+  // Both answer 0x62, so the serial number read back would be their wire-AND
+  second.setPresent(false);
+  lidar.setI2Caddr(0x40);
+  second.setPresent(true);
+  CHECK_EQUAL(0x40, first.getSecondaryAddress());
+  CHECK_EQUAL(0, second.getSecondaryAddress());
+
+  // Default address turned off, so only the second sensor is left on 0x62
+  CHECK_EQUAL(1, first.getConfig());
+  CHECK(lidar.begin(0x40));
+
+  // A serial number write carrying neither serial number is ignored
+  uint8_t dataBytes[5] = {0x33, 0x33, 0x33, 0x33, 0x41};
+  lidar.begin();
+  lidar.write(0x16, dataBytes, 5);
+  delay(10);
+  CHECK_EQUAL(0x40, first.getSecondaryAddress());
+  CHECK_EQUAL(0, second.getSecondaryAddress());
+}
+
+#define IDENTICAL_SENSORS 8
+#define IDENTICAL_SERIALS {0xA5000000, 0xA5000001, 0xA5000002, 0xA5000003, \
+                           0xA5000004, 0xA5000005, 0xA5000006, 0xA5000007}
+
+// Sensors on 0x62 told apart only by serial number, and a table giving
+// sensor i address 0x30 + i, listed in reverse order
+static void attachIdentical(SimLidar *sims, LIDARLite_AddressAssignment *table)
+{
+  for (uint8_t i = 0; i < IDENTICAL_SENSORS; i++)
+  {
+    sims[i].setDistance(100 + 10 * i);
+    sims[i].setNoise(0);
+    simAttach(sims[i]);
+
+    LIDARLite_AddressAssignment &row = table[IDENTICAL_SENSORS - 1 - i];
+    for (uint8_t j = 0; j < 4; j++)
+      row.unitId[j] = sims[i].getRegister(0x16 + j);
+    row.address = 0x30 + i;
+    row.found = false;
+  }
+}
+
+TEST(provisionAddresses_movesEveryIdenticalSensor)
+{
+  SimLidar sims[IDENTICAL_SENSORS] = IDENTICAL_SERIALS;
+  LIDARLite_AddressAssignment table[IDENTICAL_SENSORS + 1];
+  LIDARLite_v4LED lidar;
+
+  // First, a serial number that is not on the bus
+  LIDARLite_AddressAssignment &missing = table[0];
+  for (uint8_t j = 0; j < 4; j++)
+    missing.unitId[j] = 0x5A;
+  missing.address = 0x50;
+  attachIdentical(sims, table + 1);
+
+  CHECK(lidar.begin());
+  CHECK_EQUAL(IDENTICAL_SENSORS, lidar.provisionAddresses(table, IDENTICAL_SENSORS + 1, false, 20));
+  CHECK(!missing.found);
+
+  // Each one done when the call returns, sensor 0 last: its restart is over and 0x62 is off
+  for (uint8_t i = 0; i < IDENTICAL_SENSORS; i++)
+  {
+    CHECK(table[i + 1].found);
+    CHECK_EQUAL(1, sims[i].getConfig());
+    CHECK_EQUAL(0x30 + i, sims[i].getSecondaryAddress());
+
+    LIDARLite_v4LED moved;
+    CHECK(moved.begin(0x30 + i));
+    CHECK_EQUAL(100 + 10 * i, moved.getDistance());
+  }
+  CHECK(!lidar.begin());
+
+  // Two restarts per sensor, not the fixed delays of setI2Caddr()
+  CHECK(lidar.getProvisionTime() < IDENTICAL_SENSORS * 10 + 20);
+}
+
+TEST(provisionAddresses_refusedConfigWriteLeavesRowNotFound)
+{
+  SimLidar sims[IDENTICAL_SENSORS] = IDENTICAL_SERIALS;
+  LIDARLite_AddressAssignment table[IDENTICAL_SENSORS];
+  LIDARLite_v4LED lidar;
+
+  attachIdentical(sims, table);
+  sims[3].nackWrites(0x1B, 1000);
+
+  lidar.begin();
+  CHECK_EQUAL(IDENTICAL_SENSORS - 1, lidar.provisionAddresses(table, IDENTICAL_SENSORS, false, 20));
+
+  // Sensor 3 is row IDENTICAL_SENSORS - 4. It took the address but kept 0x62
+  CHECK(!table[IDENTICAL_SENSORS - 4].found);
+  CHECK_EQUAL(2, sims[3].getConfig());
+  CHECK(lidar.begin());
+  for (uint8_t i = 0; i < IDENTICAL_SENSORS; i++)
+    if (i != 3)
+      CHECK_EQUAL(1, sims[i].getConfig());
+}
+
+TEST(provisionAddresses_persistSurvivesPowerCycle)
+{
+  SimLidar sims[IDENTICAL_SENSORS] = IDENTICAL_SERIALS;
+  LIDARLite_AddressAssignment table[IDENTICAL_SENSORS];
+  LIDARLite_v4LED lidar;
+
+  attachIdentical(sims, table);
+
+  // Flash storage cannot be turned on: nothing is written
+  sims[5].nackWrites(0xEA, 1);
+  lidar.begin();
+  CHECK_EQUAL(0, lidar.provisionAddresses(table, IDENTICAL_SENSORS, true, 20));
+  for (uint8_t i = 0; i < IDENTICAL_SENSORS; i++)
+  {
+    CHECK(!table[i].found);
+    CHECK_EQUAL(0, sims[i].getConfig());
+  }
+
+  CHECK_EQUAL(IDENTICAL_SENSORS, lidar.provisionAddresses(table, IDENTICAL_SENSORS, true, 20));
+  for (uint8_t i = 0; i < IDENTICAL_SENSORS; i++)
+  {
+    CHECK_EQUAL(0, sims[i].getRegister(0xEA));
+    sims[i].powerCycle();
+    CHECK_EQUAL(1, sims[i].getConfig());
+    CHECK_EQUAL(0x30 + i, sims[i].getSecondaryAddress());
+  }
+}
+
+TEST(correlationRecord_zeroCrossingAtTarget)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  int16_t record[192];
+
+  sim.setDistance(400);
+  sim.setNoise(0);
+  simAttach(sim);
+  lidar.begin();
+  lidar.getDistance();
+
+  lidar.correlationRecordRead(record, 192);
+
+  uint8_t crossing = (uint8_t)SIM_CORR_POINT(400);
+  CHECK(record[crossing - 2] > 0);
+  CHECK(record[crossing + 2] < 0);
+}
+
+TEST(busTime_scalesWithClock)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  simAttach(sim);
+  lidar.begin();
+
+  simClearBusStats();
+  lidar.readDistance();
+  uint64_t slow = simGetBusStats().busTimeNs;
+
+  Wire.setClock(400000);
+  simClearBusStats();
+  lidar.readDistance();
+  uint64_t fast = simGetBusStats().busTimeNs;
+
+  CHECK_EQUAL(slow, fast * 4);
+  CHECK_EQUAL(49, simGetBusStats().clocks); // 2 transactions, 5 bytes
+}
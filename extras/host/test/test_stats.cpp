@@ -0,0 +1,141 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_stats.cpp
+
+  LIDARLite_BusStats on a sensor instantiated with it: transaction and byte
+  counts that match what the simulated bus saw, NACKs and short reads told
+  apart, and the acquisition latency histogram.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "HostTest.h"
+
+typedef LIDARLite_v4LED_T<LIDARLite_WireTransport, LIDARLite_BusStats> CountingLidar;
+
+static void begin(CountingLidar &lidar, SimLidar &sim)
+{
+  sim.setDistance(50);
+  sim.setNoise(0);
+  simAttach(sim);
+  Wire.setClock(400000);
+  lidar.begin();
+  lidar.getStats().clear();
+  simClearBusStats();
+}
+
+// The LIDARLite_BusStats bucket of a latency
+static uint8_t bucketOf(uint32_t latencyUs)
+{
+  uint8_t bucket = 0;
+
+  while (bucket < LIDARLITE_LATENCY_BUCKETS - 1 && latencyUs >= (256UL << bucket))
+    bucket++;
+  return bucket;
+}
+
+TEST(busStats_countsWhatTheBusSaw)
+{
+  SimLidar sim;
+  CountingLidar lidar;
+  uint8_t buffer[4];
+
+  begin(lidar, sim);
+  CHECK(lidar.isConnected());
+  lidar.configure(2);
+  lidar.getDistance();
+  lidar.read(0x16, buffer, 4);
+
+  const LIDARLite_BusStats &stats = lidar.getStats();
+  CHECK(stats.transactions > 0);
+  CHECK_EQUAL(simGetBusStats().transactions, stats.transactions);
+  CHECK_EQUAL(simGetBusStats().bytes, stats.bytes);
+  CHECK_EQUAL(0, stats.nacks);
+  CHECK_EQUAL(0, stats.shortReads);
+
+  // One ping, one register write and one read, exactly
+  lidar.getStats().clear();
+  lidar.isConnected();
+  lidar.write(0x05, buffer, 1);
+  lidar.read(0x16, buffer, 4);
+  CHECK_EQUAL(1 + 1 + 2, stats.transactions);
+  CHECK_EQUAL(1 + (2 + 1) + (3 + 4), stats.bytes);
+}
+
+TEST(busStats_nackAndShortReadAreToldApart)
+{
+  SimLidar sim;
+  CountingLidar lidar;
+  uint8_t buffer[40];
+
+  begin(lidar, sim);
+  const LIDARLite_BusStats &stats = lidar.getStats();
+
+  // No answer to the address at all
+  sim.setPresent(false);
+  CHECK(!lidar.isConnected());
+  CHECK(!lidar.read(0x16, buffer, 4));
+  CHECK_EQUAL(2, stats.nacks);
+  CHECK_EQUAL(0, stats.shortReads);
+
+  // The register pointer is set, then the read is refused
+  sim.setPresent(true);
+  sim.nackTransactions(1, 1);
+  CHECK(!lidar.read(0x16, buffer, 4));
+  CHECK_EQUAL(2, stats.nacks);
+  CHECK_EQUAL(1, stats.shortReads);
+
+  // More than the Wire buffer holds
+  CHECK(!lidar.read(0x16, buffer, BUFFER_LENGTH + 8));
+  CHECK_EQUAL(2, stats.nacks);
+  CHECK_EQUAL(2, stats.shortReads);
+  CHECK_EQUAL(LIDARLITE_TRANSPORT_SHORT_READ, lidar.getLastError());
+}
+
+TEST(busStats_latencyHistogramBucketsAcquisitions)
+{
+  SimLidar sim;
+  CountingLidar lidar;
+
+  begin(lidar, sim);
+  const LIDARLite_BusStats &stats = lidar.getStats();
+
+  // Five fast acquisitions, then three long ones
+  lidar.configure(5);
+  uint32_t fastUs = sim.acquisitionTimeUs();
+  for (uint8_t i = 0; i < 5; i++)
+    CHECK_EQUAL(50, lidar.getDistance());
+  uint32_t fastMax = stats.maxLatency;
+
+  lidar.configure(0);
+  sim.setDistance(800);
+  uint32_t slowUs = sim.acquisitionTimeUs();
+  for (uint8_t i = 0; i < 3; i++)
+    CHECK_EQUAL(800, lidar.getDistance());
+
+  CHECK_EQUAL(8, stats.acquisitions);
+  CHECK(fastMax >= fastUs);
+  CHECK(stats.maxLatency >= slowUs);
+  CHECK(stats.maxLatency <= slowUs + LIDARLITE_POLL_MAX_US + 200);
+
+  uint8_t fast = bucketOf(fastMax);
+  uint8_t slow = bucketOf(stats.maxLatency);
+  CHECK(fast < slow);
+  CHECK_EQUAL(bucketOf(fastUs), fast);
+  CHECK_EQUAL(bucketOf(slowUs), slow);
+  for (uint8_t i = 0; i < LIDARLITE_LATENCY_BUCKETS; i++)
+    CHECK_EQUAL((i == fast) ? 5 : (i == slow) ? 3 : 0, stats.latencyHistogram[i]);
+
+  // Timeouts and abandoned waits are not acquisitions
+  sim.setHung(true);
+  lidar.takeRange();
+  CHECK(!lidar.waitForBusy(20000));
+  CHECK_EQUAL(8, stats.acquisitions);
+
+  lidar.getStats().clear();
+  CHECK_EQUAL(0, stats.acquisitions);
+  CHECK_EQUAL(0, stats.latencyHistogram[slow]);
+}
@@ -0,0 +1,159 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED host simulator
+  test_wait.cpp
+
+  waitForBusy(timeoutUs) and the polling behind it: the timeout on a sensor
+  that never finishes, the stop at the first read the sensor does not
+  answer, the LIDARLITE_POLL_MIN_US to LIDARLITE_POLL_MAX_US back-off, and
+  what getLastWaitPolls() and getLastWaitTime() report.
+
+------------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIDARLite_v4LED.h"
+#include "HostTest.h"
+
+static void begin(LIDARLite_v4LED &lidar, SimLidar &sim)
+{
+  sim.setDistance(250);
+  sim.setNoise(0);
+  simAttach(sim);
+  Wire.setClock(400000);
+  lidar.begin();
+}
+
+// Bus time of one STATUS read in microseconds
+static uint32_t pollCostUs(LIDARLite_v4LED &lidar)
+{
+  simClearBusStats();
+  lidar.getBusyFlag();
+  return simGetBusStats().busTimeNs / 1000;
+}
+
+// Polls issued in waitUs after the first one, with each poll costing costUs on top of the back-off pause
+static uint32_t backOffPolls(uint32_t waitUs, uint32_t costUs)
+{
+  uint32_t polls = 1;
+  uint32_t pause = LIDARLITE_POLL_MIN_US;
+  uint32_t time = costUs;
+
+  while (time + pause < waitUs)
+  {
+    time += pause + costUs;
+    polls++;
+    pause = (pause * 2 > LIDARLITE_POLL_MAX_US) ? LIDARLITE_POLL_MAX_US : pause * 2;
+  }
+  return polls;
+}
+
+TEST(waitForBusy_timesOutOnHungSensor)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+  const uint32_t timeoutUs = 100000;
+
+  begin(lidar, sim);
+  uint32_t costUs = pollCostUs(lidar);
+  sim.setHung(true);
+  lidar.takeRange();
+
+  unsigned long start = micros();
+  CHECK(!lidar.waitForBusy(timeoutUs));
+  uint32_t elapsed = micros() - start;
+
+  // Never sleeps past the deadline: at most the poll that straddles it
+  CHECK(lidar.getLastWaitTime() >= timeoutUs);
+  CHECK(lidar.getLastWaitTime() <= timeoutUs + costUs);
+  CHECK(elapsed >= lidar.getLastWaitTime());
+  CHECK(elapsed <= lidar.getLastWaitTime() + costUs);
+  CHECK_EQUAL(0, lidar.getLastError());
+  CHECK(sim.isBusy());
+
+  // The sleep until the profile's shortest acquisition, then the back-off
+  uint32_t pollingUs = timeoutUs - lidar.getProfile().minAcquisitionUs;
+  CHECK(lidar.getLastWaitPolls() >= backOffPolls(pollingUs, costUs) - 1);
+  CHECK(lidar.getLastWaitPolls() <= backOffPolls(pollingUs, 0) + 1);
+}
+
+TEST(waitForBusy_backOffCapsAtMaxPause)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim);
+  uint32_t costUs = pollCostUs(lidar);
+  sim.setHung(true);
+
+  // A second of waiting at fixed LIDARLITE_POLL_MIN_US pauses would be thousands of polls
+  lidar.takeRange();
+  CHECK(!lidar.waitForBusy(1000000));
+  CHECK(lidar.getLastWaitPolls() >= 1000000 / (LIDARLITE_POLL_MAX_US + costUs));
+  CHECK(lidar.getLastWaitPolls() <= 1000000 / LIDARLITE_POLL_MAX_US + 5);
+  CHECK(lidar.getLastWaitPolls() < 1000000 / (LIDARLITE_POLL_MIN_US + costUs) / 4);
+
+  // Each wait starts over at the short pause: four polls in the first millisecond, not one
+  lidar.takeRange();
+  CHECK(!lidar.waitForBusy(lidar.getProfile().minAcquisitionUs + 1000));
+  CHECK(lidar.getLastWaitPolls() >= backOffPolls(1000, costUs));
+  CHECK(backOffPolls(1000, costUs) >= 4);
+}
+
+TEST(waitForBusy_stopsAtBusError)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim);
+  lidar.takeRange();
+  sim.setPresent(false);
+
+  // The first STATUS read is not answered: no point waiting out the timeout
+  CHECK(!lidar.waitForBusy(100000));
+  CHECK_EQUAL(1, lidar.getLastWaitPolls());
+  CHECK(lidar.getLastWaitTime() < (uint32_t)lidar.getProfile().minAcquisitionUs + LIDARLITE_POLL_MIN_US);
+  CHECK(lidar.getLastError() != 0);
+
+  // Also part way through the wait
+  sim.setPresent(true);
+  sim.setHung(true);
+  lidar.takeRange();
+  sim.nackTransactions(1000, 2 * 3);
+  CHECK(!lidar.waitForBusy(100000));
+  CHECK_EQUAL(4, lidar.getLastWaitPolls());
+  CHECK(lidar.getLastWaitTime() < 5000);
+}
+
+TEST(waitForBusy_reportsPollsAndTime)
+{
+  SimLidar sim;
+  LIDARLite_v4LED lidar;
+
+  begin(lidar, sim);
+  uint32_t costUs = pollCostUs(lidar);
+
+  lidar.takeRange();
+  unsigned long start = micros();
+  CHECK(lidar.waitForBusy(100000));
+  uint32_t elapsed = micros() - start;
+  CHECK(!sim.isBusy());
+  CHECK_EQUAL(250, lidar.readDistance());
+
+  // Done within one back-off pause and two polls of the acquisition finishing
+  uint32_t acquisitionUs = sim.acquisitionTimeUs();
+  CHECK(lidar.getLastWaitTime() <= elapsed);
+  CHECK(lidar.getLastWaitTime() + costUs >= elapsed);
+  CHECK(elapsed + 2 * costUs >= acquisitionUs);
+  CHECK(elapsed <= acquisitionUs + LIDARLITE_POLL_MAX_US + 2 * costUs);
+
+  uint32_t pollingUs = acquisitionUs - lidar.getProfile().minAcquisitionUs;
+  CHECK(lidar.getLastWaitPolls() >= backOffPolls(pollingUs, costUs));
+  CHECK(lidar.getLastWaitPolls() <= backOffPolls(pollingUs, 0) + 1);
+
+  // waitForBusy() without a timeout reports the same way
+  lidar.takeRange();
+  lidar.waitForBusy();
+  CHECK(lidar.getLastWaitPolls() >= 1);
+  CHECK(lidar.getLastWaitTime() + 2 * costUs >= acquisitionUs - lidar.getProfile().minAcquisitionUs);
+}
@@ -27,476 +27,96 @@
 
 ------------------------------------------------------------------------------*/
 
-#include <Arduino.h>
-#include <Wire.h>
-#include <stdarg.h>
 #include <stdint.h>
 #include "LIDARLite_v4LED.h"
 
-//Initialize the I2C port
-bool LIDARLite_v4LED::begin(uint8_t address, TwoWire &wirePort)
-{
-    _deviceAddress = address; //grab the address that the sensor is on
-    _i2cPort = &wirePort;     //grab which port the user wants to use
-
-    //return true if the device is connected
-    return (isConnected());
-}
-
-bool LIDARLite_v4LED::isConnected()
-{
-    _i2cPort->beginTransmission(_deviceAddress);
-    if (_i2cPort->endTransmission() == 0)
-        return true;
-    return false;
-}
-
-/*------------------------------------------------------------------------------
-  Configure
-
-  Selects one of several preset configurations.
-
-  Parameters
-  ------------------------------------------------------------------------------
-  configuration:  Default 0.
-    0: Maximum range. Uses maximum acquisition count.
-    1: Balanced performance.
-    2: Short range, high speed. Reduces maximum acquisition count.
-    3: Mid range, higher speed. Turns on quick termination
-         detection for faster measurements at short range (with decreased
-         accuracy)
-    4: Maximum range, higher speed on short range targets. Turns on quick
-         termination detection for faster measurements at short range (with
-         decreased accuracy)
-    5: Very short range, higher speed, high error. Reduces maximum
-         acquisition count to a minimum for faster rep rates on very
-         close targets with high error.
-------------------------------------------------------------------------------*/
-void LIDARLite_v4LED::configure(uint8_t configuration)
-{
-    uint8_t sigCountMax;
-    uint8_t acqConfigReg;
-
-    switch (configuration)
-    {
-    case 0: // Default mode - Maximum range
-        sigCountMax = 0xff;
-        acqConfigReg = 0x08;
-        break;
-
-    case 1: // Balanced performance
-        sigCountMax = 0x80;
-        acqConfigReg = 0x08;
-        break;
-
-    case 2: // Short range, high speed
-        sigCountMax = 0x18;
-        acqConfigReg = 0x00;
-        break;
-
-    case 3: // Mid range, higher speed on short range targets
-        sigCountMax = 0x80;
-        acqConfigReg = 0x00;
-        break;
-
-    case 4: // Maximum range, higher speed on short range targets
-        sigCountMax = 0xff;
-        acqConfigReg = 0x00;
-        break;
-
-    case 5: // Very short range, higher speed, high error
-        sigCountMax = 0x04;
-        acqConfigReg = 0x00;
-        break;
-    }
-
-    write(ACQUISITION_COUNT, &sigCountMax, 1);
-    write(QUICK_TERMINATION, &acqConfigReg, 1);
-} /* LIDARLite_v4LED::configure */
-
-/*------------------------------------------------------------------------------
-  Set I2C Address
-
-  Set Alternate I2C Device Address. See Operation Manual for additional info.
-
-  Parameters
-  ------------------------------------------------------------------------------
-  newAddress: desired secondary I2C device address
-  disableDefault: a non-zero value here means the default 0x62 I2C device
-    address will be disabled.
-------------------------------------------------------------------------------*/
-bool LIDARLite_v4LED::setI2Caddr(uint8_t newAddress, bool disableDefaultI2CAddress)
-{
-    //Check if address is within range
-    if (newAddress < 0x08 || newAddress > 0x77)
-    {
-        return false;
-    }
-
-    if (newAddress == 0x62)
-    {
-        return useDefaultAddress();
-    }
-
-    //Clear out array
-    uint8_t dataBytes[5];
-    for (int i = 0; i < 5; i++)
-        dataBytes[i] = 0;
-
-    // Enable flash storage
-    enableFlash(true);
-    delay(100);
-
-    // Read 4-byte device serial number
-    read(UNIT_ID_0, dataBytes, 4);
-
-    // Append the desired I2C address to the end of the serial number byte array
-    dataBytes[4] = newAddress;
-
-    // Write the serial number and new address in one 5-byte transaction
-    write(UNIT_ID_0, dataBytes, 5);
-
-    // Wait for the I2C peripheral to be restarted with new device address
-    delay(100);
-
-    //Change _deviceAddress to reflect the changed address
-    _deviceAddress = newAddress;
-
-    // If desired, disable default I2C device address (using the new I2C device address)
-    if (disableDefaultI2CAddress)
-    {
-        useNewAddressOnly();
-
-        // Wait for the I2C peripheral to be restarted with new device address
-        delay(100);
-    }
-
-    // Disable flash storage
-    enableFlash(false);
-    delay(100);
-
-    return true;
-} /* LIDARLite_v4LED::setI2Caddr */
-
-bool LIDARLite_v4LED::useDefaultAddress()
-{
-    uint8_t temp = 0x00; // set bit to disable default address
-    bool success = write(I2C_CONFIG, &temp, 1);
-    if (success == false)
-    {
-        return false;
-    }
-
-    _deviceAddress = LIDARLITE_ADDR_DEFAULT;
-
-    //Wait for LIDAR to acknowledge on the new address
-    byte counter = 0;
-    while (1)
-    {
-        delay(10);
-
-        if (isConnected() == true)
-            break;
-        if (counter++ > 100)
-        {
-            return false;
-        }
-    }
-
-    //disable flash storage after changing address
-    enableFlash(false);
-    return true;
+#if LIDARLITE_ARDUINO
+//Compile the Wire based driver once for every sketch
+template class LIDARLite_v4LED_T<LIDARLite_WireTransport>;
+#endif
+
+void LIDARLite_BusStats::clear()
+{
+    transactions = 0;
+    bytes = 0;
+    nacks = 0;
+    shortReads = 0;
+    acquisitions = 0;
+    maxLatency = 0;
+    for (uint8_t i = 0; i < LIDARLITE_LATENCY_BUCKETS; i++)
+        latencyHistogram[i] = 0;
 }
 
-bool LIDARLite_v4LED::useNewAddressOnly()
+void LIDARLite_BusStats::onPing(uint8_t status)
 {
-    uint8_t temp = 0x01; // set bit to disable default address
-    bool success = write(I2C_CONFIG, &temp, 1);
-    if (success == false)
-    {
-        return false;
-    }
-    return true;
+    transactions++;
+    bytes++;
+    if (status != 0)
+        nacks++;
 }
 
-bool LIDARLite_v4LED::useBothAddresses()
+// Register address byte and data bytes in one transaction
+void LIDARLite_BusStats::onWrite(uint8_t status, uint8_t numBytes)
 {
-    uint8_t temp = 0x02;
-    bool success = write(I2C_CONFIG, &temp, 1);
-    if (success == false)
-    {
-        return false;
-    }
-    return true;
-}
-void LIDARLite_v4LED::enableFlash(bool enable)
-{
-    uint8_t temp;
-    if (enable)
-    {
-        temp = 0x11;
-    }
-    else
-    {
-        temp = 0x00;
-    }
-    write(ENABLE_FLASH_STORAGE, &temp, 1);
+    transactions++;
+    bytes += 2 + numBytes;
+    if (status != 0)
+        nacks++;
 }
 
-/*------------------------------------------------------------------------------
-  Take Range
-
-  Initiate a distance measurement by writing to register 0x00.
-------------------------------------------------------------------------------*/
-void LIDARLite_v4LED::takeRange()
-{
-    uint8_t dataByte = 0x04;
-
-    write(ACQ_COMMANDS, &dataByte, 1);
-} /* LIDARLite_v4LED::takeRange */
-
-/*------------------------------------------------------------------------------
-  Wait for Busy Flag
-
-  Blocking function to wait until the Lidar Lite's internal busy flag goes low
-------------------------------------------------------------------------------*/
-void LIDARLite_v4LED::waitForBusy()
-{
-    uint8_t busyFlag;
-
-    do
-    {
-        busyFlag = getBusyFlag();
-    } while (busyFlag);
-
-} /* LIDARLite_v4LED::waitForBusy */
-
-/*------------------------------------------------------------------------------
-  Get Busy Flag
-
-  Read BUSY flag from device registers. Function will return 0x00 if not busy.
-------------------------------------------------------------------------------*/
-uint8_t LIDARLite_v4LED::getBusyFlag()
-{
-    uint8_t statusByte = 0;
-    uint8_t busyFlag; // busyFlag monitors when the device is done with a measurement
-
-    // Read status register to check busy flag
-    read(STATUS, &statusByte, 1);
-
-    // STATUS bit 0 is busyFlag
-    busyFlag = statusByte & 0x01;
-
-    return busyFlag;
-} /* LIDARLite_v4LED::getBusyFlag */
-
-/*------------------------------------------------------------------------------
-  Read Distance
-
-  Read and return the result of the most recent distance measurement.
-------------------------------------------------------------------------------*/
-uint16_t LIDARLite_v4LED::readDistance()
+// Address write, then a repeated-start read of numBytes
+void LIDARLite_BusStats::onRead(uint8_t status, uint8_t numBytes)
 {
-    uint16_t distance;
-    uint8_t *dataBytes = (uint8_t *)&distance;
-
-    // Read two bytes from registers 0x10 and 0x11
-    read(FULL_DELAY_LOW, dataBytes, 2);
-
-    return (distance); //This is the distance in centimeters
-} /* LIDARLite_v4LED::readDistance */
-
-uint16_t LIDARLite_v4LED::getDistance()
-{
-    // 1. Trigger a range measurement.
-    takeRange();
-
-    // 2. Wait for busyFlag to indicate the device is idle.
-    waitForBusy();
-
-    // 3. Read new distance data from device registers
-    return readDistance();
-
-    // return *distance; //This is the distance in centimeters
+    transactions += 2;
+    bytes += 3 + numBytes;
+    if (status == LIDARLITE_TRANSPORT_SHORT_READ)
+        shortReads++;
+    else if (status != 0)
+        nacks++;
 }
 
-/*------------------------------------------------------------------------------
-  Take Range using Trigger / Monitor Pins
-
-  Initiate a distance measurement by toggling the trigger pin
-
-  Parameters
-  ------------------------------------------------------------------------------
-  triggerPin: digital output pin connected to trigger input of LIDAR-Lite
-  monitorPin: digital input pin connected to monitor output of LIDAR-Lite
-------------------------------------------------------------------------------*/
-void LIDARLite_v4LED::takeRangeGpio(uint8_t triggerPin, uint8_t monitorPin)
-{
-    uint8_t busyFlag;
-
-    if (digitalRead(triggerPin))
-        digitalWrite(triggerPin, LOW);
-    else
-        digitalWrite(triggerPin, HIGH);
-
-    // When LLv4 receives trigger command it will drive monitor pin low.
-    // Wait for LLv4 to acknowledge receipt of command before moving on.
-    do
-    {
-        busyFlag = getBusyFlagGpio(monitorPin);
-    } while (!busyFlag);
-} /* LIDARLite_v4LED::takeRangeGpio */
-
-/*------------------------------------------------------------------------------
-  Wait for Busy Flag using Trigger / Monitor Pins
-
-  Blocking function to wait until the Lidar Lite's internal busy flag goes low
-
-  Parameters
-  ------------------------------------------------------------------------------
-  monitorPin: digital input pin connected to monitor output of LIDAR-Lite
-------------------------------------------------------------------------------*/
-void LIDARLite_v4LED::waitForBusyGpio(uint8_t monitorPin)
+void LIDARLite_BusStats::onAcquisition(uint32_t latencyUs)
 {
-    uint8_t busyFlag;
+    uint8_t bucket = 0;
+    uint32_t limit = 256;
 
-    do
+    while (bucket < LIDARLITE_LATENCY_BUCKETS - 1 && latencyUs >= limit)
     {
-        busyFlag = getBusyFlagGpio(monitorPin);
-    } while (busyFlag);
-
-} /* LIDARLite_v4LED::waitForBusyGpio */
-
-/*------------------------------------------------------------------------------
-  Get Busy Flag using Trigger / Monitor Pins
-
-  Check BUSY status via Monitor pin. Function will return 0x00 if not busy.
-
-  Parameters
-  ------------------------------------------------------------------------------
-  monitorPin: digital input pin connected to monitor output of LIDAR-Lite
-------------------------------------------------------------------------------*/
-uint8_t LIDARLite_v4LED::getBusyFlagGpio(uint8_t monitorPin)
-{
-    uint8_t busyFlag; // busyFlag monitors when the device is done with a measurement
-
-    // Check busy flag via monitor pin
-    if (digitalRead(monitorPin))
-        busyFlag = 1;
-    else
-        busyFlag = 0;
-
-    return busyFlag;
-} /* LIDARLite_v4LED::getBusyFlagGpio */
-
-/*------------------------------------------------------------------------------
-  Get the temperature of the board
-  
-  Read the BOARD_TEMPERATURE register. This function returns the temperature in 
-  two's complement in Celcius.
-------------------------------------------------------------------------------*/
-uint8_t LIDARLite_v4LED::getBoardTemp()
-{
-    uint8_t temp = 0;
-    read(BOARD_TEMPERATURE, &temp, 1);
-    return temp;
-}
-
-/*------------------------------------------------------------------------------
-  Get the temperature of the SOC (nRF52840)
-
-  Read the SOC_TEMPERATURE register. This function returns the temperature in 
-  two's complement in Celcius.
-------------------------------------------------------------------------------*/
-uint8_t LIDARLite_v4LED::getSOCTemp()
-{
-    uint8_t temp = 0;
-    read(SOC_TEMPERATURE, &temp, 1);
-    return temp;
-}
-
-/*------------------------------------------------------------------------------
-  Set the power mode of the nRF52840 to be always on.
-
-  The coprocessor is not turned off, allowing for the fastest measurement possible.
-  This is the default setting.
-------------------------------------------------------------------------------*/
-bool LIDARLite_v4LED::setPowerModeAlwaysOn()
-{
-    uint8_t on = 0xFF;
-    return write(POWER_MODE, &on, 1);
-}
+        bucket++;
+        limit <<= 1;
+    }
 
-/*------------------------------------------------------------------------------
-  Set the nRF52840 to operate in asynchronous mode.
+    // Saturate rather than wrap
+    if (latencyHistogram[bucket] != 0xFFFF)
+        latencyHistogram[bucket]++;
 
-  The coprocessor is always off unless a distance measurement is needed or a 
-  register access is required. Disable high accuracy mode first.
-------------------------------------------------------------------------------*/
-bool LIDARLite_v4LED::setPowerModeAsync()
-{
-    uint8_t async = 0x00;
-    return write(POWER_MODE, &async, 1);
+    acquisitions++;
+    if (latencyUs > maxLatency)
+        maxLatency = latencyUs;
 }
 
-/*------------------------------------------------------------------------------
-  Enable and disable high accuracy mode
-
-  By default, the LIDAR operates in high accuracy mode, so use this function to 
-  disable and/or re-enable high accuracy mode
-  mode before setting the power mode to asynchronous.
-
-  Parameters
-  ------------------------------------------------------------------------------
-  enable: boolean when set to true will ENABLE high accuracy mode and when false
-  will DISABLE high accuracy mode.
-------------------------------------------------------------------------------*/
-bool LIDARLite_v4LED::enableHighAccuracyMode(bool enable)
+#if LIDARLITE_ARDUINO
+void LIDARLite_WireTransport::begin(TwoWire &wirePort)
 {
-    uint8_t writeByte;
-
-    if (enable){
-        writeByte = 0x14;
-    } else {
-        writeByte = 0x00;
-    }
-
-    return write(HIGH_ACCURACY_MODE, &writeByte, 1);
+    _i2cPort = &wirePort;
 }
 
-/*------------------------------------------------------------------------------
-  Call this function to put the nRF52840 SOC back to factory settings.
-
-  Resets the NVM/Flash storage information back to default settings and executes 
-  a SoftDevice reset.
-------------------------------------------------------------------------------*/
-bool LIDARLite_v4LED::factoryReset()
+uint8_t LIDARLite_WireTransport::ping(uint8_t address)
 {
-    uint8_t resetByte = 0x01;
-    return write(FACTORY_RESET, &resetByte, 1);
+    _i2cPort->beginTransmission(address);
+    return _i2cPort->endTransmission();
 }
 
 /*------------------------------------------------------------------------------
   Write
 
-  Perform I2C write to device. The I2C peripheral in the LidarLite v3 HP
-  will receive multiple bytes in one I2C transmission. The first byte is
-  always the register address. The the bytes that follow will be written
-  into the specified register address first and then the internal address
-  in the Lidar Lite will be auto-incremented for all following bytes.
-
-  Parameters
-  ------------------------------------------------------------------------------
-  regAddr:   register address to write to
-  dataBytes: pointer to array of bytes to write
-  numBytes:  number of bytes in 'dataBytes' array to write
+  One I2C transmission: the register address followed by the data bytes.
+  Returns the endTransmission() result, 0 on success.
 ------------------------------------------------------------------------------*/
-bool LIDARLite_v4LED::write(uint8_t regAddr, uint8_t *dataBytes,
-                            uint8_t numBytes)
+uint8_t LIDARLite_WireTransport::write(uint8_t address, uint8_t regAddr,
+                                       const uint8_t *dataBytes, uint8_t numBytes)
 {
-    int nackCatcher;
-
-    _i2cPort->beginTransmission(_deviceAddress);
+    _i2cPort->beginTransmission(address);
 
     // First byte of every write sets the LidarLite's internal register address pointer
     _i2cPort->write((int)regAddr);
@@ -504,53 +124,32 @@ bool LIDARLite_v4LED::write(uint8_t regAddr, uint8_t *dataBytes,
     // Subsequent bytes are data writes
     _i2cPort->write(dataBytes, (int)numBytes);
 
-    // A nack means the device is not responding. Report the error over serial.
-    nackCatcher = _i2cPort->endTransmission();
-    if (nackCatcher != 0)
-    {
-        // handle nack issues in here
-        return false;
-    }
-    else
-        return true;
-} /* LIDARLite_v4LED::write */
+    return _i2cPort->endTransmission();
+} /* LIDARLite_WireTransport::write */
 
 /*------------------------------------------------------------------------------
   Read
 
-  Perform I2C read from device.  The I2C peripheral in the LidarLite v3 HP
-  will send multiple bytes in one I2C transmission. The register address must
-  be set up by a previous I2C write. The bytes that follow will be read
-  from the specified register address first and then the internal address
-  pointer in the Lidar Lite will be auto-incremented for following bytes.
-
-  Will detect an unresponsive device and report the error over serial.
-
-  Parameters
-  ------------------------------------------------------------------------------
-  regAddr:   register address to read
-  dataBytes: pointer to array of bytes to write
-  numBytes:  number of bytes in 'dataBytes' array to read
+  Set the register address pointer, then read numBytes with a repeated start.
+  dataBytes is only written if the device returned all numBytes bytes.
+  Returns 0 on success, the endTransmission() result if the address write was
+  not acknowledged, or LIDARLITE_TRANSPORT_SHORT_READ.
 ------------------------------------------------------------------------------*/
-void LIDARLite_v4LED::read(uint8_t regAddr, uint8_t *dataBytes,
-                           uint8_t numBytes)
+uint8_t LIDARLite_WireTransport::read(uint8_t address, uint8_t regAddr,
+                                      uint8_t *dataBytes, uint8_t numBytes)
 {
     uint16_t i = 0;
-    int nackCatcher = 0;
+    uint8_t nackCatcher = 0;
 
     // Set the internal register address pointer in the Lidar Lite
-    _i2cPort->beginTransmission(_deviceAddress);
+    _i2cPort->beginTransmission(address);
     _i2cPort->write((int)regAddr); // Set the register to be read
 
-    // A nack means the device is not responding, report the error over serial
+    // A nack means the device is not responding
     nackCatcher = _i2cPort->endTransmission(false); // false means perform repeated start
-    if (nackCatcher != 0)
-    {
-        // handle nack issues in here
-    }
 
     // Perform read, save in dataBytes array
-    _i2cPort->requestFrom(_deviceAddress, numBytes);
+    _i2cPort->requestFrom(address, numBytes);
     if ((int)numBytes <= _i2cPort->available())
     {
         while (i < numBytes)
@@ -559,41 +158,58 @@ void LIDARLite_v4LED::read(uint8_t regAddr, uint8_t *dataBytes,
             i++;
         }
     }
+    else if (nackCatcher == 0)
+        nackCatcher = LIDARLITE_TRANSPORT_SHORT_READ;
 
-} /* LIDARLite_v4LED::read */
+    return nackCatcher;
+} /* LIDARLite_WireTransport::read */
 
 /*------------------------------------------------------------------------------
-  Correlation Record Read
+  Recover Bus
 
-  The correlation record used to calculate distance can be read from the device.
-  It has a bipolar wave shape, transitioning from a positive going portion to a
-  roughly symmetrical negative going pulse. The point where the signal crosses
-  zero represents the effective delay for the reference and return signals.
+  A device that loses power or resets while it is sending a byte can be left
+  holding SDA low, and every later transaction on the bus fails. Following
+  the I2C specification's bus clear procedure, SCL is clocked up to nine
+  times until the device has shifted out the rest of its byte and releases
+  SDA, then a STOP condition is generated.
 
-  Process
-  ------------------------------------------------------------------------------
-  1.  Take a distance reading (there is no correlation record without at least
-      one distance reading being taken)
-  2.  For as many points as you want to read from the record (max is 192) read
-      the two byte signed correlation data point from 0x52
+  Both lines are driven open-drain style: pulled low as outputs, released
+  as inputs so the pull-up resistors take them high. Clock stretching is
+  honored for up to 1 ms per clock.
 
   Parameters
   ------------------------------------------------------------------------------
-  correlationArray: pointer to memory location to store the correlation record
-                    ** Two bytes for every correlation value must be
-                       allocated by calling function
-  numberOfReadings: Default = 192. Maximum = 192
+  sdaPin: digital pin number of SDA, for example PIN_WIRE_SDA
+  sclPin: digital pin number of SCL, for example PIN_WIRE_SCL
 ------------------------------------------------------------------------------*/
-void LIDARLite_v4LED::correlationRecordRead(
-    int16_t *correlationArray, uint8_t numberOfReadings)
+bool LIDARLite_recoverBus(uint8_t sdaPin, uint8_t sclPin)
 {
-    uint8_t i;
-    int16_t correlationValue;
-    uint8_t *dataBytes = (uint8_t *)&correlationValue;
+    pinMode(sdaPin, INPUT_PULLUP);
+    pinMode(sclPin, INPUT_PULLUP);
+    delayMicroseconds(5);
 
-    for (i = 0; i < numberOfReadings; i++)
+    for (uint8_t i = 0; i < 9 && digitalRead(sdaPin) == LOW; i++)
     {
-        read(CORR_DATA, dataBytes, 2);
-        correlationArray[i] = correlationValue;
+        digitalWrite(sclPin, LOW);
+        pinMode(sclPin, OUTPUT);
+        delayMicroseconds(5);
+        pinMode(sclPin, INPUT_PULLUP);
+
+        // A device may stretch the clock
+        unsigned long startTime = micros();
+        while (digitalRead(sclPin) == LOW && micros() - startTime < 1000)
+            ;
+        delayMicroseconds(5);
     }
-} /* LIDARLite_v4LED::correlationRecordRead */
+
+    // STOP: SDA rises while SCL is high
+    digitalWrite(sdaPin, LOW);
+    pinMode(sdaPin, OUTPUT);
+    delayMicroseconds(5);
+    pinMode(sdaPin, INPUT_PULLUP);
+    delayMicroseconds(5);
+
+    return (digitalRead(sdaPin) == HIGH && digitalRead(sclPin) == HIGH);
+} /* LIDARLite_recoverBus */
+
+#endif
@@ -31,16 +31,341 @@
 
 #define LIDARLITE_ADDR_DEFAULT 0x62
 
+//1 when building against an Arduino core. Defaults to 1 when ARDUINO is
+//defined or an Arduino.h is on the include path. With 0 the library builds on
+//a plain Linux host against LIDARLite_v4LED_Posix.h and
+//LIDARLite_v4LED_LinuxI2C.h: the Wire transport, the Gpio and interrupt
+//functions, LIDARLite_recoverBus(), LIDARLite_v4LED_GpioGroup and the
+//recorder, which all need the Arduino core, are left out.
+#ifndef LIDARLITE_ARDUINO
+#if defined(ARDUINO)
+#define LIDARLITE_ARDUINO 1
+#elif defined(__has_include)
+#if __has_include(<Arduino.h>)
+#define LIDARLITE_ARDUINO 1
+#else
+#define LIDARLITE_ARDUINO 0
+#endif
+#else
+#define LIDARLITE_ARDUINO 1
+#endif
+#endif
+
+#if LIDARLITE_ARDUINO
 #include <Wire.h>
 #include <Arduino.h>
+#else
+#include "LIDARLite_v4LED_Posix.h"
+#endif
 #include <stdint.h>
 
-class LIDARLite_v4LED
+//Busy polling back-off. After the expected acquisition time has passed the
+//busy flag is polled with a pause that starts at LIDARLITE_POLL_MIN_US and
+//doubles after every poll up to LIDARLITE_POLL_MAX_US.
+#ifndef LIDARLITE_POLL_MIN_US
+#define LIDARLITE_POLL_MIN_US 50
+#endif
+#ifndef LIDARLITE_POLL_MAX_US
+#define LIDARLITE_POLL_MAX_US 1000
+#endif
+
+//Microseconds per MEASUREMENT_INTERVAL count. startContinuous() takes the
+//nominal period from it and then measures the real one on the device.
+#ifndef LIDARLITE_INTERVAL_UNIT_US
+#define LIDARLITE_INTERVAL_UNIT_US 1000
+#endif
+
+//Number of samples held by the continuous mode ring buffer. Must be a power of two.
+#ifndef LIDARLITE_RING_SIZE
+#define LIDARLITE_RING_SIZE 8
+#endif
+
+//Number of sensors that can use the monitor pin interrupt at the same time
+#define LIDARLITE_MAX_INTERRUPT_SENSORS 4
+
+//One distance sample from continuous or interrupt mode
+struct LIDARLite_Sample
+{
+  uint16_t distance;       //Distance in centimeters
+  uint16_t sequence;       //Increments by one for every sample the library collected, including ones lost to overruns
+  unsigned long timestamp; //micros() at the middle of the acquisition
+  uint32_t duration;       //Microseconds from trigger to completion
+};
+
+//Number of samples one LIDARLite_SampleBlock holds
+#ifndef LIDARLITE_BLOCK_SIZE
+#define LIDARLITE_BLOCK_SIZE 32
+#endif
+
+//Alignment of every LIDARLite_SampleBlock array in bytes: a cache line on
+//hosts, a word on microcontrollers, which suits DMA and word-sized copies.
+#ifndef LIDARLITE_BLOCK_ALIGN
+#if defined(ARDUINO)
+#define LIDARLITE_BLOCK_ALIGN 4
+#else
+#define LIDARLITE_BLOCK_ALIGN 64
+#endif
+#endif
+
+//Flags in LIDARLite_SampleBlock::status
+#define LIDARLITE_SAMPLE_GAP 0x01        //Samples from this sensor were lost or failed since its previous sample
+#define LIDARLITE_SAMPLE_REATTACHED 0x02 //First sample since the sensor came back out of scheduler quarantine
+
+//Samples stored as one array per field, filled in place by readSamples() and
+//LIDARLite_v4LED_Scheduler_T::service(block). Entry i of every array belongs
+//to the same sample, and each array can be handed to a writer whole:
+//  logFile.write((uint8_t *)block.distance, block.count * sizeof(block.distance[0]));
+//Declare blocks as globals or statics; heap allocation does not honor the
+//alignment before C++17.
+struct LIDARLite_SampleBlock
+{
+  uint16_t count = 0; //Entries in use. Set back to 0 once the block has been consumed
+
+  alignas(LIDARLITE_BLOCK_ALIGN) unsigned long timestamp[LIDARLITE_BLOCK_SIZE]; //micros() at the middle of each acquisition
+  alignas(LIDARLITE_BLOCK_ALIGN) uint16_t distance[LIDARLITE_BLOCK_SIZE];       //Distance in centimeters
+  alignas(LIDARLITE_BLOCK_ALIGN) uint8_t status[LIDARLITE_BLOCK_SIZE];          //LIDARLITE_SAMPLE_ flags, 0 for an ordinary sample
+  alignas(LIDARLITE_BLOCK_ALIGN) uint8_t sensor[LIDARLITE_BLOCK_SIZE];          //Sensor id given by the caller, or the scheduler index
+};
+
+//One row of the table passed to provisionAddresses()
+struct LIDARLite_AddressAssignment
+{
+  uint8_t unitId[4]; //Serial number from the UNIT_ID registers (0x16-0x19), UNIT_ID_0 first
+  uint8_t address;   //I2C address to give the sensor with this serial number
+  bool found;        //Set by provisionAddresses() once the sensor answers on its new address only
+};
+
+//Result of the fused register reads, see readStatusDistance() and readTelemetry()
+struct LIDARLite_Reading
+{
+  uint8_t status;          //STATUS register (0x01)
+  bool busy;               //STATUS bit 0. distance is only valid when false
+  uint16_t distance;       //FULL_DELAY (0x10-0x11) in centimeters
+  int8_t boardTemp;        //BOARD_TEMPERATURE (0xE0) in Celsius
+  uint8_t hardwareVersion; //HARDWARE_VERSION (0xE1)
+  int8_t socTemp;          //SOC_TEMPERATURE (0xEC) in Celsius
+};
+
+//Acquisition settings applied together by applyProfile(). A plain aggregate so
+//profiles can be defined at compile time:
+//  constexpr LIDARLite_Profile MY_PROFILE = {0x40, 0x00, true, 0x20, 200};
+struct LIDARLite_Profile
+{
+  uint8_t acquisitionCount;     //ACQUISITION_COUNT (0x05), maximum acquisitions per measurement
+  uint8_t quickTermination;     //QUICK_TERMINATION (0xE5), 0x00 enables and 0x08 disables quick termination
+  bool setSensitivity;          //Write detectionSensitivity. False leaves DETECTION_SENSITIVITY as it is
+  uint8_t detectionSensitivity; //DETECTION_SENSITIVITY (0x1C), 0x00 for the device default
+  uint16_t minAcquisitionUs;    //Shortest time a measurement can take. Waits sleep this long before polling busy
+};
+
+//The configure() presets as profiles. They leave DETECTION_SENSITIVITY alone.
+constexpr LIDARLite_Profile LIDARLITE_PROFILE_MAX_RANGE = {0xFF, 0x08, false, 0x00, 1000};       //configure(0)
+constexpr LIDARLite_Profile LIDARLITE_PROFILE_BALANCED = {0x80, 0x08, false, 0x00, 500};         //configure(1)
+constexpr LIDARLite_Profile LIDARLITE_PROFILE_SHORT_RANGE = {0x18, 0x00, false, 0x00, 100};      //configure(2)
+constexpr LIDARLite_Profile LIDARLITE_PROFILE_MID_RANGE_QT = {0x80, 0x00, false, 0x00, 100};     //configure(3)
+constexpr LIDARLite_Profile LIDARLITE_PROFILE_MAX_RANGE_QT = {0xFF, 0x00, false, 0x00, 100};     //configure(4)
+constexpr LIDARLite_Profile LIDARLITE_PROFILE_VERY_SHORT_RANGE = {0x04, 0x00, false, 0x00, 50};  //configure(5)
+
+//States of the non-blocking measurement state machine
+enum LIDARLite_MeasurementState
+{
+  LIDARLITE_STATE_IDLE = 0, //No measurement in progress
+  LIDARLITE_STATE_BUSY,     //Measurement triggered, device is still acquiring
+  LIDARLITE_STATE_READY,    //Measurement complete, distance waiting to be fetched
+};
+
+//Error code returned by a transport read() when the device sent fewer bytes than requested
+#define LIDARLITE_TRANSPORT_SHORT_READ 0xFF
+
+/*------------------------------------------------------------------------------
+  Transport policies
+
+  LIDARLite_v4LED_T talks to the device only through its Transport template
+  parameter, so a different I2C backend (DMA, bit-banged, Linux i2c-dev, a
+  simulator...) can be plugged in at compile time without virtual calls.
+  A transport provides:
+
+    typedef ... Port;                 //Object passed to begin() to pick the bus
+    static Port &defaultPort();       //Bus used when begin() is given none
+    void begin(Port &port);
+    uint8_t ping(uint8_t address);    //0 if the device acknowledged
+    uint8_t write(uint8_t address, uint8_t regAddr,
+                  const uint8_t *dataBytes, uint8_t numBytes);
+    uint8_t read(uint8_t address, uint8_t regAddr,
+                 uint8_t *dataBytes, uint8_t numBytes);
+
+  write() sends regAddr followed by the data bytes in one transaction. read()
+  sets the register pointer to regAddr, then reads numBytes, and must leave
+  dataBytes untouched if fewer bytes arrive. Both return 0 on success, a
+  Wire::endTransmission() style code on a NACK, or
+  LIDARLITE_TRANSPORT_SHORT_READ.
+------------------------------------------------------------------------------*/
+
+#if LIDARLITE_ARDUINO
+//Free an I2C bus held low by a device that lost power or reset in the middle
+//of a transfer. The pins must not be driven by the I2C peripheral while this
+//runs, so call Wire.end() first and Wire.begin() afterwards. See
+//LIDARLite_v4LED.cpp. Returns true if both lines are high afterwards.
+bool LIDARLite_recoverBus(uint8_t sdaPin, uint8_t sclPin);
+
+//Default transport: Arduino TwoWire
+class LIDARLite_WireTransport
 {
 private:
-  TwoWire *_i2cPort;      //generic connection to user's chosen I2C I2C port
+  TwoWire *_i2cPort; //generic connection to user's chosen I2C I2C port
+
+public:
+  typedef TwoWire Port;
+  static TwoWire &defaultPort() { return Wire; }
+
+  void begin(TwoWire &wirePort);
+  uint8_t ping(uint8_t address);
+  uint8_t write(uint8_t address, uint8_t regAddr, const uint8_t *dataBytes, uint8_t numBytes);
+  uint8_t read(uint8_t address, uint8_t regAddr, uint8_t *dataBytes, uint8_t numBytes);
+};
+
+//Transport every template in the library uses unless given another
+#define LIDARLITE_DEFAULT_TRANSPORT LIDARLite_WireTransport
+#else
+//Defined in LIDARLite_v4LED_LinuxI2C.h, which sketches built without an Arduino core include
+class LIDARLite_LinuxI2CTransport;
+#define LIDARLITE_DEFAULT_TRANSPORT LIDARLite_LinuxI2CTransport
+#endif
+
+/*------------------------------------------------------------------------------
+  Stats policies
+
+  The second template parameter of LIDARLite_v4LED_T receives a callback for
+  every bus transaction and every completed acquisition. The default,
+  LIDARLite_NoStats, does nothing; its empty inline hooks compile away and,
+  being an empty base class, it takes no memory. Use LIDARLite_BusStats, or
+  any class with the same hooks, to instrument a sensor:
+
+    LIDARLite_v4LED_T<LIDARLite_WireTransport, LIDARLite_BusStats> myLIDAR;
+    myLIDAR.getStats().nacks;
+
+  Hooks receive the transport's return code (0, a NACK code, or
+  LIDARLITE_TRANSPORT_SHORT_READ).
+------------------------------------------------------------------------------*/
+class LIDARLite_NoStats
+{
+public:
+  void onPing(uint8_t status) { (void)status; }
+  void onWrite(uint8_t status, uint8_t numBytes) { (void)status; (void)numBytes; }
+  void onRead(uint8_t status, uint8_t numBytes) { (void)status; (void)numBytes; }
+  void onAcquisition(uint32_t latencyUs) { (void)latencyUs; }
+};
+
+//Number of buckets in the LIDARLite_BusStats acquisition latency histogram
+#define LIDARLITE_LATENCY_BUCKETS 8
+
+//Counts transactions, bytes on the wire and failures, and keeps a histogram of acquisition latency
+class LIDARLite_BusStats
+{
+public:
+  uint32_t transactions = 0; //START...STOP sequences on the bus, an address write plus a read counts as two
+  uint32_t bytes = 0;        //Bytes on the wire including address bytes
+  uint32_t nacks = 0;        //Transactions the device did not acknowledge
+  uint32_t shortReads = 0;   //Reads that returned fewer bytes than requested
+  uint32_t acquisitions = 0; //Completed measurements
+  uint32_t maxLatency = 0;   //Longest acquisition in microseconds
+
+  //Bucket 0 counts acquisitions under 256 us, bucket n under 256 << n us, the last bucket everything longer
+  uint16_t latencyHistogram[LIDARLITE_LATENCY_BUCKETS] = {0};
+
+  void clear();
+  void onPing(uint8_t status);
+  void onWrite(uint8_t status, uint8_t numBytes);
+  void onRead(uint8_t status, uint8_t numBytes);
+  void onAcquisition(uint32_t latencyUs);
+};
+
+template <class Transport = LIDARLITE_DEFAULT_TRANSPORT, class Stats = LIDARLite_NoStats>
+class LIDARLite_v4LED_T : private Stats
+{
+private:
+  Transport _transport;   //bus backend, see Transport policies above
   uint8_t _deviceAddress; //I2C address of the button/switch
 
+  uint8_t _measurementState = LIDARLITE_STATE_IDLE; //Current state of the non-blocking measurement
+  uint16_t _lastDistance = 0;                        //Distance latched by service() once the measurement completes
+
+  LIDARLite_Profile _profile = LIDARLITE_PROFILE_MAX_RANGE; //Acquisition profile currently in use
+  unsigned long _triggerTime = 0;                           //micros() when the current measurement was triggered
+  unsigned long _busySeenTime = 0;                          //Latest micros() at which the current measurement was known to be running
+  unsigned long _completionTime = 0;                        //Estimated micros() at which the last measurement finished
+  uint16_t _lastWaitPolls = 0;                              //Busy flag polls issued by the last wait
+  uint32_t _lastWaitTime = 0;                               //Microseconds spent in the last wait
+
+  bool pollUntilIdle(uint32_t timeoutUs, bool useGpio, uint8_t monitorPin); //Adaptive busy polling shared by the wait functions
+  void noteCompletion(unsigned long idleSeenTime);                          //Estimate _completionTime from _busySeenTime and the first time idle was seen
+  void stampSample(LIDARLite_Sample &sample, unsigned long triggerTime, unsigned long completionTime); //Fill in timestamp and duration
+
+  //Continuous mode
+  bool _continuous = false;                      //True between startContinuous() and stopContinuous()
+  uint32_t _samplePeriod = 0;                    //Measured microseconds between self-triggered measurements
+  unsigned long _anchorTrigger = 0;              //Measured micros() of the first self-triggered measurement, the base of the period estimate
+  unsigned long _nextSampleTime = 0;             //Predicted micros() at which the next measurement starts
+  unsigned long _nextPollTime = 0;               //micros() of the next STATUS read by serviceContinuous()
+  unsigned long _idleSeenTime = 0;               //micros() of the first STATUS read of a sample when it found the device idle on time
+  uint32_t _pollPause = 0;                       //Pause before the next STATUS read while the measurement has not been seen running
+  bool _continuousBusySeen = false;              //STATUS showed the next measurement running
+  bool _continuousFirstRead = false;             //The next STATUS read is the first one for the next measurement
+  bool _continuousEarly = false;                 //The first STATUS read found the device idle on time: finished early, or not started yet
+  uint32_t _continuousDuration = 0;              //Acquisition time measured when continuous mode started
+  uint32_t _statusReadTime = 0;                  //Length of a STATUS read, measured when continuous mode started; STATUS is taken as at its middle
+  LIDARLite_Sample _ring[LIDARLITE_RING_SIZE];   //Samples waiting to be read
+  uint8_t _ringHead = 0;                         //Index of the oldest sample in _ring
+  uint8_t _ringCount = 0;                        //Number of samples in _ring
+  uint16_t _sequence = 0;                        //Sequence number of the next sample
+  uint16_t _readSequence = 0;                    //Sequence number the reader expects next, to flag gaps in readSamples()
+  uint32_t _overruns = 0;                        //Samples dropped because _ring was full
+  uint32_t _missed = 0;                          //Measurements the device finished that were never read
+
+  bool waitForStatus(bool busy, unsigned long deadline, unsigned long &edgeTime); //Poll STATUS until the busy bit equals busy, estimating when it changed
+  unsigned long nextPollTime();                  //Start of the first STATUS read for the next self-triggered measurement
+  void rephaseContinuous(unsigned long completion, bool refinePeriod); //Move the schedule onto an observed completion
+  void queueSample(const LIDARLite_Sample &sample); //Append to _ring, dropping the oldest sample if it is full
+
+#if LIDARLITE_ARDUINO
+  //Interrupt mode. The device only holds its latest result, so the monitor pin ISR keeps only the latest completion
+  int8_t _isrSlot = -1;                                           //Index in _isrInstances, -1 when interrupt mode is off
+  uint8_t _triggerPin = 0;                                        //Pin toggled to start a measurement
+  uint8_t _monitorPin = 0;                                        //Pin whose falling edge signals a finished measurement
+  volatile unsigned long _isrCompletionTime = 0;                  //micros() of the latest completion, written by the ISR
+  volatile bool _isrPending = false;                              //_isrCompletionTime has not been read yet
+  volatile uint32_t _isrDropped = 0;                              //Completions replaced by a newer one before they were read
+
+  static LIDARLite_v4LED_T *_isrInstances[LIDARLITE_MAX_INTERRUPT_SENSORS]; //Sensor served by each interrupt trampoline
+  void handleMonitorInterrupt();                                  //Record one measurement completion. Runs in interrupt context
+  static void isrTrampoline0();
+  static void isrTrampoline1();
+  static void isrTrampoline2();
+  static void isrTrampoline3();
+
+  template <class, class>
+  friend class LIDARLite_v4LED_GpioGroup_T; //Triggers its members itself and stamps their trigger and completion times
+#endif
+
+  bool _fusedReads = false; //service() reads STATUS and FULL_DELAY in one burst
+
+  unsigned long _provisionTime = 0;                   //Milliseconds the last provisionAddresses() took
+  bool waitForReadBack(uint8_t regAddr, uint8_t value, uint16_t timeoutMs); //Poll a register until it reads back value
+
+  uint8_t _lastError = 0;           //Transport result of the last transaction, 0 on success
+  uint8_t _consecutiveFailures = 0; //Failed transactions since the last successful one, saturates at 255
+  void noteStatus(uint8_t status);  //Update _lastError and _consecutiveFailures after a transaction
+
+  //Register shadow cache. One slot per writable configuration register, see shadowIndex()
+  bool _shadowEnabled = false;     //Skip single-register writes that would not change the register
+  uint8_t _shadowValid = 0;        //Bit n set when _shadowValue[n] matches the device
+  uint8_t _shadowValue[8];         //Last value written to each shadowed register, kept even while the cache is off
+  uint8_t _configSet = 0;          //Bit n set when _shadowValue[n] holds a value written since begin(), see restoreConfiguration()
+  uint32_t _shadowWritesSaved = 0; //Number of writes skipped because the register already held the value
+
+  int8_t shadowIndex(uint8_t regAddr);               //Returns the shadow slot of a register, or -1 if it is not shadowed
+  bool writeRegister(uint8_t regAddr, uint8_t value); //Write one configuration register, skipping the write if the shadow says it is unchanged
+
   //Register map
   enum
   {
@@ -75,30 +400,83 @@ private:
 
 public:
   //Device status
-  bool begin(uint8_t address = LIDARLITE_ADDR_DEFAULT, TwoWire &wirePort = Wire); //Sets device I2C address to a user-specified address, over whatever port the user specifies.
-  bool isConnected();                                                             //Returns true if the button/switch will acknowledge over I2C, and false otherwise
+  bool begin(uint8_t address = LIDARLITE_ADDR_DEFAULT, typename Transport::Port &wirePort = Transport::defaultPort()); //Sets device I2C address to a user-specified address, over whatever port the user specifies.
+  bool isConnected();                                                                                               //Returns true if the button/switch will acknowledge over I2C, and false otherwise
+  Transport &getTransport();                                                                                        //Returns the transport this sensor talks through
+  Stats &getStats();                                                                                                //Returns the instrumentation of this sensor, see Stats policies above
 
   //LIDAR configure
   void configure(uint8_t configuration = 0);                                 //Configure LIDAR to one of several measurement configurations
+  bool applyProfile(const LIDARLite_Profile &profile);                       //Apply a built-in or user defined acquisition profile
+  LIDARLite_Profile getProfile();                                            //Returns the acquisition profile in use
   bool setI2Caddr(uint8_t newAddress, bool disableDefaultI2CAddress = true); //Configures the connected device to attach to the I2C bus using the specified address
   bool useDefaultAddress();
   bool useNewAddressOnly();
   bool useBothAddresses();
-  void enableFlash(bool enable); //Toggle between RAM and FLASH/NVM storage
+  uint8_t provisionAddresses(LIDARLite_AddressAssignment *table, uint8_t count, bool persist = false, uint16_t timeoutMs = 100); //Move every sensor in the table off the current address. Returns the number moved
+  unsigned long getProvisionTime();                                                                                             //Returns the milliseconds the last provisionAddresses() took
+  bool enableFlash(bool enable); //Toggle between RAM and FLASH/NVM storage. Returns false if the write failed
+  bool setDetectionSensitivity(uint8_t sensitivity); //Write DETECTION_SENSITIVITY. See the Operation Manual for values
 
   //Get distance measurement helper functions
   void takeRange();        //Initiate a distance measurement by writing to register 0x00
   void waitForBusy();      //Blocking function to wait until the LIDAR Lite's internal busy flag goes low
+  bool waitForBusy(uint32_t timeoutUs); //Same as waitForBusy() but gives up after timeoutUs microseconds (0 waits forever). Returns false on timeout
   uint8_t getBusyFlag();   //Read BUSY flag from device registers. Function will return 0x00 if not busy
-  uint16_t readDistance(); //Read and return the result of the most recent distance measurement in centimeters
+  uint16_t readDistance(); //Read and return the result of the most recent distance measurement in centimeters. Returns 0 if the read failed
+  uint16_t readDistance(LIDARLite_Sample &sample); //Same as readDistance(), also filling in sample with the acquisition midpoint and duration
 
   //Get distance measurement function
   uint16_t getDistance(); //Asks for, waits, and returns new measurement reading in centimeters
+  uint16_t getDistance(LIDARLite_Sample &sample); //Same as getDistance(), also filling in sample with the acquisition midpoint and duration
+  template <class Filter>
+  uint16_t getDistance(Filter &filter) { return filter.update(getDistance()); } //Same as getDistance(), passed through a filter from LIDARLite_v4LED_Filter.h
+
+  //Non-blocking measurement functions
+  bool startMeasurement();        //Trigger a measurement and return immediately. Returns false if the trigger was not acknowledged
+  uint8_t service();              //Advance the measurement state machine with at most one STATUS read. Returns the new state
+  bool measurementReady();        //Returns true if a completed measurement is waiting to be fetched. Does not touch the bus
+  uint16_t fetch();               //Return the latched distance in centimeters and go back to idle
+  uint16_t fetch(LIDARLite_Sample &sample); //Same as fetch(), also filling in sample with the acquisition midpoint and duration
+  template <class Filter>
+  uint16_t fetch(Filter &filter) { return filter.update(fetch()); } //Same as fetch(), passed through a filter from LIDARLite_v4LED_Filter.h. Call only when measurementReady()
+  uint8_t getMeasurementState();  //Returns the current LIDARLite_MeasurementState
+  void enableFusedReads(bool enable); //Make service() read STATUS and distance in one burst. Off by default
+
+  //Fused register reads
+  bool readStatusDistance(LIDARLite_Reading &reading); //Read STATUS through FULL_DELAY in one burst. Returns true if the device is idle and distance is valid
+  bool readTelemetry(LIDARLite_Reading &reading);      //Read both temperatures and the hardware version in one burst. Returns false if the read failed
+
+  //Continuous measurement functions
+  bool startContinuous(uint8_t measurementInterval);                          //Let the device measure on its own every measurementInterval * LIDARLITE_INTERVAL_UNIT_US. Returns false if it does not
+  bool stopContinuous();                                                       //Stop self-triggered measurements
+  uint8_t serviceContinuous();                                                 //Read the next measurement into the ring buffer once STATUS shows it finished. Returns the number of new samples
+  uint32_t getSamplePeriod();                                                  //Returns the measured microseconds between self-triggered measurements
+  uint32_t getMissedCount();                                                   //Returns the number of measurements the device finished that were never read
+  uint8_t samplesAvailable();                                                  //Returns the number of samples waiting in the ring buffer
+  bool readSample(LIDARLite_Sample &sample);                                   //Pop the oldest sample. Returns false if the ring buffer is empty
+  uint8_t readSamples(LIDARLite_SampleBlock &block, uint8_t sensorId = 0);     //Move as many samples as fit from the ring buffer to the end of block. Returns the number moved
+  uint32_t getOverrunCount();                                                  //Returns the number of samples dropped because the ring buffer was full
+
+#if LIDARLITE_ARDUINO
+  //Interrupt driven Gpio functions
+  bool beginInterrupt(uint8_t triggerPin, uint8_t monitorPin); //Attach an interrupt to the monitor pin. Returns false if the pin has no interrupt or all slots are used
+  void endInterrupt();                                          //Detach the monitor pin interrupt
+  void takeRangeInterrupt();                                    //Toggle the trigger pin and return without waiting for the acknowledge
+  bool interruptSampleAvailable();                              //Returns true if the interrupt has seen a finished measurement that was not read yet
+  bool readInterruptSample(LIDARLite_Sample &sample);           //Read the distance of the latest finished measurement. Returns false if there is none
+  uint32_t getInterruptDroppedCount();                          //Returns the number of completions replaced by a newer one before they were read
 
   //Gpio functions
   void takeRangeGpio(uint8_t triggerPin, uint8_t monitorPin); //Initiate a distance measurement by toggling the trigger pin
   void waitForBusyGpio(uint8_t monitorPin);                   //Blocking function to wait until the LIDAR Lite's internal busy flag goes low
+  bool waitForBusyGpio(uint8_t monitorPin, uint32_t timeoutUs); //Same as waitForBusyGpio() but gives up after timeoutUs microseconds. Returns false on timeout
   uint8_t getBusyFlagGpio(uint8_t monitorPin);                //Check BUSY status via Monitor pin. Function will return 0x00 if not busy
+#endif
+
+  //Wait statistics
+  uint16_t getLastWaitPolls(); //Returns the number of busy flag polls issued by the last wait
+  uint32_t getLastWaitTime();  //Returns the microseconds spent in the last wait
 
   // Extra functions if the user needs them
   // Only use these functions if you have read the datasheet an know what you're doing
@@ -109,11 +487,31 @@ public:
   bool enableHighAccuracyMode(bool enable); // By default, LIDAR operates in high accuracy mode. Disable high accuracy mode if you wish to operate in asynchronous mode.  
   bool factoryReset();    // Resets the NVM/Flash storage information back to default settings and executes a SoftDevice reset
 
+  //Register shadow cache
+  void enableShadowCache(bool enable); //Skip configuration writes that would not change the register. Off by default
+  void invalidateShadowCache();        //Forget all shadowed values so the next configuration writes always reach the device
+  uint32_t getShadowWritesSaved();     //Returns the number of configuration writes skipped by the shadow cache
+
+  //Fault handling
+  uint8_t getLastError();            //Returns the transport result of the last transaction: 0, a NACK code or LIDARLITE_TRANSPORT_SHORT_READ
+  uint8_t getConsecutiveFailures();  //Returns the number of failed transactions since the last successful one
+  bool restoreConfiguration();       //Write the configuration set since begin() back to a sensor that lost power. Returns true if every write was acknowledged
+
   //Internal I2C abstraction
   bool write(uint8_t regAddr, uint8_t *dataBytes, uint8_t numBytes); //Perform I2C write to the device. Can specify the number of bytes to be written
-  void read(uint8_t regAddr, uint8_t *dataBytes, uint8_t numBytes);  //Perform I2C read from device. Can specify the number of bytes to be read
+  bool read(uint8_t regAddr, uint8_t *dataBytes, uint8_t numBytes);  //Perform I2C read from device. Can specify the number of bytes to be read. Returns false if the read failed
 
-  void correlationRecordRead(int16_t *correlationArray, uint8_t numberOfReadings = 192);
+  bool correlationRecordRead(int16_t *correlationArray, uint8_t numberOfReadings = 192); //One 2 byte read per point. Returns false if a read failed
+  bool correlationRecordReadWindow(int16_t *window, uint8_t firstPoint, uint8_t numberOfReadings); //Read only points firstPoint to firstPoint + numberOfReadings - 1, stopping at the end of the window. Returns false if a read failed
 };
 
+#include "LIDARLite_v4LED_impl.h"
+
+//The driver every sketch uses, over LIDARLITE_DEFAULT_TRANSPORT. The Wire
+//based one is instantiated once in LIDARLite_v4LED.cpp.
+typedef LIDARLite_v4LED_T<> LIDARLite_v4LED;
+#if LIDARLITE_ARDUINO
+extern template class LIDARLite_v4LED_T<LIDARLite_WireTransport>;
+#endif
+
 #endif
@@ -0,0 +1,26 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Async.cpp
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "LIDARLite_v4LED_Async.h"
+
+#if LIDARLITE_ARDUINO
+//Compile the event loop for the Wire based driver once for every sketch
+template class LIDARLite_v4LED_Async_T<LIDARLite_WireTransport>;
+#endif
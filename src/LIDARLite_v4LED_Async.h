@@ -0,0 +1,150 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Async.h
+
+  Event loop for callback driven measurements across many sensors. measure()
+  queues a request and returns at once; service() advances every sensor's
+  non-blocking state machine and calls each request's callback as its
+  distance arrives. A sensor runs one acquisition at a time, so further
+  requests for it wait in the order they were made.
+
+  When compiled as C++20 with coroutine support (host builds, not the
+  Arduino toolchains), measure(sensor) also returns an awaitable, so a
+  coroutine can write:
+
+    LIDARLite_AsyncResult result = co_await loop.measure(sensor);
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef LIDARLite_v4LED_Async_h
+#define LIDARLite_v4LED_Async_h
+
+#include <stdint.h>
+#include "LIDARLite_v4LED.h"
+
+#ifndef LIDARLITE_ASYNC_MAX_PENDING
+#define LIDARLITE_ASYNC_MAX_PENDING 16 //Requests one loop can hold, queued and in flight together
+#endif
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && !defined(ARDUINO)
+#define LIDARLITE_ASYNC_COROUTINES 1
+#include <coroutine>
+#else
+#define LIDARLITE_ASYNC_COROUTINES 0
+#endif
+
+//Status passed to a measurement callback
+enum LIDARLite_AsyncStatus
+{
+  LIDARLITE_ASYNC_OK = 0,  //distance is valid
+  LIDARLITE_ASYNC_NACK,    //The device did not acknowledge the trigger or stopped answering during the measurement
+  LIDARLITE_ASYNC_TIMEOUT, //The measurement did not finish within the request's timeout
+  LIDARLITE_ASYNC_FULL,    //The loop had no room for the request (awaitable only)
+};
+
+struct LIDARLite_AsyncResult
+{
+  uint8_t status;    //LIDARLite_AsyncStatus
+  uint16_t distance; //Distance in centimeters when status is LIDARLITE_ASYNC_OK
+};
+
+//Called from service() when a request completes
+typedef void (*LIDARLite_DistanceCallback)(void *context, uint8_t status, uint16_t distance);
+
+template <class Transport = LIDARLITE_DEFAULT_TRANSPORT, class Stats = LIDARLite_NoStats>
+class LIDARLite_v4LED_Async_T
+{
+private:
+  enum
+  {
+    REQUEST_FREE = 0,
+    REQUEST_QUEUED,  //Waiting for the sensor to finish an earlier request
+    REQUEST_RUNNING, //Measurement triggered
+    REQUEST_FAILED,  //Trigger not acknowledged, completed by the next service()
+  };
+
+  struct Request
+  {
+    LIDARLite_v4LED_T<Transport, Stats> *sensor;
+    LIDARLite_DistanceCallback callback;
+    void *context;
+    uint32_t timeoutUs;      //0 waits forever
+    unsigned long startTime; //micros() when the measurement was triggered
+    uint32_t order;          //Queue position among requests for the same sensor
+    uint8_t state;
+  };
+
+  Request _requests[LIDARLITE_ASYNC_MAX_PENDING] = {}; //All REQUEST_FREE
+  uint16_t _pending = 0;   //Requests not REQUEST_FREE
+  uint32_t _nextOrder = 0; //order given to the next request
+
+  bool sensorRunning(LIDARLite_v4LED_T<Transport, Stats> *sensor); //A request for sensor is running or failed and not yet completed
+  void start(Request &request);
+  void complete(Request &request, uint8_t status, uint16_t distance);
+
+public:
+  bool measure(LIDARLite_v4LED_T<Transport, Stats> &sensor, LIDARLite_DistanceCallback callback,
+               void *context, uint32_t timeoutUs = 0); //Queue a measurement. Returns false if the loop is full
+  uint16_t service();                                  //Advance every request once. Returns the number completed
+  uint16_t getPending();                               //Returns the number of requests queued or in flight
+
+#if LIDARLITE_ASYNC_COROUTINES
+  //Awaitable returned by measure(sensor). Resumes the awaiting coroutine from service()
+  class Awaiter
+  {
+  private:
+    LIDARLite_v4LED_Async_T *_loop;
+    LIDARLite_v4LED_T<Transport, Stats> *_sensor;
+    uint32_t _timeoutUs;
+    LIDARLite_AsyncResult _result;
+    std::coroutine_handle<> _handle;
+
+    static void resume(void *context, uint8_t status, uint16_t distance)
+    {
+      Awaiter *awaiter = (Awaiter *)context;
+      awaiter->_result.status = status;
+      awaiter->_result.distance = distance;
+      awaiter->_handle.resume();
+    }
+
+  public:
+    Awaiter(LIDARLite_v4LED_Async_T *loop, LIDARLite_v4LED_T<Transport, Stats> *sensor, uint32_t timeoutUs)
+        : _loop(loop), _sensor(sensor), _timeoutUs(timeoutUs), _result{LIDARLITE_ASYNC_FULL, 0} {}
+
+    bool await_ready() { return false; }
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+      _handle = handle;
+      return _loop->measure(*_sensor, resume, this, _timeoutUs); //Not suspended if the loop is full
+    }
+    LIDARLite_AsyncResult await_resume() { return _result; }
+  };
+
+  Awaiter measure(LIDARLite_v4LED_T<Transport, Stats> &sensor, uint32_t timeoutUs = 0) //co_await a measurement
+  {
+    return Awaiter(this, &sensor, timeoutUs);
+  }
+#endif
+};
+
+#include "LIDARLite_v4LED_Async_impl.h"
+
+//Event loop for the Wire based driver. Instantiated once in LIDARLite_v4LED_Async.cpp.
+typedef LIDARLite_v4LED_Async_T<> LIDARLite_v4LED_Async;
+#if LIDARLITE_ARDUINO
+extern template class LIDARLite_v4LED_Async_T<LIDARLite_WireTransport>;
+#endif
+
+#endif
@@ -0,0 +1,182 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Async_impl.h
+
+  Member definitions of the LIDARLite_v4LED_Async_T class template.
+  Included at the end of LIDARLite_v4LED_Async.h; do not include this file
+  directly.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+
+#ifndef LIDARLite_v4LED_Async_impl_h
+#define LIDARLite_v4LED_Async_impl_h
+
+/*------------------------------------------------------------------------------
+  Measure
+
+  Queue a measurement on sensor. If the sensor is idle it is triggered right
+  away, otherwise the request waits behind the sensor's earlier requests.
+  callback is always called exactly once, from service() and never from this
+  call, even when the trigger is not acknowledged, so a callback that queues
+  a new request does not recurse however often the sensor fails.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  sensor:    sensor to measure with, already begin()'d. Must stay in scope.
+  callback:  function called with context, a LIDARLite_AsyncStatus and the
+             distance in centimeters
+  context:   passed to callback unchanged
+  timeoutUs: longest time in microseconds from trigger to result. 0 waits
+             forever.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_Async_T<Transport, Stats>::measure(LIDARLite_v4LED_T<Transport, Stats> &sensor,
+                                                        LIDARLite_DistanceCallback callback,
+                                                        void *context, uint32_t timeoutUs)
+{
+    for (uint16_t i = 0; i < LIDARLITE_ASYNC_MAX_PENDING; i++)
+    {
+        Request &request = _requests[i];
+        if (request.state != REQUEST_FREE)
+            continue;
+
+        request.sensor = &sensor;
+        request.callback = callback;
+        request.context = context;
+        request.timeoutUs = timeoutUs;
+        request.order = _nextOrder++;
+        request.state = REQUEST_QUEUED;
+        _pending++;
+
+        if (!sensorRunning(&sensor))
+            start(request);
+        return true;
+    }
+
+    return false;
+} /* LIDARLite_v4LED_Async::measure */
+
+/*------------------------------------------------------------------------------
+  Service
+
+  Call as often as possible from the main loop. Each in-flight request costs
+  one STATUS read (see LIDARLite_v4LED::service()); queued requests and free
+  slots cost nothing. A completed request starts the next queued request for
+  the same sensor before its callback runs. Requests whose trigger was not
+  acknowledged are completed here with LIDARLITE_ASYNC_NACK, in the order
+  they were made for each sensor.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_Async_T<Transport, Stats>::service()
+{
+    uint16_t completed = 0;
+
+    for (uint16_t i = 0; i < LIDARLITE_ASYNC_MAX_PENDING && _pending > 0; i++)
+    {
+        Request &request = _requests[i];
+        if (request.state == REQUEST_FAILED)
+        {
+            complete(request, LIDARLITE_ASYNC_NACK, 0);
+            completed++;
+            continue;
+        }
+        if (request.state != REQUEST_RUNNING)
+            continue;
+
+        LIDARLite_v4LED_T<Transport, Stats> *sensor = request.sensor;
+
+        if (sensor->service() == LIDARLITE_STATE_READY)
+        {
+            complete(request, LIDARLITE_ASYNC_OK, sensor->fetch());
+            completed++;
+        }
+        else if (sensor->getMeasurementState() == LIDARLITE_STATE_IDLE)
+        {
+            // The sensor stopped answering and abandoned the measurement
+            complete(request, LIDARLITE_ASYNC_NACK, 0);
+            completed++;
+        }
+        else if (request.timeoutUs != 0 && (uint32_t)(micros() - request.startTime) > request.timeoutUs)
+        {
+            complete(request, LIDARLITE_ASYNC_TIMEOUT, 0);
+            completed++;
+        }
+    }
+
+    return completed;
+} /* LIDARLite_v4LED_Async::service */
+
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_Async_T<Transport, Stats>::getPending()
+{
+    return _pending;
+}
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_Async_T<Transport, Stats>::sensorRunning(LIDARLite_v4LED_T<Transport, Stats> *sensor)
+{
+    for (uint16_t i = 0; i < LIDARLITE_ASYNC_MAX_PENDING; i++)
+        if ((_requests[i].state == REQUEST_RUNNING || _requests[i].state == REQUEST_FAILED) &&
+            _requests[i].sensor == sensor)
+            return true;
+    return false;
+}
+
+// A trigger that is not acknowledged leaves the request for service() to
+// complete. Completing it here would call back from inside measure() or
+// complete(), and a callback that queues again would recurse without bound
+template <class Transport, class Stats>
+void LIDARLite_v4LED_Async_T<Transport, Stats>::start(Request &request)
+{
+    request.startTime = micros();
+    if (request.sensor->startMeasurement())
+        request.state = REQUEST_RUNNING;
+    else
+        request.state = REQUEST_FAILED;
+}
+
+/*------------------------------------------------------------------------------
+  Complete
+
+  Free the request, start the oldest queued request for the same sensor, then
+  call the callback. The slot is freed first so the callback can queue a new
+  request, for example to measure continuously.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_Async_T<Transport, Stats>::complete(Request &request, uint8_t status, uint16_t distance)
+{
+    LIDARLite_DistanceCallback callback = request.callback;
+    void *context = request.context;
+    LIDARLite_v4LED_T<Transport, Stats> *sensor = request.sensor;
+    Request *next = NULL;
+
+    request.state = REQUEST_FREE;
+    _pending--;
+
+    for (uint16_t i = 0; i < LIDARLITE_ASYNC_MAX_PENDING; i++)
+    {
+        Request &queued = _requests[i];
+        if (queued.state == REQUEST_QUEUED && queued.sensor == sensor &&
+            (next == NULL || (int32_t)(queued.order - next->order) < 0))
+            next = &queued;
+    }
+    if (next != NULL)
+        start(*next);
+
+    callback(context, status, distance);
+} /* LIDARLite_v4LED_Async::complete */
+
+#endif
@@ -0,0 +1,120 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_AutoPreset.h
+
+  Picks the configure() preset automatically. Watches a window of recent
+  distances and uses the fastest preset whose range covers the target and
+  whose measured jitter stays within an accuracy target. Switches are only
+  considered once per full window, range changes use separate up/down
+  thresholds, and a preset left for being too noisy is not tried again for
+  a while, so the preset does not thrash at a boundary.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef LIDARLite_v4LED_AutoPreset_h
+#define LIDARLite_v4LED_AutoPreset_h
+
+#include <stdint.h>
+#include "LIDARLite_v4LED.h"
+
+//Number of distances judged together before a switch is considered
+#ifndef LIDARLITE_AUTO_WINDOW
+#define LIDARLITE_AUTO_WINDOW 8
+#endif
+
+//Windows during which a preset left for exceeding the accuracy target is not
+//stepped back down into. Override by defining it before including this header.
+#ifndef LIDARLITE_AUTO_HOLD_WINDOWS
+#define LIDARLITE_AUTO_HOLD_WINDOWS 16
+#endif
+
+//Number of switch decisions kept in the log
+#ifndef LIDARLITE_AUTO_LOG_SIZE
+#define LIDARLITE_AUTO_LOG_SIZE 8
+#endif
+
+//Presets in the ladder, see LIDARLite_v4LED_AutoPreset_impl.h
+#define LIDARLITE_AUTO_LEVELS 6
+
+//Why the auto preset switched
+enum LIDARLite_PresetReason
+{
+  LIDARLITE_REASON_RANGE_UP = 0,    //Target moved beyond the range of the current preset
+  LIDARLITE_REASON_RANGE_DOWN,      //Target is well within the range of a faster preset
+  LIDARLITE_REASON_ACCURACY,        //Jitter exceeded the accuracy target, slower preset chosen
+  LIDARLITE_REASON_SPEED,           //Jitter far below the accuracy target, faster preset chosen
+  LIDARLITE_REASON_SENSITIVITY_ON,  //Too many dropouts, detection sensitivity raised
+  LIDARLITE_REASON_SENSITIVITY_OFF, //Dropouts cleared, detection sensitivity restored
+};
+
+//One entry of the switch decision log
+struct LIDARLite_PresetSwitch
+{
+  unsigned long time; //millis() of the decision
+  uint8_t fromPreset; //configure() preset before the switch
+  uint8_t toPreset;   //configure() preset after the switch
+  uint8_t reason;     //LIDARLite_PresetReason
+  uint16_t median;    //Median distance of the window in centimeters
+  uint16_t jitter;    //Mean absolute deviation of the window in centimeters
+};
+
+template <class Transport = LIDARLITE_DEFAULT_TRANSPORT, class Stats = LIDARLite_NoStats>
+class LIDARLite_v4LED_AutoPreset_T
+{
+private:
+  LIDARLite_v4LED_T<Transport, Stats> *_sensor = NULL; //Sensor being configured, already begin()'d by the user
+  uint16_t _accuracy = 0;                              //Largest acceptable jitter in centimeters
+  uint8_t _level = 0;                                  //Index into the preset ladder, see LIDARLite_v4LED_AutoPreset_impl.h
+
+  uint16_t _window[LIDARLITE_AUTO_WINDOW]; //Distances since the last decision
+  uint8_t _count = 0;                      //Distances in _window
+  uint8_t _hold[LIDARLITE_AUTO_LEVELS];    //Windows left before each level may be stepped down into again
+
+  bool _sensitivityEnabled = false; //Switch DETECTION_SENSITIVITY on dropouts
+  bool _sensitive = false;          //True while the sensitive value is in use
+  uint8_t _normalSensitivity = 0;   //DETECTION_SENSITIVITY normally used
+  uint8_t _highSensitivity = 0;     //DETECTION_SENSITIVITY used while dropouts are frequent
+  uint8_t _dropoutLimit = 0;        //Dropouts per window that trigger the sensitive value
+
+  LIDARLite_PresetSwitch _log[LIDARLITE_AUTO_LOG_SIZE]; //Switch decisions, oldest at _logHead
+  uint8_t _logHead = 0;
+  uint8_t _logCount = 0;
+
+  static uint8_t ladderPreset(uint8_t level);
+  static uint16_t ladderRange(uint8_t level);
+  void evaluate();
+  void switchTo(uint8_t level, uint8_t reason, uint16_t median, uint16_t jitter);
+  void logSwitch(uint8_t fromPreset, uint8_t toPreset, uint8_t reason, uint16_t median, uint16_t jitter);
+
+public:
+  void begin(LIDARLite_v4LED_T<Transport, Stats> &sensor, uint16_t accuracyCm); //Start at the maximum range preset with an accuracy target in centimeters
+  void enableSensitivitySwitching(uint8_t normalSensitivity, uint8_t highSensitivity, uint8_t dropoutLimit); //Also switch DETECTION_SENSITIVITY when a window has dropoutLimit or more zero readings
+  uint16_t update(uint16_t distance); //Feed one distance, switching presets when a window completes. Returns the distance
+  uint16_t getDistance();             //Same as sensor.getDistance() followed by update()
+  uint8_t getPreset();                //Returns the configure() preset in use
+
+  uint8_t getLogCount();                      //Returns the number of unread switch decisions
+  bool readLog(LIDARLite_PresetSwitch &entry); //Pop the oldest switch decision. Returns false if the log is empty
+};
+
+#include "LIDARLite_v4LED_AutoPreset_impl.h"
+
+//Auto preset for the Wire based driver. Instantiated once in LIDARLite_v4LED_AutoPreset.cpp.
+typedef LIDARLite_v4LED_AutoPreset_T<> LIDARLite_v4LED_AutoPreset;
+#if LIDARLITE_ARDUINO
+extern template class LIDARLite_v4LED_AutoPreset_T<LIDARLite_WireTransport>;
+#endif
+
+#endif
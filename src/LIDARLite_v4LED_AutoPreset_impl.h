@@ -0,0 +1,321 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_AutoPreset_impl.h
+
+  Member definitions of the LIDARLite_v4LED_AutoPreset_T class template.
+  Included at the end of LIDARLite_v4LED_AutoPreset.h; do not include this
+  file directly.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+
+#ifndef LIDARLite_v4LED_AutoPreset_impl_h
+#define LIDARLite_v4LED_AutoPreset_impl_h
+
+/*------------------------------------------------------------------------------
+  Preset ladder
+
+  configure() presets ordered from fastest to slowest acquisition, with the
+  range in centimeters each is trusted to cover. Moving up the ladder trades
+  speed for range and accuracy. The ranges are conservative rules of thumb
+  for a typical target, not datasheet limits.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_AutoPreset_T<Transport, Stats>::ladderPreset(uint8_t level)
+{
+    static const uint8_t preset[LIDARLITE_AUTO_LEVELS] = {5, 2, 3, 1, 4, 0};
+    return preset[level];
+}
+
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_AutoPreset_T<Transport, Stats>::ladderRange(uint8_t level)
+{
+    static const uint16_t range[LIDARLITE_AUTO_LEVELS] = {100, 500, 1000, 1000, 4000, 4000};
+    return range[level];
+}
+
+/*------------------------------------------------------------------------------
+  Begin
+
+  Start at the maximum range preset, since nothing is known about the target
+  yet, and configure the sensor for it.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  sensor:     sensor to configure. Must stay in scope.
+  accuracyCm: largest acceptable mean absolute deviation of a window of
+              distances, in centimeters
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_AutoPreset_T<Transport, Stats>::begin(LIDARLite_v4LED_T<Transport, Stats> &sensor,
+                                                           uint16_t accuracyCm)
+{
+    _sensor = &sensor;
+    _accuracy = accuracyCm;
+    _level = LIDARLITE_AUTO_LEVELS - 1;
+    _count = 0;
+    _sensitive = false;
+    _logHead = 0;
+    for (uint8_t i = 0; i < LIDARLITE_AUTO_LEVELS; i++)
+        _hold[i] = 0;
+    _logCount = 0;
+
+    _sensor->configure(ladderPreset(_level));
+} /* LIDARLite_v4LED_AutoPreset::begin */
+
+/*------------------------------------------------------------------------------
+  Enable Sensitivity Switching
+
+  Also manage DETECTION_SENSITIVITY. A window with dropoutLimit or more zero
+  distances switches to highSensitivity; a later window with none switches
+  back to normalSensitivity.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  normalSensitivity: DETECTION_SENSITIVITY value normally used, 0x00 for the
+                     device default
+  highSensitivity:   DETECTION_SENSITIVITY value used while targets drop out
+  dropoutLimit:      zero distances per window that trigger highSensitivity
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_AutoPreset_T<Transport, Stats>::enableSensitivitySwitching(uint8_t normalSensitivity,
+                                                                                uint8_t highSensitivity,
+                                                                                uint8_t dropoutLimit)
+{
+    _sensitivityEnabled = true;
+    _normalSensitivity = normalSensitivity;
+    _highSensitivity = highSensitivity;
+    _dropoutLimit = (dropoutLimit == 0) ? 1 : dropoutLimit;
+    _sensitive = false;
+
+    _sensor->setDetectionSensitivity(_normalSensitivity);
+} /* LIDARLite_v4LED_AutoPreset::enableSensitivitySwitching */
+
+/*------------------------------------------------------------------------------
+  Update
+
+  Feed one distance. Once LIDARLITE_AUTO_WINDOW distances have been collected
+  the window is judged and the preset may change. Returns distance so the
+  call can wrap an existing read.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_AutoPreset_T<Transport, Stats>::update(uint16_t distance)
+{
+    _window[_count++] = distance;
+
+    if (_count == LIDARLITE_AUTO_WINDOW)
+    {
+        evaluate();
+        _count = 0;
+    }
+
+    return distance;
+} /* LIDARLite_v4LED_AutoPreset::update */
+
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_AutoPreset_T<Transport, Stats>::getDistance()
+{
+    return update(_sensor->getDistance());
+}
+
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_AutoPreset_T<Transport, Stats>::getPreset()
+{
+    return ladderPreset(_level);
+}
+
+/*------------------------------------------------------------------------------
+  Evaluate
+
+  Judge a full window. Zero distances are dropouts and are left out of the
+  median and jitter. Decisions, in order:
+
+  - Range up: fewer than half the distances are valid, which is what a
+    target beyond the current preset's range looks like. Step to the next
+    preset with a longer range; median and jitter are logged as 0.
+  - Range up: the median is past 90% of the current preset's range. Jump to
+    the first preset that covers it with the same margin.
+  - Accuracy: jitter is over the target. Step one preset slower, and hold
+    the preset just left for LIDARLITE_AUTO_HOLD_WINDOWS windows.
+  - Range down / speed: jitter is under half the target, the median is
+    under 75% of the next faster preset's range and that preset is not on
+    hold. Step one preset faster.
+
+  The gap between the up and down thresholds, together with judging only
+  whole windows, is the hysteresis for range. The hold is the hysteresis for
+  accuracy: a slower preset's jitter says nothing about the faster one's, so
+  without it a target that is too noisy for the faster preset but well
+  within the target on the slower one would switch back and forth every
+  window. After the hold the faster preset is tried again, since the target
+  or the conditions may have changed.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_AutoPreset_T<Transport, Stats>::evaluate()
+{
+    uint16_t sorted[LIDARLITE_AUTO_WINDOW];
+    uint8_t valid = 0;
+
+    // Insertion sort of the non-zero distances
+    for (uint8_t i = 0; i < LIDARLITE_AUTO_WINDOW; i++)
+    {
+        uint16_t d = _window[i];
+        if (d == 0)
+            continue;
+        uint8_t j = valid++;
+        while (j > 0 && sorted[j - 1] > d)
+        {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = d;
+    }
+
+    uint8_t dropouts = LIDARLITE_AUTO_WINDOW - valid;
+
+    for (uint8_t i = 0; i < LIDARLITE_AUTO_LEVELS; i++)
+        if (_hold[i] > 0)
+            _hold[i]--;
+
+    bool sensitivityRaised = false;
+    if (_sensitivityEnabled)
+    {
+        if (!_sensitive && dropouts >= _dropoutLimit)
+        {
+            if (_sensor->setDetectionSensitivity(_highSensitivity))
+            {
+                _sensitive = true;
+                sensitivityRaised = true;
+                logSwitch(getPreset(), getPreset(), LIDARLITE_REASON_SENSITIVITY_ON, 0, 0);
+            }
+        }
+        else if (_sensitive && dropouts == 0)
+        {
+            if (_sensor->setDetectionSensitivity(_normalSensitivity))
+            {
+                _sensitive = false;
+                logSwitch(getPreset(), getPreset(), LIDARLITE_REASON_SENSITIVITY_OFF, 0, 0);
+            }
+        }
+    }
+
+    // Mostly dropouts: a target beyond the current preset's range reads 0, so
+    // step to the next preset that reaches further, unless the sensitivity
+    // was just raised and gets this window to show whether it was enough
+    if (valid < LIDARLITE_AUTO_WINDOW / 2)
+    {
+        if (!sensitivityRaised)
+        {
+            uint8_t level = _level;
+            while (level < LIDARLITE_AUTO_LEVELS - 1 && ladderRange(level) <= ladderRange(_level))
+                level++;
+            if (ladderRange(level) > ladderRange(_level))
+                switchTo(level, LIDARLITE_REASON_RANGE_UP, 0, 0);
+        }
+        return;
+    }
+
+    uint16_t median = sorted[valid / 2];
+    uint32_t deviation = 0;
+    for (uint8_t i = 0; i < valid; i++)
+        deviation += (sorted[i] > median) ? sorted[i] - median : median - sorted[i];
+    uint16_t jitter = deviation / valid;
+
+    // Compare against 90% of the range without dividing
+    uint32_t scaledMedian = (uint32_t)median * 10;
+
+    if (scaledMedian > (uint32_t)ladderRange(_level) * 9)
+    {
+        uint8_t level = _level;
+        while (level < LIDARLITE_AUTO_LEVELS - 1 && scaledMedian > (uint32_t)ladderRange(level) * 9)
+            level++;
+        if (level != _level)
+            switchTo(level, LIDARLITE_REASON_RANGE_UP, median, jitter);
+    }
+    else if (jitter > _accuracy)
+    {
+        if (_level < LIDARLITE_AUTO_LEVELS - 1)
+        {
+            _hold[_level] = LIDARLITE_AUTO_HOLD_WINDOWS;
+            switchTo(_level + 1, LIDARLITE_REASON_ACCURACY, median, jitter);
+        }
+    }
+    else if (_level > 0 && _hold[_level - 1] == 0 && (uint32_t)jitter * 2 < _accuracy &&
+             (uint32_t)median * 4 < (uint32_t)ladderRange(_level - 1) * 3)
+    {
+        uint8_t reason = (ladderRange(_level - 1) < ladderRange(_level))
+                             ? LIDARLITE_REASON_RANGE_DOWN
+                             : LIDARLITE_REASON_SPEED;
+        switchTo(_level - 1, reason, median, jitter);
+    }
+} /* LIDARLite_v4LED_AutoPreset::evaluate */
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_AutoPreset_T<Transport, Stats>::switchTo(uint8_t level, uint8_t reason,
+                                                              uint16_t median, uint16_t jitter)
+{
+    uint8_t fromPreset = getPreset();
+
+    _level = level;
+    _sensor->configure(ladderPreset(_level));
+
+    logSwitch(fromPreset, getPreset(), reason, median, jitter);
+}
+
+/*------------------------------------------------------------------------------
+  Log Switch
+
+  Append a decision. When the log is full the oldest entry is overwritten.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_AutoPreset_T<Transport, Stats>::logSwitch(uint8_t fromPreset, uint8_t toPreset, uint8_t reason,
+                                                               uint16_t median, uint16_t jitter)
+{
+    uint8_t index;
+
+    if (_logCount == LIDARLITE_AUTO_LOG_SIZE)
+    {
+        index = _logHead;
+        _logHead = (_logHead + 1) % LIDARLITE_AUTO_LOG_SIZE;
+    }
+    else
+        index = (_logHead + _logCount++) % LIDARLITE_AUTO_LOG_SIZE;
+
+    _log[index].time = millis();
+    _log[index].fromPreset = fromPreset;
+    _log[index].toPreset = toPreset;
+    _log[index].reason = reason;
+    _log[index].median = median;
+    _log[index].jitter = jitter;
+} /* LIDARLite_v4LED_AutoPreset::logSwitch */
+
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_AutoPreset_T<Transport, Stats>::getLogCount()
+{
+    return _logCount;
+}
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_AutoPreset_T<Transport, Stats>::readLog(LIDARLite_PresetSwitch &entry)
+{
+    if (_logCount == 0)
+        return false;
+
+    entry = _log[_logHead];
+    _logHead = (_logHead + 1) % LIDARLITE_AUTO_LOG_SIZE;
+    _logCount--;
+    return true;
+} /* LIDARLite_v4LED_AutoPreset::readLog */
+
+#endif
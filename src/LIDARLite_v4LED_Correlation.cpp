@@ -0,0 +1,268 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Correlation.cpp
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "LIDARLite_v4LED_Correlation.h"
+
+/*------------------------------------------------------------------------------
+  Record scans
+
+  The searches below are split into a reduction over a contiguous range with
+  no branches and no early exit, which GCC and Clang vectorize at -O3 where
+  the target has SIMD (16 points per instruction with AVX2), and a scalar
+  pass that stops at the first point holding the reduced value. Finding the
+  first maximum with a single compare-and-remember loop would need the index
+  carried through every step, which keeps the loop scalar. Without SIMD the
+  index pass reads part of the record a second time, a few hundred cycles
+  on a 192 point record.
+------------------------------------------------------------------------------*/
+static int16_t largestValue(const int16_t *record, int from, int to)
+{
+    int16_t largest = record[from];
+    for (int i = from + 1; i < to; i++)
+        largest = (record[i] > largest) ? record[i] : largest;
+    return largest;
+}
+
+static int16_t smallestValue(const int16_t *record, int from, int to)
+{
+    int16_t smallest = record[from];
+    for (int i = from + 1; i < to; i++)
+        smallest = (record[i] < smallest) ? record[i] : smallest;
+    return smallest;
+}
+
+static uint16_t largestMagnitude(const int16_t *record, int from, int to)
+{
+    uint16_t largest = 0;
+    for (int i = from; i < to; i++)
+    {
+        uint16_t magnitude = (uint16_t)((record[i] < 0) ? -record[i] : record[i]);
+        largest = (magnitude > largest) ? magnitude : largest;
+    }
+    return largest;
+}
+
+static uint8_t firstIndexOf(const int16_t *record, int from, int16_t value)
+{
+    int i = from;
+    while (record[i] != value)
+        i++;
+    return i;
+}
+
+/*------------------------------------------------------------------------------
+  Find Zero Crossing
+
+  Locate the zero crossing of the bipolar correlation pulse and interpolate it
+  between record points. Integer arithmetic only, so it runs the same on AVR,
+  Cortex-M0 and a host machine. The lobes and the noise floor are found with
+  the vectorizable reductions above; only the index passes and the short run
+  between the lobes are scalar.
+
+  Process
+  ------------------------------------------------------------------------------
+  1.  The positive lobe is the first record maximum, the negative lobe the
+      first minimum that follows it.
+  2.  Between the two, find the first point i with record[i] > 0 and
+      record[i + 1] <= 0.
+  3.  Interpolate linearly: crossing = i + record[i] / (record[i] - record[i + 1])
+  4.  Confidence compares the pulse (peak - trough) with the largest magnitude
+      outside the pulse and its tails. A clean single return
+      saturates; a second return or heavy noise drives it towards 16 (1.0).
+
+  Parameters
+  ------------------------------------------------------------------------------
+  correlationArray: record from correlationRecordRead()
+  numberOfReadings: number of points in the record
+  result:           filled in with the crossing and its quality
+
+  Returns result.found.
+------------------------------------------------------------------------------*/
+bool LIDARLite_findZeroCrossing(const int16_t *correlationArray, uint8_t numberOfReadings,
+                                LIDARLite_ZeroCrossing &result)
+{
+    uint8_t i;
+    uint8_t peakIndex;
+    uint8_t troughIndex;
+    int16_t peak;
+    int16_t trough;
+
+    result.found = false;
+    result.crossing = 0;
+    result.peak = 0;
+    result.trough = 0;
+    result.confidence = 0;
+
+    if (numberOfReadings < 2)
+        return false;
+
+    // 1. Positive lobe, then the negative lobe after it. The trough search
+    //    starts at the peak, so with nothing lower after it the trough is the peak
+    peak = largestValue(correlationArray, 0, numberOfReadings);
+    peakIndex = firstIndexOf(correlationArray, 0, peak);
+    trough = smallestValue(correlationArray, peakIndex, numberOfReadings);
+    troughIndex = firstIndexOf(correlationArray, peakIndex, trough);
+
+    if (peak <= 0 || trough >= 0)
+        return false;
+
+    // 2. First sign change between the lobes
+    for (i = peakIndex; i < troughIndex; i++)
+    {
+        if (correlationArray[i] > 0 && correlationArray[i + 1] <= 0)
+            break;
+    }
+
+    // 3. Linear interpolation, Q8.8
+    int32_t above = correlationArray[i];
+    int32_t below = correlationArray[i + 1];
+    uint16_t fraction = (uint16_t)((above << 8) / (above - below));
+
+    result.crossing = ((uint16_t)i << 8) + fraction;
+    result.peak = peak;
+    result.trough = trough;
+    result.found = true;
+
+    // 4. Compare the pulse with whatever else is in the record. The lobes
+    //    have tails about as wide as the peak-to-trough spacing, skip those:
+    //    the noise floor comes from the points before and after them.
+    int width = troughIndex - peakIndex;
+    int pulseStart = peakIndex - width;
+    int pulseEnd = troughIndex + width + 1;
+    uint16_t noiseFloor = 0;
+    if (pulseStart > 0)
+        noiseFloor = largestMagnitude(correlationArray, 0, pulseStart);
+    if (pulseEnd < numberOfReadings)
+    {
+        uint16_t after = largestMagnitude(correlationArray, pulseEnd, numberOfReadings);
+        noiseFloor = (after > noiseFloor) ? after : noiseFloor;
+    }
+
+    uint32_t amplitude = (int32_t)peak - trough;
+    uint32_t confidence = (amplitude << 4) / (2 * (uint32_t)noiseFloor + 1);
+    result.confidence = (confidence > 255) ? 255 : confidence;
+
+    return true;
+} /* LIDARLite_findZeroCrossing */
+
+/*------------------------------------------------------------------------------
+  Crossing to Distance
+
+  Convert a crossing from LIDARLite_findZeroCrossing() into a distance in
+  1/256 cm. The spacing of record points depends on the device, so the
+  calibration has to be measured: record the crossing at two known distances
+  (or against the device's own FULL_DELAY over a range of targets) and fit
+  offset and cmPerPoint.
+------------------------------------------------------------------------------*/
+int32_t LIDARLite_crossingToDistance(uint16_t crossing, const LIDARLite_CorrelationCalibration &calibration)
+{
+    return calibration.offset + (((int32_t)crossing * calibration.cmPerPoint) >> 8);
+} /* LIDARLite_crossingToDistance */
+
+/*------------------------------------------------------------------------------
+  Distance to Point
+
+  Inverse of LIDARLite_crossingToDistance(): the record point at which the
+  zero crossing of a target at distance centimeters is expected, clamped to
+  the 192 point record. Use it to center correlationRecordReadWindow() on
+  the last measured distance.
+------------------------------------------------------------------------------*/
+uint8_t LIDARLite_distanceToPoint(uint16_t distance, const LIDARLite_CorrelationCalibration &calibration)
+{
+    if (calibration.cmPerPoint == 0)
+        return 0;
+
+    // Both sides in 1/256 cm, the Q8.8 scale of cmPerPoint cancels
+    int32_t point = (((int32_t)distance << 8) - calibration.offset) / calibration.cmPerPoint;
+
+    if (point < 0)
+        return 0;
+    if (point > 191)
+        return 191;
+    return point;
+} /* LIDARLite_distanceToPoint */
+
+/*------------------------------------------------------------------------------
+  Measure Signal Quality
+
+  Judge the return in a window of the correlation record, for example from
+  correlationRecordReadWindow(). The window should be at least three times
+  as wide as the pulse, otherwise nothing is left outside the pulse to
+  measure noise or a second return against.
+
+  Process
+  ------------------------------------------------------------------------------
+  1.  Main pulse, crossing and peak-to-noise ratio as in
+      LIDARLite_findZeroCrossing(), which reports the ratio as confidence.
+  2.  Locate the main lobes again to know which points belong to the pulse
+      and its tails.
+  3.  Any local maximum outside those points reaching half the main peak is
+      a second return.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  window:           points of the correlation record
+  numberOfReadings: number of points in window
+  result:           filled in with the quality of the return
+
+  Returns result.valid.
+------------------------------------------------------------------------------*/
+bool LIDARLite_measureSignalQuality(const int16_t *window, uint8_t numberOfReadings, LIDARLite_SignalQuality &result)
+{
+    LIDARLite_ZeroCrossing crossing;
+    uint8_t i;
+    uint8_t peakIndex;
+    uint8_t troughIndex;
+
+    result.valid = false;
+    result.peak = 0;
+    result.peakToNoise = 0;
+    result.secondPeak = false;
+
+    // 1. Main pulse
+    if (!LIDARLite_findZeroCrossing(window, numberOfReadings, crossing))
+        return false;
+
+    result.valid = true;
+    result.peak = crossing.peak;
+    result.peakToNoise = crossing.confidence;
+
+    // 2. Pulse extent, found the same way LIDARLite_findZeroCrossing() does
+    peakIndex = firstIndexOf(window, 0, crossing.peak);
+    troughIndex = firstIndexOf(window, peakIndex, crossing.trough);
+
+    uint8_t width = troughIndex - peakIndex;
+
+    // 3. Other positive lobes
+    for (i = 1; i + 1 < numberOfReadings; i++)
+    {
+        if ((uint16_t)i + width >= peakIndex && i <= (uint16_t)troughIndex + width)
+            continue;
+
+        int16_t value = window[i];
+        if (value >= window[i - 1] && value >= window[i + 1] && value > 0 && value >= crossing.peak / 2)
+        {
+            result.secondPeak = true;
+            break;
+        }
+    }
+
+    return true;
+} /* LIDARLite_measureSignalQuality */
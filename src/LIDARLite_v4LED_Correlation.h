@@ -0,0 +1,60 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Correlation.h
+
+  Fixed-point analysis of the correlation record returned by
+  correlationRecordRead(). The zero crossing of the bipolar correlation
+  waveform is the effective delay the device turns into FULL_DELAY; locating
+  it between record points gives a finer distance than the integer cm value.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef LIDARLite_v4LED_Correlation_h
+#define LIDARLite_v4LED_Correlation_h
+
+#include <stdint.h>
+
+//Result of LIDARLite_findZeroCrossing()
+struct LIDARLite_ZeroCrossing
+{
+  bool found;         //False if the record has no positive-to-negative pulse
+  uint16_t crossing;  //Position of the zero crossing in record points, Q8.8 fixed point (256 = one point)
+  int16_t peak;       //Largest value of the positive lobe
+  int16_t trough;     //Smallest value of the negative lobe
+  uint8_t confidence; //Pulse amplitude over twice the largest value outside the pulse, Q4.4 fixed point (16 = 1.0), saturates at 255
+};
+
+//Linear map from record points to centimeters, see LIDARLite_crossingToDistance()
+struct LIDARLite_CorrelationCalibration
+{
+  int32_t offset;      //Distance at record point 0 in 1/256 cm
+  uint16_t cmPerPoint; //Centimeters per record point, Q8.8 fixed point
+};
+
+//Result of LIDARLite_measureSignalQuality()
+struct LIDARLite_SignalQuality
+{
+  bool valid;          //False if the window has no positive-to-negative pulse
+  int16_t peak;        //Largest value of the main positive lobe
+  uint8_t peakToNoise; //Pulse amplitude over twice the largest value outside the pulse, Q4.4 fixed point (16 = 1.0), saturates at 255
+  bool secondPeak;     //Another positive lobe outside the main pulse reaches half its peak, a likely second return
+};
+
+bool LIDARLite_findZeroCrossing(const int16_t *correlationArray, uint8_t numberOfReadings, LIDARLite_ZeroCrossing &result); //Locate and interpolate the zero crossing of a correlation record
+int32_t LIDARLite_crossingToDistance(uint16_t crossing, const LIDARLite_CorrelationCalibration &calibration);           //Convert a Q8.8 crossing to a distance in 1/256 cm
+uint8_t LIDARLite_distanceToPoint(uint16_t distance, const LIDARLite_CorrelationCalibration &calibration);              //Record point where the crossing of a target at distance centimeters is expected
+bool LIDARLite_measureSignalQuality(const int16_t *window, uint8_t numberOfReadings, LIDARLite_SignalQuality &result);  //Peak amplitude, peak-to-noise ratio and second return flag of a record window
+
+#endif
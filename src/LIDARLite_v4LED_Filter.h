@@ -0,0 +1,280 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Filter.h
+
+  Statically sized, allocation-free filters for distance samples. Each stage
+  takes one distance in centimeters and returns the filtered distance, using
+  integer arithmetic only so it runs on AVR and Cortex-M0 without floating
+  point. Stages are chained at compile time with LIDARLite_FilterPipeline:
+
+    LIDARLite_FilterPipeline<LIDARLite_OutlierGate<50, 3>,
+                             LIDARLite_MedianFilter<5>,
+                             LIDARLite_EMAFilter<2> > filter;
+
+    uint16_t smoothed = myLIDAR.getDistance(filter);
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef LIDARLite_v4LED_Filter_h
+#define LIDARLite_v4LED_Filter_h
+
+#include <stdint.h>
+
+//Clamp a Q8 fixed-point centimeter value to a uint16_t centimeter result
+inline uint16_t LIDARLite_fromQ8(int32_t valueQ8)
+{
+  if (valueQ8 < 0)
+    return 0;
+  valueQ8 = (valueQ8 + 128) >> 8;
+  return (valueQ8 > 0xFFFF) ? 0xFFFF : (uint16_t)valueQ8;
+}
+
+/*------------------------------------------------------------------------------
+  Median Filter
+
+  Median of the last N samples. Keeps the window in arrival order and in
+  sorted order, so each sample costs one removal and one insertion into an
+  N-entry array. Before N samples have arrived, the median of what has
+  arrived is returned. Removes single-sample spikes without lagging steps.
+------------------------------------------------------------------------------*/
+template <uint8_t N>
+class LIDARLite_MedianFilter
+{
+  static_assert(N > 0, "Median window must hold at least one sample");
+
+private:
+  uint16_t _window[N]; //Samples in arrival order, oldest at _next once full
+  uint16_t _sorted[N]; //The same samples in ascending order
+  uint8_t _count = 0;  //Samples in the window
+  uint8_t _next = 0;   //Slot in _window the next sample replaces
+
+public:
+  void reset()
+  {
+    _count = 0;
+    _next = 0;
+  }
+
+  uint16_t update(uint16_t distance)
+  {
+    uint8_t i;
+
+    if (_count == N)
+    {
+      // Drop the oldest sample from the sorted copy
+      uint16_t oldest = _window[_next];
+      for (i = 0; _sorted[i] != oldest; i++)
+        ;
+      for (; i + 1 < _count; i++)
+        _sorted[i] = _sorted[i + 1];
+      _count--;
+    }
+
+    _window[_next] = distance;
+    _next = (_next + 1 == N) ? 0 : _next + 1;
+
+    // Insert the new sample into the sorted copy
+    for (i = _count; i > 0 && _sorted[i - 1] > distance; i--)
+      _sorted[i] = _sorted[i - 1];
+    _sorted[i] = distance;
+    _count++;
+
+    return _sorted[_count / 2];
+  }
+};
+
+/*------------------------------------------------------------------------------
+  Exponential Moving Average
+
+  y += (x - y) / 2^SHIFT, kept in Q8 fixed point so small steps are not lost
+  to rounding. SHIFT = 1 follows quickly, SHIFT = 4 smooths heavily. The first
+  sample initializes the average.
+------------------------------------------------------------------------------*/
+template <uint8_t SHIFT>
+class LIDARLite_EMAFilter
+{
+private:
+  int32_t _averageQ8 = 0; //Current average in 1/256 cm
+  bool _primed = false;   //False until the first sample has arrived
+
+public:
+  void reset()
+  {
+    _primed = false;
+  }
+
+  uint16_t update(uint16_t distance)
+  {
+    int32_t sampleQ8 = (int32_t)distance << 8;
+
+    if (_primed == false)
+    {
+      _averageQ8 = sampleQ8;
+      _primed = true;
+    }
+    else
+      _averageQ8 += (sampleQ8 - _averageQ8) >> SHIFT;
+
+    return LIDARLite_fromQ8(_averageQ8);
+  }
+};
+
+/*------------------------------------------------------------------------------
+  Outlier Gate
+
+  Rejects samples that differ from the last accepted sample by more than
+  MAX_STEP cm and repeats the last accepted value instead. After MAX_REJECTS
+  rejections in a row the gate assumes the target really moved and accepts
+  the new value, so it cannot lock onto a stale distance. getRejectCount()
+  reports the total number of rejected samples.
+------------------------------------------------------------------------------*/
+template <uint16_t MAX_STEP, uint8_t MAX_REJECTS>
+class LIDARLite_OutlierGate
+{
+private:
+  uint16_t _last = 0;          //Last accepted sample
+  bool _primed = false;        //False until the first sample has arrived
+  uint8_t _rejectsInRow = 0;   //Consecutive rejected samples
+  uint32_t _rejectCount = 0;   //Total rejected samples
+
+public:
+  void reset()
+  {
+    _primed = false;
+    _rejectsInRow = 0;
+  }
+
+  uint32_t getRejectCount()
+  {
+    return _rejectCount;
+  }
+
+  uint16_t update(uint16_t distance)
+  {
+    uint16_t step = (distance > _last) ? distance - _last : _last - distance;
+
+    if (_primed && step > MAX_STEP && _rejectsInRow < MAX_REJECTS)
+    {
+      _rejectsInRow++;
+      _rejectCount++;
+      return _last;
+    }
+
+    _primed = true;
+    _rejectsInRow = 0;
+    _last = distance;
+    return distance;
+  }
+};
+
+/*------------------------------------------------------------------------------
+  Constant Velocity Kalman Filter
+
+  Tracks distance and velocity (cm per sample) with the steady-state form of
+  the constant-velocity Kalman filter, where the gains have converged to
+  fixed values (also known as an alpha-beta filter):
+
+    predict:  d = d + v
+    update:   r = z - d;  d = d + alpha * r;  v = v + beta * r
+
+  ALPHA_Q8 and BETA_Q8 are the gains in 1/256 units. Larger gains trust the
+  measurements more. Good starting points are alpha 0.5 (128) with beta 0.1
+  (26) for a target that changes speed often, or alpha 0.25 (64) with beta
+  0.02 (5) for smooth motion. The state is kept in Q8 fixed point.
+------------------------------------------------------------------------------*/
+template <uint8_t ALPHA_Q8, uint8_t BETA_Q8>
+class LIDARLite_KalmanCVFilter
+{
+private:
+  int32_t _distanceQ8 = 0; //Estimated distance in 1/256 cm
+  int32_t _velocityQ8 = 0; //Estimated velocity in 1/256 cm per sample
+  bool _primed = false;    //False until the first sample has arrived
+
+public:
+  void reset()
+  {
+    _primed = false;
+  }
+
+  int32_t getVelocityQ8()
+  {
+    return _velocityQ8;
+  }
+
+  uint16_t update(uint16_t distance)
+  {
+    int32_t measurementQ8 = (int32_t)distance << 8;
+
+    if (_primed == false)
+    {
+      _distanceQ8 = measurementQ8;
+      _velocityQ8 = 0;
+      _primed = true;
+      return distance;
+    }
+
+    _distanceQ8 += _velocityQ8;
+
+    int32_t residual = measurementQ8 - _distanceQ8;
+    _distanceQ8 += (residual * ALPHA_Q8) >> 8;
+    _velocityQ8 += (residual * BETA_Q8) >> 8;
+
+    return LIDARLite_fromQ8(_distanceQ8);
+  }
+};
+
+/*------------------------------------------------------------------------------
+  Filter Pipeline
+
+  Runs each stage in order, feeding the output of one into the next. The
+  stages are members, so the whole pipeline is one statically sized object
+  with no heap use. stage() returns the first stage and next() the rest of
+  the pipeline, e.g. filter.next().stage() is the second stage.
+------------------------------------------------------------------------------*/
+template <class... Stages>
+class LIDARLite_FilterPipeline;
+
+template <>
+class LIDARLite_FilterPipeline<>
+{
+public:
+  void reset() {}
+  uint16_t update(uint16_t distance) { return distance; }
+};
+
+template <class First, class... Rest>
+class LIDARLite_FilterPipeline<First, Rest...>
+{
+private:
+  First _first;
+  LIDARLite_FilterPipeline<Rest...> _rest;
+
+public:
+  First &stage() { return _first; }
+  LIDARLite_FilterPipeline<Rest...> &next() { return _rest; }
+
+  void reset()
+  {
+    _first.reset();
+    _rest.reset();
+  }
+
+  uint16_t update(uint16_t distance)
+  {
+    return _rest.update(_first.update(distance));
+  }
+};
+
+#endif
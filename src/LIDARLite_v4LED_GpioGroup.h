@@ -0,0 +1,90 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_GpioGroup.h
+
+  Triggers several sensors through their trigger pins at the same moment and
+  collects their completions from the monitor pins, for time-coherent scans
+  with a sensor array. Where the core exposes port registers, trigger pins on
+  the same port are flipped by a single register write; elsewhere they are
+  flipped one digitalWrite() after another.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef LIDARLite_v4LED_GpioGroup_h
+#define LIDARLite_v4LED_GpioGroup_h
+
+#include <stdint.h>
+#include "LIDARLite_v4LED.h"
+
+#if LIDARLITE_ARDUINO
+
+#ifndef LIDARLITE_GROUP_MAX_SENSORS
+#define LIDARLITE_GROUP_MAX_SENSORS 8 //Maximum number of sensors in one group
+#endif
+
+//Use direct port writes when the core provides the AVR style port macros
+#if defined(portOutputRegister) && defined(digitalPinToPort) && defined(digitalPinToBitMask)
+#define LIDARLITE_GROUP_PORT_WRITES 1
+#else
+#define LIDARLITE_GROUP_PORT_WRITES 0
+#endif
+
+template <class Transport = LIDARLITE_DEFAULT_TRANSPORT, class Stats = LIDARLite_NoStats>
+class LIDARLite_v4LED_GpioGroup_T
+{
+private:
+  LIDARLite_v4LED_T<Transport, Stats> *_sensors[LIDARLITE_GROUP_MAX_SENSORS]; //Sensors in the group, already begin()'d by the user
+  uint8_t _triggerPin[LIDARLITE_GROUP_MAX_SENSORS];
+  uint8_t _monitorPin[LIDARLITE_GROUP_MAX_SENSORS];
+  uint8_t _numSensors = 0;
+
+#if LIDARLITE_GROUP_PORT_WRITES
+  typedef decltype(portOutputRegister(digitalPinToPort(0))) PortRegister;
+  PortRegister _portRegister[LIDARLITE_GROUP_MAX_SENSORS]; //Output register of each port holding a trigger pin
+  uint32_t _portMask[LIDARLITE_GROUP_MAX_SENSORS];         //Trigger pins of the group on that port
+  uint8_t _numPorts = 0;
+#endif
+
+  unsigned long _triggerTime = 0;                     //micros() just before the trigger pins were flipped
+  uint16_t _ackTime[LIDARLITE_GROUP_MAX_SENSORS];     //Microseconds from trigger to the monitor pin going busy
+  uint32_t _doneTime[LIDARLITE_GROUP_MAX_SENSORS];    //Microseconds from trigger to the monitor pin going idle
+  LIDARLite_Sample _sample[LIDARLITE_GROUP_MAX_SENSORS]; //Distance of the last scan, stamped with the group trigger
+  bool _acked[LIDARLITE_GROUP_MAX_SENSORS];           //Monitor pin went busy after the last trigger
+  bool _done[LIDARLITE_GROUP_MAX_SENSORS];            //Distance of the last scan was read
+
+public:
+  bool addSensor(LIDARLite_v4LED_T<Transport, Stats> &sensor, uint8_t triggerPin, uint8_t monitorPin); //Returns false if the group is full
+  uint8_t getNumSensors();
+
+  bool trigger(uint32_t ackTimeoutUs = 1000); //Flip every trigger pin at once and wait for every sensor to go busy. Returns false if one did not
+  bool wait(uint32_t timeoutUs = 0);          //Wait for every sensor to finish and read the distances. Returns false on timeout
+  bool scan(uint32_t timeoutUs = 0);          //trigger() followed by wait()
+
+  uint16_t getDistance(uint8_t index);       //Distance from the last scan in centimeters, 0 if the sensor did not finish
+  bool getSample(uint8_t index, LIDARLite_Sample &sample); //Sample from the last scan, timestamped at the middle of the acquisition. Returns false if the sensor did not finish
+  uint16_t getAckTime(uint8_t index);        //Microseconds from the trigger until the sensor acknowledged
+  uint32_t getCompletionTime(uint8_t index); //Microseconds from the trigger until the sensor finished
+  uint16_t getTriggerSkew();                 //Spread between the first and last acknowledgement in microseconds
+};
+
+#include "LIDARLite_v4LED_GpioGroup_impl.h"
+
+//GPIO group for the Wire based driver. Instantiated once in LIDARLite_v4LED_GpioGroup.cpp.
+typedef LIDARLite_v4LED_GpioGroup_T<> LIDARLite_v4LED_GpioGroup;
+extern template class LIDARLite_v4LED_GpioGroup_T<LIDARLite_WireTransport>;
+
+#endif
+
+#endif
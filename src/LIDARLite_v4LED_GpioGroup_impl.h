@@ -0,0 +1,280 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_GpioGroup_impl.h
+
+  Member definitions of the LIDARLite_v4LED_GpioGroup_T class template.
+  Included at the end of LIDARLite_v4LED_GpioGroup.h; do not include this
+  file directly.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+
+#ifndef LIDARLite_v4LED_GpioGroup_impl_h
+#define LIDARLite_v4LED_GpioGroup_impl_h
+
+/*------------------------------------------------------------------------------
+  Add Sensor
+
+  Add a sensor to the group and set up its pins. The sensor must already have
+  been set up with begin() on its own I2C address; the distance is still read
+  over I2C.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  sensor:     sensor to trigger. Must stay in scope.
+  triggerPin: digital output pin connected to trigger input of LIDAR-Lite
+  monitorPin: digital input pin connected to monitor output of LIDAR-Lite
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_GpioGroup_T<Transport, Stats>::addSensor(LIDARLite_v4LED_T<Transport, Stats> &sensor,
+                                                              uint8_t triggerPin, uint8_t monitorPin)
+{
+    if (_numSensors >= LIDARLITE_GROUP_MAX_SENSORS)
+        return false;
+
+    pinMode(triggerPin, OUTPUT);
+    pinMode(monitorPin, INPUT);
+
+    _sensors[_numSensors] = &sensor;
+    _triggerPin[_numSensors] = triggerPin;
+    _monitorPin[_numSensors] = monitorPin;
+    _sample[_numSensors].distance = 0;
+    _acked[_numSensors] = false;
+    _done[_numSensors] = false;
+    _numSensors++;
+
+#if LIDARLITE_GROUP_PORT_WRITES
+    // Merge the pin into the mask of its port
+    PortRegister reg = portOutputRegister(digitalPinToPort(triggerPin));
+    uint8_t port = 0;
+    while (port < _numPorts && _portRegister[port] != reg)
+        port++;
+    if (port == _numPorts)
+    {
+        _portRegister[port] = reg;
+        _portMask[port] = 0;
+        _numPorts++;
+    }
+    _portMask[port] |= digitalPinToBitMask(triggerPin);
+#endif
+
+    return true;
+} /* LIDARLite_v4LED_GpioGroup::addSensor */
+
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_GpioGroup_T<Transport, Stats>::getNumSensors()
+{
+    return _numSensors;
+}
+
+/*------------------------------------------------------------------------------
+  Trigger
+
+  Flip every trigger pin, then poll the monitor pins until each sensor has
+  acknowledged by going busy. Each acknowledgement time is the time of the
+  poll pass that saw it, so getTriggerSkew() includes up to one pass of
+  polling on top of the skew between the pin flips themselves.
+
+  Every sensor's trigger time is set to the group's, so its samples, here
+  and from readDistance(sample) after wait(), are timestamped from the
+  group trigger rather than from that sensor's last takeRange().
+
+  With port writes, the flips happen with interrupts off, one write per port
+  in use. Without, they happen back to back in digitalWrite() order.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  ackTimeoutUs: longest time to wait for the acknowledgements in microseconds
+
+  Returns true if every sensor acknowledged.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_GpioGroup_T<Transport, Stats>::trigger(uint32_t ackTimeoutUs)
+{
+    uint8_t waiting = _numSensors;
+
+    for (uint8_t i = 0; i < _numSensors; i++)
+    {
+        _acked[i] = false;
+        _done[i] = false;
+        _sample[i].distance = 0;
+    }
+
+    _triggerTime = micros();
+    for (uint8_t i = 0; i < _numSensors; i++)
+    {
+        _sensors[i]->_triggerTime = _triggerTime;
+        _sensors[i]->_busySeenTime = _triggerTime;
+    }
+
+#if LIDARLITE_GROUP_PORT_WRITES
+    noInterrupts();
+    for (uint8_t port = 0; port < _numPorts; port++)
+        *_portRegister[port] ^= _portMask[port];
+    interrupts();
+#else
+    for (uint8_t i = 0; i < _numSensors; i++)
+        digitalWrite(_triggerPin[i], digitalRead(_triggerPin[i]) ? LOW : HIGH);
+#endif
+
+    while (waiting > 0)
+    {
+        unsigned long pollTime = micros();
+        uint32_t elapsed = pollTime - _triggerTime;
+
+        for (uint8_t i = 0; i < _numSensors; i++)
+        {
+            if (!_acked[i] && _sensors[i]->getBusyFlagGpio(_monitorPin[i]))
+            {
+                _sensors[i]->_busySeenTime = pollTime;
+                _acked[i] = true;
+                _ackTime[i] = (elapsed > 0xFFFF) ? 0xFFFF : elapsed;
+                waiting--;
+            }
+        }
+
+        if (waiting > 0 && elapsed > ackTimeoutUs)
+            return false;
+    }
+
+    return true;
+} /* LIDARLite_v4LED_GpioGroup::trigger */
+
+/*------------------------------------------------------------------------------
+  Wait
+
+  Poll the monitor pins of the acknowledged sensors until every one is idle,
+  reading each distance over I2C as soon as its sensor finishes, so the reads
+  overlap with the sensors still acquiring. Each completion is estimated
+  between the last poll that saw the sensor busy and the first that saw it
+  idle, as waitForBusyGpio() does, and the sample is stamped with it.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  timeoutUs: longest time from the trigger in microseconds. 0 waits forever.
+
+  Returns true if every sensor acknowledged and finished.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_GpioGroup_T<Transport, Stats>::wait(uint32_t timeoutUs)
+{
+    uint8_t waiting = 0;
+    bool allAcked = true;
+
+    for (uint8_t i = 0; i < _numSensors; i++)
+    {
+        if (_acked[i] && !_done[i])
+            waiting++;
+        else if (!_acked[i])
+            allAcked = false;
+    }
+
+    while (waiting > 0)
+    {
+        for (uint8_t i = 0; i < _numSensors; i++)
+        {
+            if (!_acked[i] || _done[i])
+                continue;
+
+            LIDARLite_v4LED_T<Transport, Stats> *sensor = _sensors[i];
+            unsigned long pollTime = micros();
+            if (sensor->getBusyFlagGpio(_monitorPin[i]))
+            {
+                sensor->_busySeenTime = pollTime;
+                continue;
+            }
+
+            unsigned long idleSeenTime = micros();
+            sensor->noteCompletion(idleSeenTime);
+            sensor->Stats::onAcquisition(idleSeenTime - _triggerTime);
+            _doneTime[i] = idleSeenTime - _triggerTime;
+            sensor->readDistance(_sample[i]);
+            _done[i] = true;
+            waiting--;
+        }
+
+        if (waiting > 0 && timeoutUs != 0 && (uint32_t)(micros() - _triggerTime) > timeoutUs)
+            return false;
+    }
+
+    return allAcked;
+} /* LIDARLite_v4LED_GpioGroup::wait */
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_GpioGroup_T<Transport, Stats>::scan(uint32_t timeoutUs)
+{
+    bool acked = trigger();
+    return wait(timeoutUs) && acked;
+}
+
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_GpioGroup_T<Transport, Stats>::getDistance(uint8_t index)
+{
+    if (index >= _numSensors)
+        return 0;
+    return _sample[index].distance;
+}
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_GpioGroup_T<Transport, Stats>::getSample(uint8_t index, LIDARLite_Sample &sample)
+{
+    if (index >= _numSensors || !_done[index])
+        return false;
+    sample = _sample[index];
+    return true;
+}
+
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_GpioGroup_T<Transport, Stats>::getAckTime(uint8_t index)
+{
+    if (index >= _numSensors || !_acked[index])
+        return 0;
+    return _ackTime[index];
+}
+
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_GpioGroup_T<Transport, Stats>::getCompletionTime(uint8_t index)
+{
+    if (index >= _numSensors || !_done[index])
+        return 0;
+    return _doneTime[index];
+}
+
+/*------------------------------------------------------------------------------
+  Get Trigger Skew
+
+  Difference in microseconds between the earliest and the latest
+  acknowledgement of the last trigger(), over the sensors that acknowledged.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_GpioGroup_T<Transport, Stats>::getTriggerSkew()
+{
+    uint16_t first = 0xFFFF;
+    uint16_t last = 0;
+
+    for (uint8_t i = 0; i < _numSensors; i++)
+    {
+        if (!_acked[i])
+            continue;
+        if (_ackTime[i] < first)
+            first = _ackTime[i];
+        if (_ackTime[i] > last)
+            last = _ackTime[i];
+    }
+
+    return (last >= first) ? last - first : 0;
+} /* LIDARLite_v4LED_GpioGroup::getTriggerSkew */
+
+#endif
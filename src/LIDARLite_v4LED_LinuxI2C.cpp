@@ -0,0 +1,252 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_LinuxI2C.cpp
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "LIDARLite_v4LED_LinuxI2C.h"
+
+static int ioctlTransfer(int fd, struct i2c_rdwr_ioctl_data *transfer)
+{
+    return ioctl(fd, I2C_RDWR, transfer);
+}
+
+LIDARLite_LinuxI2CBus::LIDARLite_LinuxI2CBus()
+    : _transfer(ioctlTransfer)
+{
+}
+
+LIDARLite_LinuxI2CBus::~LIDARLite_LinuxI2CBus()
+{
+    close();
+}
+
+bool LIDARLite_LinuxI2CBus::open(const char *path)
+{
+    close();
+
+    _fd = ::open(path, O_RDWR);
+    _ownsFd = (_fd >= 0);
+    _zeroLengthProbe = true;
+    return _fd >= 0;
+}
+
+void LIDARLite_LinuxI2CBus::attach(int fd)
+{
+    close();
+
+    _fd = fd;
+    _ownsFd = false;
+    _zeroLengthProbe = true;
+}
+
+void LIDARLite_LinuxI2CBus::close()
+{
+    if (_ownsFd)
+        ::close(_fd);
+    _fd = -1;
+    _ownsFd = false;
+}
+
+bool LIDARLite_LinuxI2CBus::isOpen()
+{
+    return _fd >= 0;
+}
+
+void LIDARLite_LinuxI2CBus::setTransferFunction(TransferFunction transfer)
+{
+    _transfer = (transfer == NULL) ? ioctlTransfer : transfer;
+}
+
+uint32_t LIDARLite_LinuxI2CBus::getTransferCount()
+{
+    return _transfers;
+}
+
+void LIDARLite_LinuxI2CBus::clearTransferCount()
+{
+    _transfers = 0;
+}
+
+/*------------------------------------------------------------------------------
+  Transfer
+
+  Run the messages as one I2C_RDWR ioctl: the kernel issues them with repeated
+  starts in between and a single STOP at the end. Adapters report a missing
+  acknowledge as ENXIO or EREMOTEIO, which maps to LIDARLITE_LINUX_NACK.
+------------------------------------------------------------------------------*/
+uint8_t LIDARLite_LinuxI2CBus::transfer(struct i2c_msg *messages, uint8_t numMessages)
+{
+    struct i2c_rdwr_ioctl_data data;
+
+    if (_fd < 0)
+        return LIDARLITE_LINUX_ERROR;
+
+    data.msgs = messages;
+    data.nmsgs = numMessages;
+
+    _transfers++;
+    if (_transfer(_fd, &data) < 0)
+    {
+        if (errno == ENXIO || errno == EREMOTEIO)
+            return LIDARLITE_LINUX_NACK;
+        return LIDARLITE_LINUX_ERROR;
+    }
+
+    return 0;
+} /* LIDARLite_LinuxI2CBus::transfer */
+
+/*------------------------------------------------------------------------------
+  Probe
+
+  Check that a device acknowledges address with a zero length write, which
+  touches no register. Adapters with the I2C_AQ_NO_ZERO_LEN quirk refuse
+  that message with EOPNOTSUPP before anything goes on the wire; from then
+  on the probe is a one byte read, as i2cdetect -r does. The read moves the
+  device's register pointer, which every read() and write() sets anyway.
+------------------------------------------------------------------------------*/
+uint8_t LIDARLite_LinuxI2CBus::probe(uint8_t address)
+{
+    struct i2c_msg message;
+    uint8_t dataByte;
+
+    message.addr = address;
+    message.flags = 0;
+    message.len = 0;
+    message.buf = NULL;
+
+    if (_zeroLengthProbe)
+    {
+        uint8_t status = transfer(&message, 1);
+
+        // errno is still the ioctl's: transfer() makes no other call after it
+        if (status != LIDARLITE_LINUX_ERROR || _fd < 0 || errno != EOPNOTSUPP)
+            return status;
+        _zeroLengthProbe = false;
+    }
+
+    message.flags = I2C_M_RD;
+    message.len = 1;
+    message.buf = &dataByte;
+
+    return transfer(&message, 1);
+} /* LIDARLite_LinuxI2CBus::probe */
+
+/*------------------------------------------------------------------------------
+  Read Batch
+
+  Read the same registers from several sensors in one ioctl, for example
+  FULL_DELAY_LOW from every sensor after a group trigger. One syscall covers
+  up to LIDARLITE_LINUX_MAX_BATCH sensors. The transfer stops at the first
+  sensor that does not acknowledge, so on failure none of dataBytes should be
+  trusted.
+------------------------------------------------------------------------------*/
+uint8_t LIDARLite_LinuxI2CBus::readBatch(const uint8_t *addresses, uint8_t count, uint8_t regAddr,
+                                         uint8_t *dataBytes, uint8_t numBytes)
+{
+    struct i2c_msg messages[LIDARLITE_LINUX_MAX_BATCH * 2];
+    uint8_t reg = regAddr;
+
+    if (count == 0 || count > LIDARLITE_LINUX_MAX_BATCH)
+        return LIDARLITE_LINUX_ERROR;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        messages[2 * i].addr = addresses[i];
+        messages[2 * i].flags = 0;
+        messages[2 * i].len = 1;
+        messages[2 * i].buf = &reg;
+
+        messages[2 * i + 1].addr = addresses[i];
+        messages[2 * i + 1].flags = I2C_M_RD;
+        messages[2 * i + 1].len = numBytes;
+        messages[2 * i + 1].buf = dataBytes + i * numBytes;
+    }
+
+    return transfer(messages, count * 2);
+} /* LIDARLite_LinuxI2CBus::readBatch */
+
+LIDARLite_LinuxI2CBus &LIDARLite_LinuxI2CTransport::defaultPort()
+{
+    static LIDARLite_LinuxI2CBus unopened;
+    return unopened;
+}
+
+void LIDARLite_LinuxI2CTransport::begin(LIDARLite_LinuxI2CBus &bus)
+{
+    _bus = &bus;
+}
+
+uint8_t LIDARLite_LinuxI2CTransport::ping(uint8_t address)
+{
+    return _bus->probe(address);
+}
+
+uint8_t LIDARLite_LinuxI2CTransport::write(uint8_t address, uint8_t regAddr,
+                                           const uint8_t *dataBytes, uint8_t numBytes)
+{
+    uint8_t buffer[1 + 255];
+    struct i2c_msg message;
+
+    buffer[0] = regAddr;
+    memcpy(buffer + 1, dataBytes, numBytes);
+
+    message.addr = address;
+    message.flags = 0;
+    message.len = 1 + numBytes;
+    message.buf = buffer;
+
+    return _bus->transfer(&message, 1);
+} /* LIDARLite_LinuxI2CTransport::write */
+
+/*------------------------------------------------------------------------------
+  Read
+
+  Register write and repeated-start read in one ioctl. The kernel reads into
+  a scratch buffer first so dataBytes is left untouched on failure, as the
+  transport policy requires.
+------------------------------------------------------------------------------*/
+uint8_t LIDARLite_LinuxI2CTransport::read(uint8_t address, uint8_t regAddr,
+                                          uint8_t *dataBytes, uint8_t numBytes)
+{
+    uint8_t buffer[255];
+    struct i2c_msg messages[2];
+
+    messages[0].addr = address;
+    messages[0].flags = 0;
+    messages[0].len = 1;
+    messages[0].buf = &regAddr;
+
+    messages[1].addr = address;
+    messages[1].flags = I2C_M_RD;
+    messages[1].len = numBytes;
+    messages[1].buf = buffer;
+
+    uint8_t status = _bus->transfer(messages, 2);
+    if (status == 0)
+        memcpy(dataBytes, buffer, numBytes);
+
+    return status;
+} /* LIDARLite_LinuxI2CTransport::read */
+
+#endif
@@ -0,0 +1,105 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_LinuxI2C.h
+
+  Transport for Linux /dev/i2c-N character devices. Every read() and write()
+  is a single I2C_RDWR ioctl, with the register write and the repeated-start
+  read combined in one call, and readBatch() reads the same registers from
+  several sensors in one ioctl. Only built on Linux outside the Arduino
+  toolchains. Without an Arduino.h on the include path (LIDARLITE_ARDUINO 0)
+  this is the default transport, and LIDARLite_v4LED_Posix.h stands in for
+  the core.
+
+    LIDARLite_LinuxI2CBus bus;
+    bus.open("/dev/i2c-1");
+    LIDARLite_v4LED myLIDAR;
+    myLIDAR.begin(LIDARLITE_ADDR_DEFAULT, bus);
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef LIDARLite_v4LED_LinuxI2C_h
+#define LIDARLite_v4LED_LinuxI2C_h
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <stdint.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "LIDARLite_v4LED.h"
+
+//Most sensors one readBatch() can cover: two messages each, I2C_RDWR_IOCTL_MAX_MSGS per ioctl
+#define LIDARLITE_LINUX_MAX_BATCH (I2C_RDWR_IOCTL_MAX_MSGS / 2)
+
+//Status codes, matching the Wire::endTransmission() codes the driver already handles
+#define LIDARLITE_LINUX_NACK 2  //No device acknowledged the address
+#define LIDARLITE_LINUX_ERROR 4 //Any other ioctl failure, or the bus is not open
+
+//An open /dev/i2c-N, shared by every sensor on that bus
+class LIDARLite_LinuxI2CBus
+{
+public:
+  //Signature of the function that performs I2C_RDWR. Replace it to run against an in-process fake device
+  typedef int (*TransferFunction)(int fd, struct i2c_rdwr_ioctl_data *transfer);
+
+private:
+  int _fd = -1;
+  bool _ownsFd = false;
+  bool _zeroLengthProbe = true; //Adapter takes zero length writes, until it refuses one
+  TransferFunction _transfer;
+  uint32_t _transfers = 0; //ioctl calls made
+
+public:
+  LIDARLite_LinuxI2CBus();
+  ~LIDARLite_LinuxI2CBus();
+
+  //Owns its file descriptor: a copy would close it a second time
+  LIDARLite_LinuxI2CBus(const LIDARLite_LinuxI2CBus &) = delete;
+  LIDARLite_LinuxI2CBus &operator=(const LIDARLite_LinuxI2CBus &) = delete;
+
+  bool open(const char *path); //Open a bus such as "/dev/i2c-1". Returns false on failure
+  void attach(int fd);         //Use an already open file descriptor. It is not closed by close()
+  void close();
+  bool isOpen();
+
+  void setTransferFunction(TransferFunction transfer); //NULL restores the real ioctl()
+  uint32_t getTransferCount();                          //Returns the number of ioctl calls made, one per transaction group
+  void clearTransferCount();
+
+  uint8_t transfer(struct i2c_msg *messages, uint8_t numMessages); //Run messages as one combined transaction. Returns 0 or a status code above
+  uint8_t probe(uint8_t address);                                   //Check that address acknowledges. Returns 0 or a status code above
+
+  //Read numBytes from regAddr of every address in one ioctl. dataBytes holds count * numBytes bytes, sensor by sensor
+  uint8_t readBatch(const uint8_t *addresses, uint8_t count, uint8_t regAddr, uint8_t *dataBytes, uint8_t numBytes);
+};
+
+//Transport policy over a LIDARLite_LinuxI2CBus
+class LIDARLite_LinuxI2CTransport
+{
+private:
+  LIDARLite_LinuxI2CBus *_bus = NULL;
+
+public:
+  typedef LIDARLite_LinuxI2CBus Port;
+  static LIDARLite_LinuxI2CBus &defaultPort(); //A bus that is never opened; pass a real one to begin()
+
+  void begin(LIDARLite_LinuxI2CBus &bus);
+  uint8_t ping(uint8_t address);
+  uint8_t write(uint8_t address, uint8_t regAddr, const uint8_t *dataBytes, uint8_t numBytes);
+  uint8_t read(uint8_t address, uint8_t regAddr, uint8_t *dataBytes, uint8_t numBytes);
+};
+
+#endif
+
+#endif
@@ -0,0 +1,65 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Posix.h
+
+  The few Arduino core functions the driver uses, for builds without an
+  Arduino core (LIDARLITE_ARDUINO 0), such as a Linux host talking to the
+  sensor through LIDARLite_v4LED_LinuxI2C.h. micros() and millis() count from
+  an arbitrary point on the monotonic clock and, unlike on a microcontroller,
+  do not wrap in practice.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef LIDARLite_v4LED_Posix_h
+#define LIDARLite_v4LED_Posix_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+
+inline unsigned long micros()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (unsigned long)now.tv_sec * 1000000UL + (unsigned long)(now.tv_nsec / 1000);
+}
+
+inline unsigned long millis()
+{
+  return micros() / 1000;
+}
+
+//Sleep, resuming after signals so the full time always passes
+inline void delayMicroseconds(unsigned int us)
+{
+  struct timespec remaining;
+  remaining.tv_sec = us / 1000000;
+  remaining.tv_nsec = (long)(us % 1000000) * 1000;
+  while (nanosleep(&remaining, &remaining) != 0 && errno == EINTR)
+    ;
+}
+
+inline void delay(unsigned long ms)
+{
+  while (ms > 1000)
+  {
+    delayMicroseconds(1000000);
+    ms -= 1000;
+  }
+  delayMicroseconds((unsigned int)(ms * 1000));
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Power.h
+
+  Duty-cycle scheduler for battery powered sensors. Takes samples at a target
+  period and picks the power mode per sample: asynchronous mode (coprocessor
+  off between measurements) whenever its measured wake-up latency still fits
+  the latency budget, always-on mode otherwise.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef LIDARLite_v4LED_Power_h
+#define LIDARLite_v4LED_Power_h
+
+#include <stdint.h>
+#include "LIDARLite_v4LED.h"
+
+//While in always-on mode, try asynchronous mode again after this many samples
+#ifndef LIDARLITE_POWER_REPROBE_SAMPLES
+#define LIDARLITE_POWER_REPROBE_SAMPLES 64
+#endif
+
+template <class Transport = LIDARLITE_DEFAULT_TRANSPORT, class Stats = LIDARLite_NoStats>
+class LIDARLite_v4LED_PowerScheduler_T
+{
+private:
+  LIDARLite_v4LED_T<Transport, Stats> *_sensor = NULL; //Sensor being scheduled, already begin()'d by the user
+  uint32_t _samplePeriod = 0;                          //Target microseconds between samples
+  uint32_t _latencyBudget = 0;                         //Longest acceptable trigger-to-result time in microseconds
+
+  bool _async = false;                 //Power mode currently set on the sensor
+  unsigned long _lastSampleTime = 0;   //micros() of the last trigger
+  uint16_t _distance = 0;              //Most recent distance in centimeters
+  uint32_t _alwaysOnLatency = 0;       //Averaged trigger-to-result time in always-on mode
+  uint32_t _asyncLatency = 0;          //Averaged trigger-to-result time in asynchronous mode, 0 until measured
+  uint16_t _samplesSinceProbe = 0;     //Always-on samples since asynchronous mode was last tried
+  uint32_t _awakeTime = 0;             //Estimated coprocessor on-time in microseconds, see getDutyCycle()
+  uint32_t _totalTime = 0;             //Time covered by _awakeTime in microseconds
+  unsigned long _accountTime = 0;      //micros() up to which _totalTime has been counted
+  uint32_t _failedTriggers = 0;        //Due samples whose trigger was not acknowledged
+
+  bool setAsync(bool async);
+  bool asyncFits(); //The measured asynchronous latency, if any, fits the budget and the sample period
+  static uint32_t average(uint32_t average, uint32_t sample);
+
+public:
+  bool begin(LIDARLite_v4LED_T<Transport, Stats> &sensor, uint32_t samplePeriodUs, uint32_t latencyBudgetUs); //Start scheduling. Returns false if the sensor did not accept the power mode
+  bool service();            //Trigger a sample when one is due and collect it. Returns true when a new distance is ready
+  uint16_t getDistance();    //Returns the most recent distance in centimeters
+
+  bool isAsync();            //Returns true if the sensor is in asynchronous mode
+  uint32_t getWakeLatency(); //Returns the measured extra latency of asynchronous mode in microseconds, 0 if not measured yet
+  uint32_t getLatency();     //Returns the averaged trigger-to-result time of the current mode in microseconds
+  uint16_t getDutyCycle();   //Returns the estimated fraction of time the coprocessor is on, in 1/1000
+  uint32_t getFailedTriggerCount(); //Returns the number of due samples skipped because the trigger was not acknowledged
+};
+
+#include "LIDARLite_v4LED_Power_impl.h"
+
+//Power scheduler for the Wire based driver. Instantiated once in LIDARLite_v4LED_Power.cpp.
+typedef LIDARLite_v4LED_PowerScheduler_T<> LIDARLite_v4LED_PowerScheduler;
+#if LIDARLITE_ARDUINO
+extern template class LIDARLite_v4LED_PowerScheduler_T<LIDARLite_WireTransport>;
+#endif
+
+#endif
@@ -0,0 +1,255 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Power_impl.h
+
+  Member definitions of the LIDARLite_v4LED_PowerScheduler_T class template.
+  Included at the end of LIDARLite_v4LED_Power.h; do not include this file
+  directly.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+
+#ifndef LIDARLite_v4LED_Power_impl_h
+#define LIDARLite_v4LED_Power_impl_h
+
+/*------------------------------------------------------------------------------
+  Begin
+
+  Start scheduling a sensor. The sensor is put in always-on mode first so the
+  plain acquisition latency can be measured; after a few samples asynchronous
+  mode is tried and kept if it fits the budget.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  sensor:          sensor to schedule. Must stay in scope.
+  samplePeriodUs:  target time between samples in microseconds
+  latencyBudgetUs: longest acceptable time from trigger to result. Asynchronous
+                   mode is only used while its measured latency is within this
+                   and within samplePeriodUs.
+
+  Returns false if the sensor did not accept always-on mode.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_PowerScheduler_T<Transport, Stats>::begin(LIDARLite_v4LED_T<Transport, Stats> &sensor,
+                                                               uint32_t samplePeriodUs, uint32_t latencyBudgetUs)
+{
+    _sensor = &sensor;
+    _samplePeriod = samplePeriodUs;
+    _latencyBudget = latencyBudgetUs;
+    _alwaysOnLatency = 0;
+    _asyncLatency = 0;
+    _awakeTime = 0;
+    _totalTime = 0;
+    _failedTriggers = 0;
+    _accountTime = micros();
+    _lastSampleTime = _accountTime - samplePeriodUs; // First sample is due right away
+
+    // Probe asynchronous mode once always-on latency has settled a little
+    _samplesSinceProbe = LIDARLITE_POWER_REPROBE_SAMPLES - 4;
+
+    // The sensor's mode is not known yet, so write always-on mode regardless
+    _async = true;
+    bool success = setAsync(false);
+    _async = false;
+    return success;
+} /* LIDARLite_v4LED_PowerScheduler::begin */
+
+/*------------------------------------------------------------------------------
+  Service
+
+  Call as often as possible from loop(). When a sample is due, triggers it;
+  while it is in progress, advances the sensor's non-blocking state machine.
+  When the result arrives, its trigger-to-result latency updates the average
+  for the current mode and the mode for the next sample is chosen:
+
+  - Asynchronous mode is left as soon as its latency exceeds the budget or
+    the sample period, which it could then no longer keep.
+  - Always-on mode tries asynchronous mode again every
+    LIDARLITE_POWER_REPROBE_SAMPLES samples, if the last measured
+    asynchronous latency (if any) fitted both, so a temporary slowdown does
+    not lock the sensor in always-on mode.
+
+  A due sample whose trigger is not acknowledged is skipped and counted in
+  getFailedTriggerCount(); the next one is tried a sample period later, so a
+  missing sensor costs one address byte per period rather than per call.
+
+  Returns true when a new distance is ready.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_PowerScheduler_T<Transport, Stats>::service()
+{
+    if (_sensor == NULL)
+        return false;
+
+    uint8_t state = _sensor->service();
+
+    if (state == LIDARLITE_STATE_IDLE)
+    {
+        if (micros() - _lastSampleTime >= _samplePeriod)
+        {
+            _lastSampleTime = micros();
+            if (_sensor->startMeasurement() == false)
+                _failedTriggers++;
+        }
+        return false;
+    }
+
+    if (state != LIDARLITE_STATE_READY)
+        return false;
+
+    LIDARLite_Sample sample;
+    unsigned long now = micros();
+    uint32_t latency = now - _lastSampleTime;
+    uint32_t sinceAccount = now - _accountTime;
+    _distance = _sensor->fetch(sample);
+
+    // Keep the duty cycle a ratio over recent history without overflowing
+    _accountTime = now;
+    _totalTime += sinceAccount;
+    if (_totalTime > 0x40000000)
+    {
+        _totalTime >>= 1;
+        _awakeTime >>= 1;
+    }
+
+    if (_async)
+    {
+        _asyncLatency = average(_asyncLatency, latency);
+        _awakeTime += (sample.duration < sinceAccount) ? sample.duration : sinceAccount;
+
+        if (!asyncFits())
+            setAsync(false);
+    }
+    else
+    {
+        _alwaysOnLatency = average(_alwaysOnLatency, latency);
+        _awakeTime += sinceAccount;
+
+        if (++_samplesSinceProbe >= LIDARLITE_POWER_REPROBE_SAMPLES)
+        {
+            _samplesSinceProbe = 0;
+            if (_asyncLatency == 0 || asyncFits())
+            {
+                _asyncLatency = 0; // Measure afresh
+                setAsync(true);
+            }
+        }
+    }
+
+    return true;
+} /* LIDARLite_v4LED_PowerScheduler::service */
+
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_PowerScheduler_T<Transport, Stats>::getDistance()
+{
+    return _distance;
+}
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_PowerScheduler_T<Transport, Stats>::isAsync()
+{
+    return _async;
+}
+
+/*------------------------------------------------------------------------------
+  Get Wake Latency
+
+  Extra trigger-to-result time asynchronous mode costs over always-on mode,
+  from the averages of both. 0 until both modes have been measured.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_PowerScheduler_T<Transport, Stats>::getWakeLatency()
+{
+    if (_asyncLatency == 0 || _alwaysOnLatency == 0 || _asyncLatency < _alwaysOnLatency)
+        return 0;
+    return _asyncLatency - _alwaysOnLatency;
+}
+
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_PowerScheduler_T<Transport, Stats>::getLatency()
+{
+    return _async ? _asyncLatency : _alwaysOnLatency;
+}
+
+/*------------------------------------------------------------------------------
+  Get Duty Cycle
+
+  Estimated fraction of time the coprocessor has been powered, in 1/1000.
+  Time in always-on mode counts as on, time in asynchronous mode only from
+  each trigger to the completion service() saw on STATUS, which leaves out
+  the polling and the distance read. Older history is gradually
+  weighted down so the estimate never overflows.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_PowerScheduler_T<Transport, Stats>::getDutyCycle()
+{
+    uint32_t totalMs = _totalTime / 1000;
+
+    if (totalMs == 0)
+        return _async ? 0 : 1000;
+
+    uint32_t dutyCycle = _awakeTime / totalMs;
+    return (dutyCycle > 1000) ? 1000 : dutyCycle;
+} /* LIDARLite_v4LED_PowerScheduler::getDutyCycle */
+
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_PowerScheduler_T<Transport, Stats>::getFailedTriggerCount()
+{
+    return _failedTriggers;
+}
+
+/*------------------------------------------------------------------------------
+  Set Async
+
+  Switch the sensor's power mode. Asynchronous mode requires high accuracy
+  mode to be off, so it is disabled first and enabled again when returning
+  to always-on mode. Returns false if the sensor did not acknowledge, in
+  which case the mode is left as it was and the switch is tried again at the
+  next decision.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_PowerScheduler_T<Transport, Stats>::setAsync(bool async)
+{
+    bool success;
+
+    if (async == _async)
+        return true;
+
+    if (async)
+        success = _sensor->enableHighAccuracyMode(false) && _sensor->setPowerModeAsync();
+    else
+        success = _sensor->setPowerModeAlwaysOn() && _sensor->enableHighAccuracyMode(true);
+
+    if (success)
+        _async = async;
+    return success;
+} /* LIDARLite_v4LED_PowerScheduler::setAsync */
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_PowerScheduler_T<Transport, Stats>::asyncFits()
+{
+    return _asyncLatency <= _latencyBudget && _asyncLatency <= _samplePeriod;
+}
+
+// Running average with a weight of 1/4 for the new sample; the first sample seeds it
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_PowerScheduler_T<Transport, Stats>::average(uint32_t average, uint32_t sample)
+{
+    if (average == 0)
+        return sample;
+    return average - (average >> 2) + (sample >> 2);
+}
+
+#endif
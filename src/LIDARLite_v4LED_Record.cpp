@@ -0,0 +1,375 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Record.cpp
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <string.h>
+#include "LIDARLite_v4LED_Record.h"
+
+static const uint8_t recordMagic[4] = {'L', 'L', 'R', 0x01};
+
+#if LIDARLITE_ARDUINO
+
+/*------------------------------------------------------------------------------
+  Begin
+
+  Start a log on out by writing the header. The first record's time delta is
+  measured from this call.
+------------------------------------------------------------------------------*/
+bool LIDARLite_Recorder::begin(Print &out)
+{
+    _out = &out;
+    _bytesWritten = 0;
+    _dropped = 0;
+    _torn = false;
+
+    put(recordMagic, sizeof(recordMagic), NULL, 0, micros());
+    if (_dropped != 0 || _torn)
+    {
+        _out = NULL;
+        return false;
+    }
+    return true;
+} /* LIDARLite_Recorder::begin */
+
+void LIDARLite_Recorder::end()
+{
+    _out = NULL;
+}
+
+/*------------------------------------------------------------------------------
+  Put
+
+  Hand a record to the Print: its fixed fields from record, then its data
+  bytes, if any, straight from dataBytes. A Print that reports less room
+  than the whole record needs in availableForWrite() gets nothing and the
+  record is dropped; 0 is the Print default for "unknown", so the writes go
+  ahead then. A write that is only partly accepted tears the log: replay
+  stops at the torn record, so every later record is counted as dropped
+  instead of being written after it.
+
+  The previous record's time is only moved on when a record is written, so
+  the time deltas in the log still add up across dropped records.
+------------------------------------------------------------------------------*/
+void LIDARLite_Recorder::put(const uint8_t *record, uint8_t length,
+                             const uint8_t *dataBytes, uint8_t numBytes, unsigned long now)
+{
+    int room = _out->availableForWrite();
+
+    if (_torn || (room > 0 && room < length + numBytes))
+    {
+        _dropped++;
+        return;
+    }
+
+    size_t written = _out->write(record, length);
+    _bytesWritten += written;
+    if (written == length && numBytes > 0)
+    {
+        size_t dataWritten = _out->write(dataBytes, numBytes);
+        _bytesWritten += dataWritten;
+        written += dataWritten;
+    }
+
+    if (written != (size_t)length + numBytes)
+    {
+        _torn = true;
+        _dropped++;
+        return;
+    }
+    _lastTime = now;
+} /* LIDARLite_Recorder::put */
+
+/*------------------------------------------------------------------------------
+  Put Record Header
+
+  Fill in the type, the time since the previous record as unsigned LEB128
+  (7 bits per byte, high bit set on all but the last) and the address at the
+  start of record. Returns the number of bytes used, at most 7. A busy-poll
+  loop costs 2-3 bytes of time per record this way.
+------------------------------------------------------------------------------*/
+uint8_t LIDARLite_Recorder::putRecordHeader(uint8_t *record, uint8_t type, uint8_t address, unsigned long now)
+{
+    uint8_t length = 0;
+    uint32_t delta = now - _lastTime;
+
+    record[length++] = type;
+    while (delta >= 0x80)
+    {
+        record[length++] = (delta & 0x7F) | 0x80;
+        delta >>= 7;
+    }
+    record[length++] = delta;
+    record[length++] = address;
+
+    return length;
+} /* LIDARLite_Recorder::putRecordHeader */
+
+void LIDARLite_Recorder::recordPing(uint8_t address, uint8_t status)
+{
+    uint8_t record[7 + 1];
+    unsigned long now = micros();
+
+    if (_out == NULL)
+        return;
+
+    uint8_t length = putRecordHeader(record, LIDARLITE_RECORD_PING, address, now);
+    record[length++] = status;
+    put(record, length, NULL, 0, now);
+}
+
+void LIDARLite_Recorder::recordWrite(uint8_t address, uint8_t regAddr, uint8_t status,
+                                     const uint8_t *dataBytes, uint8_t numBytes)
+{
+    uint8_t record[LIDARLITE_RECORD_HEADER_SIZE];
+    unsigned long now = micros();
+
+    if (_out == NULL)
+        return;
+
+    uint8_t length = putRecordHeader(record, LIDARLITE_RECORD_WRITE, address, now);
+    record[length++] = regAddr;
+    record[length++] = status;
+    record[length++] = numBytes;
+    put(record, length, dataBytes, numBytes, now);
+}
+
+// The data of a failed read is not meaningful, so only its length is kept
+void LIDARLite_Recorder::recordRead(uint8_t address, uint8_t regAddr, uint8_t status,
+                                    const uint8_t *dataBytes, uint8_t numBytes)
+{
+    uint8_t record[LIDARLITE_RECORD_HEADER_SIZE];
+    unsigned long now = micros();
+
+    if (_out == NULL)
+        return;
+
+    uint8_t length = putRecordHeader(record, LIDARLITE_RECORD_READ, address, now);
+    record[length++] = regAddr;
+    record[length++] = status;
+    record[length++] = numBytes;
+    put(record, length, dataBytes, (status == 0) ? numBytes : 0, now);
+}
+
+void LIDARLite_Recorder::recordSample(uint8_t address, uint16_t distance)
+{
+    uint8_t record[7 + 2];
+    unsigned long now = micros();
+
+    if (_out == NULL)
+        return;
+
+    uint8_t length = putRecordHeader(record, LIDARLITE_RECORD_SAMPLE, address, now);
+    record[length++] = distance & 0xFF;
+    record[length++] = distance >> 8;
+    put(record, length, NULL, 0, now);
+}
+
+uint32_t LIDARLite_Recorder::getBytesWritten()
+{
+    return _bytesWritten;
+}
+
+uint32_t LIDARLite_Recorder::getDroppedRecords()
+{
+    return _dropped;
+}
+
+#endif
+
+LIDARLite_Recording &LIDARLite_ReplayTransport::defaultPort()
+{
+    static LIDARLite_Recording empty = {NULL, 0};
+    return empty;
+}
+
+/*------------------------------------------------------------------------------
+  Begin
+
+  Start replaying recording from its first record. A recording without a
+  valid header replays as empty, so every request is a mismatch.
+------------------------------------------------------------------------------*/
+void LIDARLite_ReplayTransport::begin(LIDARLite_Recording &recording)
+{
+    _data = recording.data;
+    _length = recording.length;
+    _position = sizeof(recordMagic);
+    _recordedTime = 0;
+    _mismatches = 0;
+
+    if (_length < sizeof(recordMagic) || memcmp(_data, recordMagic, sizeof(recordMagic)) != 0)
+        _length = 0;
+} /* LIDARLite_ReplayTransport::begin */
+
+bool LIDARLite_ReplayTransport::getByte(uint8_t &value)
+{
+    if (_position >= _length)
+        return false;
+    value = _data[_position++];
+    return true;
+}
+
+/*------------------------------------------------------------------------------
+  Next Record
+
+  Read the next record into record, leaving data pointing into the
+  recording. Returns false at the end of the recording or on a truncated
+  record, which is what an interrupted write to an SD card leaves behind.
+------------------------------------------------------------------------------*/
+bool LIDARLite_ReplayTransport::nextRecord(Record &record)
+{
+    uint32_t delta = 0;
+    uint8_t shift = 0;
+    uint8_t value;
+
+    if (!getByte(record.type))
+        return false;
+
+    do
+    {
+        if (!getByte(value))
+            return false;
+        if (shift < 32)
+            delta |= (uint32_t)(value & 0x7F) << shift;
+        shift += 7;
+    } while (value & 0x80);
+
+    if (!getByte(record.address))
+        return false;
+
+    record.regAddr = 0;
+    record.status = 0;
+    record.numBytes = 0;
+    record.dataBytes = NULL;
+
+    switch (record.type)
+    {
+    case LIDARLITE_RECORD_PING:
+        if (!getByte(record.status))
+            return false;
+        break;
+
+    case LIDARLITE_RECORD_WRITE:
+    case LIDARLITE_RECORD_READ:
+        if (!getByte(record.regAddr) || !getByte(record.status) || !getByte(record.numBytes))
+            return false;
+        if (record.type == LIDARLITE_RECORD_WRITE || record.status == 0)
+        {
+            if (_length - _position < record.numBytes)
+                return false;
+            record.dataBytes = _data + _position;
+            _position += record.numBytes;
+        }
+        break;
+
+    case LIDARLITE_RECORD_SAMPLE:
+        if (_length - _position < 2)
+            return false;
+        record.dataBytes = _data + _position;
+        _position += 2;
+        break;
+
+    default: // Unknown type, the rest cannot be parsed
+        _position = _length;
+        return false;
+    }
+
+    _recordedTime += delta;
+    return true;
+} /* LIDARLite_ReplayTransport::nextRecord */
+
+uint8_t LIDARLite_ReplayTransport::ping(uint8_t address)
+{
+    Record record;
+
+    if (!nextRecord(record) || record.type != LIDARLITE_RECORD_PING || record.address != address)
+    {
+        _mismatches++;
+        return LIDARLITE_REPLAY_MISMATCH;
+    }
+    return record.status;
+}
+
+// The driver must write exactly what was recorded
+uint8_t LIDARLite_ReplayTransport::write(uint8_t address, uint8_t regAddr,
+                                         const uint8_t *dataBytes, uint8_t numBytes)
+{
+    Record record;
+
+    if (!nextRecord(record) || record.type != LIDARLITE_RECORD_WRITE || record.address != address ||
+        record.regAddr != regAddr || record.numBytes != numBytes ||
+        memcmp(record.dataBytes, dataBytes, numBytes) != 0)
+    {
+        _mismatches++;
+        return LIDARLITE_REPLAY_MISMATCH;
+    }
+    return record.status;
+} /* LIDARLite_ReplayTransport::write */
+
+uint8_t LIDARLite_ReplayTransport::read(uint8_t address, uint8_t regAddr,
+                                        uint8_t *dataBytes, uint8_t numBytes)
+{
+    Record record;
+
+    if (!nextRecord(record) || record.type != LIDARLITE_RECORD_READ || record.address != address ||
+        record.regAddr != regAddr || record.numBytes != numBytes)
+    {
+        _mismatches++;
+        return LIDARLITE_REPLAY_MISMATCH;
+    }
+
+    if (record.status == 0)
+        memcpy(dataBytes, record.dataBytes, numBytes);
+    return record.status;
+} /* LIDARLite_ReplayTransport::read */
+
+/*------------------------------------------------------------------------------
+  Verify Sample
+
+  Consume the next record, which must be the SAMPLE logged after the reads
+  just replayed, and compare it with the distance the driver decoded. This
+  is the regression check: a change in the driver that alters the decoded
+  distance, or the transactions leading to it, shows up as a mismatch.
+------------------------------------------------------------------------------*/
+bool LIDARLite_ReplayTransport::verifySample(uint16_t distance)
+{
+    Record record;
+
+    if (!nextRecord(record) || record.type != LIDARLITE_RECORD_SAMPLE ||
+        (record.dataBytes[0] | (record.dataBytes[1] << 8)) != distance)
+    {
+        _mismatches++;
+        return false;
+    }
+    return true;
+} /* LIDARLite_ReplayTransport::verifySample */
+
+uint32_t LIDARLite_ReplayTransport::getRecordedTime()
+{
+    return _recordedTime;
+}
+
+uint32_t LIDARLite_ReplayTransport::getMismatches()
+{
+    return _mismatches;
+}
+
+bool LIDARLite_ReplayTransport::atEnd()
+{
+    return _position >= _length;
+}
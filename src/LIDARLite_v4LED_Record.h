@@ -0,0 +1,185 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Record.h
+
+  Recording and replay of bus sessions. LIDARLite_RecordingTransport wraps
+  another transport and streams every transaction to a LIDARLite_Recorder,
+  which writes a compact append-only binary log to any Print (an SD card
+  File, Serial...). LIDARLite_ReplayTransport feeds such a log back through
+  an unmodified driver so a field session can be reproduced offline.
+
+  Replay reproduces results, not timing: every transaction gets the recorded
+  status and data, so the driver decodes the same distances from the same
+  reads, but micros() runs at host speed. Code whose bus traffic depends on
+  time, such as a waitForBusy() timeout or the continuous mode read
+  schedule, can issue a different sequence on replay and then reports
+  mismatches. getRecordedTime() gives the time the recording covered.
+
+  Format: the 4 byte header "LLR" 0x01, then one record per transaction:
+
+    type         1 byte, LIDARLITE_RECORD_*
+    time delta   microseconds since the previous record, unsigned LEB128
+    PING         address, status
+    WRITE        address, regAddr, status, numBytes, data[numBytes]
+    READ         address, regAddr, status, numBytes, data[numBytes] if status is 0
+    SAMPLE       address, distance low byte, distance high byte
+
+  The replay transport needs no Arduino core and is built on Linux as well;
+  the recorder writes to a Print and is Arduino only.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef LIDARLite_v4LED_Record_h
+#define LIDARLite_v4LED_Record_h
+
+#include <stdint.h>
+#include "LIDARLite_v4LED.h"
+
+//Record types
+#define LIDARLITE_RECORD_PING 0x01
+#define LIDARLITE_RECORD_WRITE 0x02
+#define LIDARLITE_RECORD_READ 0x03
+#define LIDARLITE_RECORD_SAMPLE 0x04
+
+//Status returned by the replay transport when the driver's request does not match the recording
+#define LIDARLITE_REPLAY_MISMATCH 4
+
+//Longest record: type, 5 byte time delta, address, regAddr, status, numBytes and 255 data bytes
+#define LIDARLITE_RECORD_MAX_SIZE (7 + 3 + 255)
+
+//Longest record without its data bytes
+#define LIDARLITE_RECORD_HEADER_SIZE (7 + 3)
+
+//A recording held in memory, the Port of the replay transport
+struct LIDARLite_Recording
+{
+  const uint8_t *data; //Log as written by LIDARLite_Recorder, header included
+  uint32_t length;     //Bytes in data
+};
+
+//Transport that answers the driver from a recording instead of a bus
+class LIDARLite_ReplayTransport
+{
+private:
+  const uint8_t *_data = NULL;
+  uint32_t _length = 0;
+  uint32_t _position = 0;      //Offset of the next record in _data
+  uint32_t _recordedTime = 0;  //Sum of the time deltas replayed so far
+  uint32_t _mismatches = 0;    //Requests that did not match the recording
+
+  struct Record
+  {
+    uint8_t type;
+    uint8_t address;
+    uint8_t regAddr;
+    uint8_t status;
+    uint8_t numBytes;
+    const uint8_t *dataBytes; //Points into the recording
+  };
+
+  bool getByte(uint8_t &value);
+  bool nextRecord(Record &record);
+
+public:
+  typedef LIDARLite_Recording Port;
+  static LIDARLite_Recording &defaultPort(); //An empty recording
+
+  void begin(LIDARLite_Recording &recording);
+  uint8_t ping(uint8_t address);
+  uint8_t write(uint8_t address, uint8_t regAddr, const uint8_t *dataBytes, uint8_t numBytes);
+  uint8_t read(uint8_t address, uint8_t regAddr, uint8_t *dataBytes, uint8_t numBytes);
+
+  bool verifySample(uint16_t distance); //Consume the next SAMPLE record. Returns true if it holds distance
+  uint32_t getRecordedTime();           //Microseconds from the start of the recording to the last replayed record
+  uint32_t getMismatches();             //Requests or samples that did not match the recording
+  bool atEnd();                         //True once every record has been replayed
+};
+
+#if LIDARLITE_ARDUINO
+
+//Writes the binary log. The fixed fields of a record are built in a small
+//buffer and the data bytes are written straight from the caller's, so a
+//record takes at most two write() calls and no record-sized stack buffer.
+//A record is written whole or counted as dropped.
+class LIDARLite_Recorder
+{
+private:
+  Print *_out = NULL;          //Destination of the log
+  unsigned long _lastTime = 0; //micros() of the previous record written
+  uint32_t _bytesWritten = 0;  //Bytes accepted by _out, header included
+  uint32_t _dropped = 0;       //Records not written
+  bool _torn = false;          //_out accepted part of a record, so nothing after it could be parsed
+
+  uint8_t putRecordHeader(uint8_t *record, uint8_t type, uint8_t address, unsigned long now);
+  void put(const uint8_t *record, uint8_t length, const uint8_t *dataBytes, uint8_t numBytes, unsigned long now);
+
+public:
+  bool begin(Print &out); //Write the header. Returns false if out did not accept it
+  void end();             //Stop recording. Later records are ignored
+
+  void recordPing(uint8_t address, uint8_t status);
+  void recordWrite(uint8_t address, uint8_t regAddr, uint8_t status, const uint8_t *dataBytes, uint8_t numBytes);
+  void recordRead(uint8_t address, uint8_t regAddr, uint8_t status, const uint8_t *dataBytes, uint8_t numBytes);
+  void recordSample(uint8_t address, uint16_t distance); //Log a decoded distance, e.g. the result of getDistance()
+
+  uint32_t getBytesWritten();
+  uint32_t getDroppedRecords(); //Records not written because out had no room, or after a torn write
+};
+
+//Transport that passes everything to Inner and logs it to a recorder set with setRecorder()
+template <class Inner = LIDARLite_WireTransport>
+class LIDARLite_RecordingTransport
+{
+private:
+  Inner _inner;
+  LIDARLite_Recorder *_recorder = NULL;
+
+public:
+  typedef typename Inner::Port Port;
+  static Port &defaultPort() { return Inner::defaultPort(); }
+
+  void setRecorder(LIDARLite_Recorder *recorder) { _recorder = recorder; } //NULL stops logging
+  Inner &getInner() { return _inner; }
+
+  void begin(Port &port) { _inner.begin(port); }
+
+  uint8_t ping(uint8_t address)
+  {
+    uint8_t status = _inner.ping(address);
+    if (_recorder != NULL)
+      _recorder->recordPing(address, status);
+    return status;
+  }
+
+  uint8_t write(uint8_t address, uint8_t regAddr, const uint8_t *dataBytes, uint8_t numBytes)
+  {
+    uint8_t status = _inner.write(address, regAddr, dataBytes, numBytes);
+    if (_recorder != NULL)
+      _recorder->recordWrite(address, regAddr, status, dataBytes, numBytes);
+    return status;
+  }
+
+  uint8_t read(uint8_t address, uint8_t regAddr, uint8_t *dataBytes, uint8_t numBytes)
+  {
+    uint8_t status = _inner.read(address, regAddr, dataBytes, numBytes);
+    if (_recorder != NULL)
+      _recorder->recordRead(address, regAddr, status, dataBytes, numBytes);
+    return status;
+  }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,133 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Scheduler.h
+
+  Runs several LIDAR-Lite v4 sensors that share one I2C bus in parallel.
+  All acquisitions are started together and each sensor is restarted as soon
+  as its result has been collected, so the aggregate sample rate grows with
+  the number of sensors instead of staying fixed as it does when calling
+  getDistance() on each sensor in turn.
+
+  A sensor that keeps failing is quarantined and only probed now and then,
+  so it costs the healthy sensors almost no bus time, and is brought back
+  with its configuration restored once it answers again.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+#ifndef LIDARLite_v4LED_Scheduler_h
+#define LIDARLite_v4LED_Scheduler_h
+
+#include <stdint.h>
+#include "LIDARLite_v4LED.h"
+
+#ifndef LIDARLITE_SCHEDULER_MAX_SENSORS
+#define LIDARLITE_SCHEDULER_MAX_SENSORS 8 //Maximum number of sensors one scheduler can run
+#endif
+
+//Default fault policy, see setFaultPolicy()
+#ifndef LIDARLITE_HEALTH_FAILURE_THRESHOLD
+#define LIDARLITE_HEALTH_FAILURE_THRESHOLD 3 //Failed measurements in a row before a sensor is quarantined
+#endif
+#ifndef LIDARLITE_HEALTH_TIMEOUT_US
+#define LIDARLITE_HEALTH_TIMEOUT_US 100000 //A measurement still busy after this many microseconds has failed
+#endif
+
+//A quarantined sensor is probed after LIDARLITE_RETRY_MIN_US, then the wait
+//doubles after every probe that goes unanswered, up to LIDARLITE_RETRY_MAX_US.
+#ifndef LIDARLITE_RETRY_MIN_US
+#define LIDARLITE_RETRY_MIN_US 10000
+#endif
+#ifndef LIDARLITE_RETRY_MAX_US
+#define LIDARLITE_RETRY_MAX_US 1000000
+#endif
+
+//Health of one scheduled sensor, see getHealth()
+enum LIDARLite_SensorHealth
+{
+  LIDARLITE_HEALTH_OK = 0,      //The last measurement succeeded
+  LIDARLITE_HEALTH_FAILING,     //Recent measurements failed. Still triggered every cycle
+  LIDARLITE_HEALTH_QUARANTINED, //Too many failures in a row. Only probed with an acknowledge poll, with back-off
+};
+
+//Called when every sensor of a scheduler has been quarantined, which usually
+//means the bus itself is stuck. Typically ends the Wire peripheral, calls
+//LIDARLite_recoverBus() and begins Wire again. Returns true if the bus was
+//recovered.
+typedef bool (*LIDARLite_BusRecovery)(void *context);
+
+template <class Transport = LIDARLITE_DEFAULT_TRANSPORT, class Stats = LIDARLite_NoStats>
+class LIDARLite_v4LED_Scheduler_T
+{
+private:
+  LIDARLite_v4LED_T<Transport, Stats> *_sensors[LIDARLITE_SCHEDULER_MAX_SENSORS]; //Sensors run by this scheduler, already begin()'d by the user
+  uint8_t _numSensors = 0;
+
+  uint16_t _distance[LIDARLITE_SCHEDULER_MAX_SENSORS];    //Most recent distance of each sensor in centimeters
+  bool _newSample[LIDARLITE_SCHEDULER_MAX_SENSORS];       //True until the most recent distance has been read
+  uint32_t _sampleCount[LIDARLITE_SCHEDULER_MAX_SENSORS]; //Completed measurements since start()
+  unsigned long _startTime = 0;                           //millis() when start() was called
+
+  //Fault handling
+  uint8_t _health[LIDARLITE_SCHEDULER_MAX_SENSORS];            //LIDARLite_SensorHealth of each sensor
+  uint8_t _failures[LIDARLITE_SCHEDULER_MAX_SENSORS];          //Failed measurements in a row
+  unsigned long _triggerTime[LIDARLITE_SCHEDULER_MAX_SENSORS]; //micros() of the last trigger, for the measurement timeout
+  unsigned long _retryTime[LIDARLITE_SCHEDULER_MAX_SENSORS];   //micros() at which a quarantined sensor is probed next
+  uint32_t _retryInterval[LIDARLITE_SCHEDULER_MAX_SENSORS];    //Wait before the next probe. Doubles after every failed probe
+  uint16_t _reattachCount[LIDARLITE_SCHEDULER_MAX_SENSORS];    //Times the sensor came back out of quarantine
+  bool _reattached[LIDARLITE_SCHEDULER_MAX_SENSORS];           //Out of quarantine and no sample delivered yet
+  uint8_t _failureThreshold = LIDARLITE_HEALTH_FAILURE_THRESHOLD; //Failures in a row before quarantine
+  uint32_t _measurementTimeout = LIDARLITE_HEALTH_TIMEOUT_US;     //Longest a measurement may stay busy
+  LIDARLite_BusRecovery _busRecovery = NULL;                      //Called once every sensor is quarantined
+  void *_busRecoveryContext = NULL;                               //Passed to _busRecovery
+  uint32_t _busRecoveries = 0;                                    //Times _busRecovery was called
+
+  void trigger(uint8_t index);       //Start a measurement, counting a trigger that is not acknowledged as a failure
+  void fail(uint8_t index);          //Count a failed measurement and quarantine the sensor past the threshold
+  void scheduleRetry(uint8_t index); //Set the next probe time and double the back-off
+  void probe(uint8_t index);         //Poll a quarantined sensor and reattach it if it answers
+
+  uint8_t serviceSensors(LIDARLite_SampleBlock *block); //Shared by both service() overloads. block may be NULL
+
+public:
+  bool addSensor(LIDARLite_v4LED_T<Transport, Stats> &sensor); //Add a sensor to the scheduler. Returns false if the scheduler is full
+  uint8_t getNumSensors();                              //Returns the number of sensors added
+
+  void start();                                         //Trigger every sensor at once and reset the rate statistics
+  uint8_t service();                                    //Collect finished measurements and restart those sensors. Returns the number of new samples
+  uint8_t service(LIDARLite_SampleBlock &block);        //Same as service(), also appending every new sample to block. Stops early when block is full
+
+  bool available(uint8_t index);                        //Returns true if the sensor has a distance that has not been read yet
+  uint16_t getDistance(uint8_t index);                  //Returns the most recent distance of the sensor in centimeters and clears available()
+  uint32_t getSampleCount(uint8_t index);               //Returns the number of measurements completed by the sensor since start()
+  float getSensorHz(uint8_t index);                     //Returns the achieved sample rate of one sensor since start()
+  float getTotalHz();                                   //Returns the achieved sample rate of all sensors combined since start()
+
+  //Fault handling
+  void setFaultPolicy(uint8_t failureThreshold, uint32_t measurementTimeoutUs); //Failures in a row before quarantine, and how long a measurement may stay busy
+  void setBusRecovery(LIDARLite_BusRecovery recover, void *context = NULL);    //Function to call when every sensor is quarantined
+  uint8_t getHealth(uint8_t index);                     //Returns the LIDARLite_SensorHealth of the sensor
+  uint16_t getReattachCount(uint8_t index);             //Returns the number of times the sensor came back out of quarantine
+  uint32_t getBusRecoveryCount();                       //Returns the number of times the bus recovery function was called
+};
+
+#include "LIDARLite_v4LED_Scheduler_impl.h"
+
+//Scheduler for the Wire based driver. Instantiated once in LIDARLite_v4LED_Scheduler.cpp.
+typedef LIDARLite_v4LED_Scheduler_T<> LIDARLite_v4LED_Scheduler;
+#if LIDARLITE_ARDUINO
+extern template class LIDARLite_v4LED_Scheduler_T<LIDARLite_WireTransport>;
+#endif
+
+#endif
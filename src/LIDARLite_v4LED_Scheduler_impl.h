@@ -0,0 +1,405 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_Scheduler_impl.h
+
+  Member definitions of the LIDARLite_v4LED_Scheduler_T class template.
+  Included at the end of LIDARLite_v4LED_Scheduler.h; do not include this
+  file directly.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+
+#ifndef LIDARLite_v4LED_Scheduler_impl_h
+#define LIDARLite_v4LED_Scheduler_impl_h
+
+/*------------------------------------------------------------------------------
+  Add Sensor
+
+  Add a sensor to the scheduler. The sensor must already have been set up with
+  begin() on its own I2C address.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  sensor: sensor to run. The scheduler keeps a pointer to it, so it must stay
+          in scope for as long as the scheduler is used.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_Scheduler_T<Transport, Stats>::addSensor(LIDARLite_v4LED_T<Transport, Stats> &sensor)
+{
+    if (_numSensors >= LIDARLITE_SCHEDULER_MAX_SENSORS)
+        return false;
+
+    _sensors[_numSensors] = &sensor;
+    _distance[_numSensors] = 0;
+    _newSample[_numSensors] = false;
+    _sampleCount[_numSensors] = 0;
+    _health[_numSensors] = LIDARLITE_HEALTH_OK;
+    _failures[_numSensors] = 0;
+    _retryInterval[_numSensors] = LIDARLITE_RETRY_MIN_US;
+    _reattachCount[_numSensors] = 0;
+    _reattached[_numSensors] = false;
+    _numSensors++;
+
+    return true;
+} /* LIDARLite_v4LED_Scheduler::addSensor */
+
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_Scheduler_T<Transport, Stats>::getNumSensors()
+{
+    return _numSensors;
+}
+
+/*------------------------------------------------------------------------------
+  Start
+
+  Trigger a measurement on every sensor back to back, so all acquisitions run
+  at the same time, and reset the sample counters used for the rate reports.
+  Every sensor starts out healthy.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_Scheduler_T<Transport, Stats>::start()
+{
+    for (uint8_t i = 0; i < _numSensors; i++)
+    {
+        _newSample[i] = false;
+        _sampleCount[i] = 0;
+        _health[i] = LIDARLITE_HEALTH_OK;
+        _failures[i] = 0;
+        _retryInterval[i] = LIDARLITE_RETRY_MIN_US;
+        trigger(i);
+    }
+
+    _startTime = millis();
+} /* LIDARLite_v4LED_Scheduler::start */
+
+/*------------------------------------------------------------------------------
+  Service
+
+  Give every sensor one service() call. Sensors that have finished have their
+  distance collected and are triggered again immediately, so no sensor sits
+  idle while another one is still acquiring. A sensor that did not acknowledge
+  its last trigger is retried here as well.
+
+  A measurement fails when its trigger is not acknowledged, when the sensor
+  stops answering while it is busy, or when it is still busy after the
+  measurement timeout. After the failure threshold is reached in a row the
+  sensor is quarantined: it is no longer triggered or polled, only probed
+  with one acknowledge poll per retry interval, so a missing sensor costs
+  the others one address byte on the bus every few milliseconds at most.
+  Nothing here blocks, so a failing sensor never holds up the rest.
+
+  Call this as often as possible from loop(). Returns the number of new
+  samples collected during this call.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_Scheduler_T<Transport, Stats>::service()
+{
+    return serviceSensors(NULL);
+} /* LIDARLite_v4LED_Scheduler::service */
+
+/*------------------------------------------------------------------------------
+  Service into a Block
+
+  Same as service(), but every new sample is also appended to block with its
+  timestamp, scheduler index and status flags, so a logger can collect
+  samples from all sensors and write out whole arrays instead of fetching
+  and formatting one distance at a time. A sample is flagged
+  LIDARLITE_SAMPLE_GAP if the sensor had failed measurements since its
+  previous sample, and also LIDARLITE_SAMPLE_REATTACHED if it has just come
+  back out of quarantine.
+
+  Once the block is full the remaining sensors are left alone until the next
+  call, so finished measurements wait in their sensors rather than being
+  lost. Empty the block (set count to 0) and call again.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_Scheduler_T<Transport, Stats>::service(LIDARLite_SampleBlock &block)
+{
+    return serviceSensors(&block);
+} /* LIDARLite_v4LED_Scheduler::service */
+
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_Scheduler_T<Transport, Stats>::serviceSensors(LIDARLite_SampleBlock *block)
+{
+    uint8_t newSamples = 0;
+
+    for (uint8_t i = 0; i < _numSensors; i++)
+    {
+        LIDARLite_v4LED_T<Transport, Stats> *sensor = _sensors[i];
+
+        if (block != NULL && block->count >= LIDARLITE_BLOCK_SIZE)
+            break;
+
+        if (_health[i] == LIDARLITE_HEALTH_QUARANTINED)
+        {
+            if ((long)(micros() - _retryTime[i]) >= 0)
+                probe(i);
+            continue;
+        }
+
+        bool wasBusy = (sensor->getMeasurementState() == LIDARLITE_STATE_BUSY);
+        uint8_t state = sensor->service();
+
+        if (state == LIDARLITE_STATE_READY)
+        {
+            if (block != NULL)
+            {
+                LIDARLite_Sample sample;
+                uint16_t entry = block->count++;
+
+                _distance[i] = sensor->fetch(sample);
+                block->timestamp[entry] = sample.timestamp;
+                block->distance[entry] = sample.distance;
+                block->status[entry] = 0;
+                if (_failures[i] != 0 || _reattached[i])
+                    block->status[entry] |= LIDARLITE_SAMPLE_GAP;
+                if (_reattached[i])
+                    block->status[entry] |= LIDARLITE_SAMPLE_REATTACHED;
+                block->sensor[entry] = i;
+            }
+            else
+                _distance[i] = sensor->fetch();
+
+            _reattached[i] = false;
+            _newSample[i] = true;
+            _sampleCount[i]++;
+            newSamples++;
+
+            _health[i] = LIDARLITE_HEALTH_OK;
+            _failures[i] = 0;
+            _retryInterval[i] = LIDARLITE_RETRY_MIN_US;
+        }
+        else if (state == LIDARLITE_STATE_BUSY)
+        {
+            if ((uint32_t)(micros() - _triggerTime[i]) <= _measurementTimeout)
+                continue;
+
+            // Stuck busy. Retriggering discards the measurement
+            fail(i);
+        }
+        else if (wasBusy)
+        {
+            // Stopped answering. Retrigger on the next call rather than
+            // spend a second failed transaction on it now
+            fail(i);
+            continue;
+        }
+
+        if (_health[i] != LIDARLITE_HEALTH_QUARANTINED)
+            trigger(i);
+    }
+
+    return newSamples;
+} /* LIDARLite_v4LED_Scheduler::serviceSensors */
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_Scheduler_T<Transport, Stats>::trigger(uint8_t index)
+{
+    _triggerTime[index] = micros();
+    if (_sensors[index]->startMeasurement() == false)
+        fail(index);
+}
+
+/*------------------------------------------------------------------------------
+  Fail
+
+  Count one failed measurement. Once the failure threshold is reached the
+  sensor is quarantined. If that leaves no sensor working, the bus recovery
+  function, if any, is called and every sensor is probed straight away.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_Scheduler_T<Transport, Stats>::fail(uint8_t index)
+{
+    if (_failures[index] != 0xFF)
+        _failures[index]++;
+
+    if (_failures[index] < _failureThreshold)
+    {
+        _health[index] = LIDARLITE_HEALTH_FAILING;
+        return;
+    }
+
+    _health[index] = LIDARLITE_HEALTH_QUARANTINED;
+    _newSample[index] = false;
+    scheduleRetry(index);
+
+    for (uint8_t i = 0; i < _numSensors; i++)
+        if (_health[i] != LIDARLITE_HEALTH_QUARANTINED)
+            return;
+
+    if (_busRecovery == NULL)
+        return;
+
+    _busRecoveries++;
+    if (_busRecovery(_busRecoveryContext))
+    {
+        for (uint8_t i = 0; i < _numSensors; i++)
+            _retryTime[i] = micros();
+    }
+} /* LIDARLite_v4LED_Scheduler::fail */
+
+// The back-off only resets once the sensor delivers a sample, so a sensor
+// that answers probes but keeps failing measurements is probed less and less
+template <class Transport, class Stats>
+void LIDARLite_v4LED_Scheduler_T<Transport, Stats>::scheduleRetry(uint8_t index)
+{
+    _retryTime[index] = micros() + _retryInterval[index];
+
+    _retryInterval[index] *= 2;
+    if (_retryInterval[index] > LIDARLITE_RETRY_MAX_US)
+        _retryInterval[index] = LIDARLITE_RETRY_MAX_US;
+}
+
+/*------------------------------------------------------------------------------
+  Probe
+
+  Poll a quarantined sensor's address. If it acknowledges, it is assumed to
+  have been power cycled: its configuration is written back with
+  restoreConfiguration() and it is triggered again with a clean failure
+  count. Otherwise the next probe is scheduled.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_Scheduler_T<Transport, Stats>::probe(uint8_t index)
+{
+    LIDARLite_v4LED_T<Transport, Stats> *sensor = _sensors[index];
+
+    if (sensor->isConnected() == false || sensor->restoreConfiguration() == false)
+    {
+        scheduleRetry(index);
+        return;
+    }
+
+    _health[index] = LIDARLITE_HEALTH_FAILING;
+    _failures[index] = 0;
+    _reattachCount[index]++;
+    _reattached[index] = true;
+    trigger(index);
+} /* LIDARLite_v4LED_Scheduler::probe */
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_Scheduler_T<Transport, Stats>::available(uint8_t index)
+{
+    if (index >= _numSensors)
+        return false;
+    return _newSample[index];
+}
+
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_Scheduler_T<Transport, Stats>::getDistance(uint8_t index)
+{
+    if (index >= _numSensors)
+        return 0;
+
+    _newSample[index] = false;
+    return _distance[index];
+}
+
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_Scheduler_T<Transport, Stats>::getSampleCount(uint8_t index)
+{
+    if (index >= _numSensors)
+        return 0;
+    return _sampleCount[index];
+}
+
+/*------------------------------------------------------------------------------
+  Get Sensor Hz
+
+  Returns the average sample rate the sensor achieved since start(), in Hz.
+  Returns 0 until at least one millisecond has passed.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+float LIDARLite_v4LED_Scheduler_T<Transport, Stats>::getSensorHz(uint8_t index)
+{
+    unsigned long elapsed = millis() - _startTime;
+
+    if (index >= _numSensors || elapsed == 0)
+        return 0;
+
+    return (_sampleCount[index] * 1000.0) / elapsed;
+} /* LIDARLite_v4LED_Scheduler::getSensorHz */
+
+/*------------------------------------------------------------------------------
+  Get Total Hz
+
+  Returns the combined sample rate of all sensors since start(), in Hz.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+float LIDARLite_v4LED_Scheduler_T<Transport, Stats>::getTotalHz()
+{
+    unsigned long elapsed = millis() - _startTime;
+    uint32_t total = 0;
+
+    if (elapsed == 0)
+        return 0;
+
+    for (uint8_t i = 0; i < _numSensors; i++)
+        total += _sampleCount[i];
+
+    return (total * 1000.0) / elapsed;
+} /* LIDARLite_v4LED_Scheduler::getTotalHz */
+
+/*------------------------------------------------------------------------------
+  Set Fault Policy
+
+  Parameters
+  ------------------------------------------------------------------------------
+  failureThreshold:     failed measurements in a row before the sensor is
+                        quarantined. Default LIDARLITE_HEALTH_FAILURE_THRESHOLD
+  measurementTimeoutUs: a measurement still busy after this many microseconds
+                        counts as failed. Must be longer than the slowest
+                        acquisition profile in use. Default
+                        LIDARLITE_HEALTH_TIMEOUT_US
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_Scheduler_T<Transport, Stats>::setFaultPolicy(uint8_t failureThreshold, uint32_t measurementTimeoutUs)
+{
+    if (failureThreshold == 0)
+        failureThreshold = 1;
+
+    _failureThreshold = failureThreshold;
+    _measurementTimeout = measurementTimeoutUs;
+} /* LIDARLite_v4LED_Scheduler::setFaultPolicy */
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_Scheduler_T<Transport, Stats>::setBusRecovery(LIDARLite_BusRecovery recover, void *context)
+{
+    _busRecovery = recover;
+    _busRecoveryContext = context;
+}
+
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_Scheduler_T<Transport, Stats>::getHealth(uint8_t index)
+{
+    if (index >= _numSensors)
+        return LIDARLITE_HEALTH_QUARANTINED;
+    return _health[index];
+}
+
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_Scheduler_T<Transport, Stats>::getReattachCount(uint8_t index)
+{
+    if (index >= _numSensors)
+        return 0;
+    return _reattachCount[index];
+}
+
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_Scheduler_T<Transport, Stats>::getBusRecoveryCount()
+{
+    return _busRecoveries;
+}
+
+#endif
@@ -0,0 +1,2010 @@
+/*------------------------------------------------------------------------------
+
+  LIDARLite_v4LED Arduino Library
+  LIDARLite_v4LED_impl.h
+
+  Member definitions of the LIDARLite_v4LED_T class template. Included at the
+  end of LIDARLite_v4LED.h; do not include this file directly.
+
+  This library is modified by SparkFun but originally comes from Garmin. 
+  You can find the original library code here:
+  https://github.com/garmin/LIDARLite_Arduino_Library
+
+  This library provides quick access to the basic functions of LIDAR-Lite
+  via the Arduino interface. Additionally, it can provide a user of any
+  platform with a template for their own application code.
+
+  Copyright (c) 2019 Garmin Ltd. or its subsidiaries.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+------------------------------------------------------------------------------*/
+
+#ifndef LIDARLite_v4LED_impl_h
+#define LIDARLite_v4LED_impl_h
+
+static_assert((LIDARLITE_RING_SIZE & (LIDARLITE_RING_SIZE - 1)) == 0, "LIDARLITE_RING_SIZE must be a power of two");
+
+#if LIDARLITE_ARDUINO
+template <class Transport, class Stats>
+LIDARLite_v4LED_T<Transport, Stats> *LIDARLite_v4LED_T<Transport, Stats>::_isrInstances[LIDARLITE_MAX_INTERRUPT_SENSORS] = {NULL};
+#endif
+
+//Initialize the I2C port
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::begin(uint8_t address, typename Transport::Port &wirePort)
+{
+    _deviceAddress = address;  //grab the address that the sensor is on
+    _transport.begin(wirePort); //grab which port the user wants to use
+
+    _measurementState = LIDARLITE_STATE_IDLE;
+    _shadowValid = 0;
+    _configSet = 0;
+
+    //return true if the device is connected
+    return (isConnected());
+}
+
+template <class Transport, class Stats>
+Transport &LIDARLite_v4LED_T<Transport, Stats>::getTransport()
+{
+    return _transport;
+}
+
+template <class Transport, class Stats>
+Stats &LIDARLite_v4LED_T<Transport, Stats>::getStats()
+{
+    return *this;
+}
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::isConnected()
+{
+    uint8_t status = _transport.ping(_deviceAddress);
+
+    Stats::onPing(status);
+    noteStatus(status);
+    if (status == 0)
+        return true;
+    return false;
+}
+
+/*------------------------------------------------------------------------------
+  Configure
+
+  Selects one of several preset configurations.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  configuration:  Default 0.
+    0: Maximum range. Uses maximum acquisition count.
+    1: Balanced performance.
+    2: Short range, high speed. Reduces maximum acquisition count.
+    3: Mid range, higher speed. Turns on quick termination
+         detection for faster measurements at short range (with decreased
+         accuracy)
+    4: Maximum range, higher speed on short range targets. Turns on quick
+         termination detection for faster measurements at short range (with
+         decreased accuracy)
+    5: Very short range, higher speed, high error. Reduces maximum
+         acquisition count to a minimum for faster rep rates on very
+         close targets with high error.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::configure(uint8_t configuration)
+{
+    switch (configuration)
+    {
+    case 0: // Default mode - Maximum range
+        applyProfile(LIDARLITE_PROFILE_MAX_RANGE);
+        break;
+
+    case 1: // Balanced performance
+        applyProfile(LIDARLITE_PROFILE_BALANCED);
+        break;
+
+    case 2: // Short range, high speed
+        applyProfile(LIDARLITE_PROFILE_SHORT_RANGE);
+        break;
+
+    case 3: // Mid range, higher speed on short range targets
+        applyProfile(LIDARLITE_PROFILE_MID_RANGE_QT);
+        break;
+
+    case 4: // Maximum range, higher speed on short range targets
+        applyProfile(LIDARLITE_PROFILE_MAX_RANGE_QT);
+        break;
+
+    case 5: // Very short range, higher speed, high error
+        applyProfile(LIDARLITE_PROFILE_VERY_SHORT_RANGE);
+        break;
+    }
+} /* LIDARLite_v4LED::configure */
+
+/*------------------------------------------------------------------------------
+  Apply Profile
+
+  Write an acquisition profile: ACQUISITION_COUNT, QUICK_TERMINATION and, if
+  the profile sets it, DETECTION_SENSITIVITY. The registers are not adjacent,
+  so each is its own write. With the shadow cache enabled, registers that
+  already hold the profile's value are skipped, so switching between
+  profiles that share settings costs only the writes that differ.
+
+  The profile's minAcquisitionUs is used by the wait functions from now on.
+  Returns true if every write was acknowledged.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::applyProfile(const LIDARLite_Profile &profile)
+{
+    bool success = true;
+
+    _profile = profile;
+
+    if (!writeRegister(ACQUISITION_COUNT, profile.acquisitionCount))
+        success = false;
+    if (!writeRegister(QUICK_TERMINATION, profile.quickTermination))
+        success = false;
+    if (profile.setSensitivity && !writeRegister(DETECTION_SENSITIVITY, profile.detectionSensitivity))
+        success = false;
+
+    return success;
+} /* LIDARLite_v4LED::applyProfile */
+
+template <class Transport, class Stats>
+LIDARLite_Profile LIDARLite_v4LED_T<Transport, Stats>::getProfile()
+{
+    return _profile;
+}
+
+/*------------------------------------------------------------------------------
+  Set I2C Address
+
+  Set Alternate I2C Device Address. See Operation Manual for additional info.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  newAddress: desired secondary I2C device address
+  disableDefault: a non-zero value here means the default 0x62 I2C device
+    address will be disabled.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::setI2Caddr(uint8_t newAddress, bool disableDefaultI2CAddress)
+{
+    //Check if address is within range
+    if (newAddress < 0x08 || newAddress > 0x77)
+    {
+        return false;
+    }
+
+    if (newAddress == 0x62)
+    {
+        return useDefaultAddress();
+    }
+
+    //Clear out array
+    uint8_t dataBytes[5];
+    for (int i = 0; i < 5; i++)
+        dataBytes[i] = 0;
+
+    // Enable flash storage
+    enableFlash(true);
+    delay(100);
+
+    // Read 4-byte device serial number
+    read(UNIT_ID_0, dataBytes, 4);
+
+    // Append the desired I2C address to the end of the serial number byte array
+    dataBytes[4] = newAddress;
+
+    // Write the serial number and new address in one 5-byte transaction
+    write(UNIT_ID_0, dataBytes, 5);
+
+    // Wait for the I2C peripheral to be restarted with new device address
+    delay(100);
+
+    //Change _deviceAddress to reflect the changed address
+    _deviceAddress = newAddress;
+    invalidateShadowCache();
+
+    // If desired, disable default I2C device address (using the new I2C device address)
+    if (disableDefaultI2CAddress)
+    {
+        useNewAddressOnly();
+
+        // Wait for the I2C peripheral to be restarted with new device address
+        delay(100);
+    }
+
+    // Disable flash storage
+    enableFlash(false);
+    delay(100);
+
+    return true;
+} /* LIDARLite_v4LED::setI2Caddr */
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::useDefaultAddress()
+{
+    bool success = writeRegister(I2C_CONFIG, 0x00); // clear bits to use the default address
+    if (success == false)
+    {
+        return false;
+    }
+
+    _deviceAddress = LIDARLITE_ADDR_DEFAULT;
+    invalidateShadowCache();
+
+    //Wait for LIDAR to acknowledge on the new address
+    uint8_t counter = 0;
+    while (1)
+    {
+        delay(10);
+
+        if (isConnected() == true)
+            break;
+        if (counter++ > 100)
+        {
+            return false;
+        }
+    }
+
+    //disable flash storage after changing address
+    enableFlash(false);
+    return true;
+}
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::useNewAddressOnly()
+{
+    bool success = writeRegister(I2C_CONFIG, 0x01); // set bit to disable default address
+    if (success == false)
+    {
+        return false;
+    }
+    return true;
+}
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::useBothAddresses()
+{
+    bool success = writeRegister(I2C_CONFIG, 0x02);
+    if (success == false)
+    {
+        return false;
+    }
+    return true;
+}
+/*------------------------------------------------------------------------------
+  Provision Addresses
+
+  Bring up several sensors that all answer on the same address (normally the
+  default 0x62) by giving each its own address. Every sensor on the shared
+  address receives the UNIT_ID write, but only the one whose serial number
+  matches takes the new address, so the sensors are told apart by serial.
+
+  Instead of the fixed 100 ms delays of setI2Caddr(), each step is confirmed
+  by reading the register it changed back from the new address until the
+  sensor's I2C peripheral has restarted with it, which typically takes a few
+  milliseconds. An acknowledge alone would not do: after step 3 the sensor
+  still answers on the new address until it restarts. getProvisionTime()
+  reports how long the whole table took.
+
+  Process for each table row
+  ------------------------------------------------------------------------------
+  1.  Write the serial number and new address to UNIT_ID_0 on the shared address
+  2.  Read I2C_SEC_ADDR from the new address until it returns the new address
+  3.  Write I2C_CONFIG on the new address so the sensor leaves the shared address
+  4.  Read I2C_CONFIG from the new address until it shows the shared address off
+  5.  With persist, turn flash storage off again on the new address
+
+  Parameters
+  ------------------------------------------------------------------------------
+  table:     one row per sensor. found is filled in for every row.
+  count:     number of rows in table
+  persist:   true to store the new addresses in flash, so they survive a power
+             cycle. false keeps them in RAM only; run this at every boot.
+  timeoutMs: how long to wait for each read-back. A serial number that is not
+             on the bus costs this much time.
+
+  Returns the number of rows whose every step succeeded. A row that fails
+  after step 2 may have left its sensor on both addresses. The object keeps
+  talking to the shared address afterwards.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_T<Transport, Stats>::provisionAddresses(LIDARLite_AddressAssignment *table, uint8_t count,
+                                                                bool persist, uint16_t timeoutMs)
+{
+    unsigned long startTime = millis();
+    uint8_t sharedAddress = _deviceAddress;
+    uint8_t provisioned = 0;
+    uint8_t dataBytes[5];
+
+    for (uint8_t i = 0; i < count; i++)
+        table[i].found = false;
+
+    // Every sensor on the shared address gets this
+    if (persist && enableFlash(true) == false)
+    {
+        _provisionTime = millis() - startTime;
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        LIDARLite_AddressAssignment &row = table[i];
+
+        if (row.address < 0x08 || row.address > 0x77 || row.address == sharedAddress)
+            continue;
+
+        // 1. Only the sensor with this serial number takes the address
+        _deviceAddress = sharedAddress;
+        invalidateShadowCache();
+        for (uint8_t j = 0; j < 4; j++)
+            dataBytes[j] = row.unitId[j];
+        dataBytes[4] = row.address;
+        if (write(UNIT_ID_0, dataBytes, 5) == false)
+            continue;
+
+        // 2.
+        _deviceAddress = row.address;
+        invalidateShadowCache();
+        if (waitForReadBack(I2C_SEC_ADDR, row.address, timeoutMs) == false)
+            continue;
+
+        // 3. and 4.
+        if (writeRegister(I2C_CONFIG, 0x01) == false) // set bit to disable default address
+            continue;
+        if (waitForReadBack(I2C_CONFIG, 0x01, timeoutMs) == false)
+            continue;
+
+        // 5.
+        if (persist && enableFlash(false) == false)
+            continue;
+
+        row.found = true;
+        provisioned++;
+    }
+
+    // Sensors still on the shared address
+    _deviceAddress = sharedAddress;
+    invalidateShadowCache();
+    if (persist)
+        enableFlash(false);
+
+    _provisionTime = millis() - startTime;
+    return provisioned;
+} /* LIDARLite_v4LED::provisionAddresses */
+
+template <class Transport, class Stats>
+unsigned long LIDARLite_v4LED_T<Transport, Stats>::getProvisionTime()
+{
+    return _provisionTime;
+}
+
+/*------------------------------------------------------------------------------
+  Wait for Read Back
+
+  Read a register until it returns value, pausing 500 us between reads. Reads
+  that are not acknowledged, while the sensor's I2C peripheral restarts, are
+  retried. Returns false if timeoutMs passes first.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::waitForReadBack(uint8_t regAddr, uint8_t value, uint16_t timeoutMs)
+{
+    unsigned long startTime = millis();
+    uint8_t dataByte;
+
+    while (1)
+    {
+        if (read(regAddr, &dataByte, 1) && dataByte == value)
+            return true;
+
+        if (millis() - startTime >= timeoutMs)
+            return false;
+
+        delayMicroseconds(500);
+    }
+} /* LIDARLite_v4LED::waitForReadBack */
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::enableFlash(bool enable)
+{
+    uint8_t temp;
+    if (enable)
+    {
+        temp = 0x11;
+    }
+    else
+    {
+        temp = 0x00;
+    }
+    return writeRegister(ENABLE_FLASH_STORAGE, temp);
+}
+
+/*------------------------------------------------------------------------------
+  Set Detection Sensitivity
+
+  Write the DETECTION_SENSITIVITY register (0x1C), the threshold a correlation
+  peak must pass to count as a target. 0x00 uses the device's default
+  threshold; see the Operation Manual for other values.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::setDetectionSensitivity(uint8_t sensitivity)
+{
+    return writeRegister(DETECTION_SENSITIVITY, sensitivity);
+}
+
+/*------------------------------------------------------------------------------
+  Take Range
+
+  Initiate a distance measurement by writing to register 0x00.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::takeRange()
+{
+    uint8_t dataByte = 0x04;
+
+    _triggerTime = micros();
+    write(ACQ_COMMANDS, &dataByte, 1);
+} /* LIDARLite_v4LED::takeRange */
+
+/*------------------------------------------------------------------------------
+  Wait for Busy Flag
+
+  Blocking function to wait until the Lidar Lite's internal busy flag goes low.
+  Polls with back-off, see waitForBusy(timeoutUs).
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::waitForBusy()
+{
+    pollUntilIdle(0, false, 0);
+} /* LIDARLite_v4LED::waitForBusy */
+
+/*------------------------------------------------------------------------------
+  Wait for Busy Flag with Timeout
+
+  Wait until the Lidar Lite's internal busy flag goes low, or until timeoutUs
+  microseconds have passed. The STATUS register is not read until the
+  shortest acquisition time of the current acquisition profile has passed
+  since takeRange(), and after that the pause between reads grows from
+  LIDARLITE_POLL_MIN_US to LIDARLITE_POLL_MAX_US, leaving the bus free for
+  other devices. Use getLastWaitPolls() and getLastWaitTime() to see what the
+  wait cost.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  timeoutUs: longest time to wait in microseconds. 0 waits forever.
+
+  Returns true once the device is idle, false on timeout or if the device
+  stops answering.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::waitForBusy(uint32_t timeoutUs)
+{
+    return pollUntilIdle(timeoutUs, false, 0);
+} /* LIDARLite_v4LED::waitForBusy */
+
+/*------------------------------------------------------------------------------
+  Get Busy Flag
+
+  Read BUSY flag from device registers. Function will return 0x00 if not busy.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_T<Transport, Stats>::getBusyFlag()
+{
+    uint8_t statusByte = 0;
+    uint8_t busyFlag; // busyFlag monitors when the device is done with a measurement
+
+    // Read status register to check busy flag
+    read(STATUS, &statusByte, 1);
+
+    // STATUS bit 0 is busyFlag
+    busyFlag = statusByte & 0x01;
+
+    return busyFlag;
+} /* LIDARLite_v4LED::getBusyFlag */
+
+/*------------------------------------------------------------------------------
+  Read Distance
+
+  Read and return the result of the most recent distance measurement.
+  Returns 0 if the device did not answer; getLastError() tells that apart
+  from a real 0 cm reading.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_T<Transport, Stats>::readDistance()
+{
+    uint16_t distance = 0;
+    uint8_t *dataBytes = (uint8_t *)&distance;
+
+    // Read two bytes from registers 0x10 and 0x11
+    if (read(FULL_DELAY_LOW, dataBytes, 2) == false)
+        return 0;
+
+    return (distance); //This is the distance in centimeters
+} /* LIDARLite_v4LED::readDistance */
+
+/*------------------------------------------------------------------------------
+  Read Distance with Timestamp
+
+  Read the result of the most recent measurement into sample, stamped with the
+  middle of that acquisition and its duration. Call after waitForBusy() or
+  waitForBusyGpio() has returned true, which is when the completion time is
+  taken. Works after takeRange() and takeRangeGpio() alike.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_T<Transport, Stats>::readDistance(LIDARLite_Sample &sample)
+{
+    stampSample(sample, _triggerTime, _completionTime);
+    sample.distance = readDistance();
+    return sample.distance;
+} /* LIDARLite_v4LED::readDistance */
+
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_T<Transport, Stats>::getDistance()
+{
+    // 1. Trigger a range measurement.
+    takeRange();
+
+    // 2. Wait for busyFlag to indicate the device is idle.
+    waitForBusy();
+
+    // 3. Read new distance data from device registers
+    return readDistance();
+
+    // return *distance; //This is the distance in centimeters
+}
+
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_T<Transport, Stats>::getDistance(LIDARLite_Sample &sample)
+{
+    takeRange();
+    waitForBusy();
+    return readDistance(sample);
+}
+
+/*------------------------------------------------------------------------------
+  Start Measurement
+
+  Non-blocking alternative to getDistance(). Triggers a measurement and returns
+  immediately so the CPU and the I2C bus are free while the device acquires.
+  Call service() periodically to advance the measurement, then fetch() the
+  result once measurementReady() returns true.
+
+  States
+  ------------------------------------------------------------------------------
+  IDLE  -> startMeasurement() -> BUSY
+  BUSY  -> service() sees the busy flag clear, reads distance -> READY
+  BUSY  -> service() gets no answer from the device -> IDLE
+  READY -> fetch() -> IDLE
+
+  Calling startMeasurement() from any state discards a pending result and
+  starts over. Returns false if the device did not acknowledge the trigger, in
+  which case the state machine stays IDLE.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::startMeasurement()
+{
+    uint8_t dataByte = 0x04;
+
+    _triggerTime = micros();
+    _busySeenTime = _triggerTime + _profile.minAcquisitionUs;
+    if (write(ACQ_COMMANDS, &dataByte, 1) == false)
+    {
+        _measurementState = LIDARLITE_STATE_IDLE;
+        return false;
+    }
+
+    _measurementState = LIDARLITE_STATE_BUSY;
+    return true;
+} /* LIDARLite_v4LED::startMeasurement */
+
+/*------------------------------------------------------------------------------
+  Service
+
+  Advance the non-blocking measurement. While BUSY, each call performs exactly
+  one STATUS read; when the busy flag has cleared the distance is read and
+  latched, and the state moves to READY. With enableFusedReads(true) the
+  STATUS read also returns the distance, see readStatusDistance(). In every other state no bus traffic
+  is generated. Returns the resulting LIDARLite_MeasurementState.
+
+  If a read fails the measurement is abandoned and the state goes back to
+  IDLE, so a sensor that dropped off the bus is never reported READY with a
+  distance it did not send.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_T<Transport, Stats>::service()
+{
+    if (_measurementState != LIDARLITE_STATE_BUSY)
+        return _measurementState;
+
+    unsigned long pollTime = micros();
+
+    if (_fusedReads)
+    {
+        LIDARLite_Reading reading;
+        bool idle = readStatusDistance(reading);
+        if (_lastError != 0)
+            _measurementState = LIDARLITE_STATE_IDLE;
+        else if (idle)
+        {
+            noteCompletion(micros());
+            Stats::onAcquisition(micros() - _triggerTime);
+            _lastDistance = reading.distance;
+            _measurementState = LIDARLITE_STATE_READY;
+        }
+        else
+            _busySeenTime = pollTime;
+    }
+    else
+    {
+        uint8_t busyFlag = getBusyFlag();
+        if (_lastError != 0)
+            _measurementState = LIDARLITE_STATE_IDLE;
+        else if (busyFlag == 0)
+        {
+            noteCompletion(micros());
+            Stats::onAcquisition(micros() - _triggerTime);
+            _lastDistance = readDistance();
+            _measurementState = (_lastError == 0) ? LIDARLITE_STATE_READY : LIDARLITE_STATE_IDLE;
+        }
+        else
+            _busySeenTime = pollTime;
+    }
+
+    return _measurementState;
+} /* LIDARLite_v4LED::service */
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::measurementReady()
+{
+    return (_measurementState == LIDARLITE_STATE_READY);
+}
+
+/*------------------------------------------------------------------------------
+  Fetch
+
+  Return the distance latched by service() in centimeters and return the state
+  machine to IDLE. If no measurement has completed, the last latched distance
+  is returned and the state is left unchanged.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_T<Transport, Stats>::fetch()
+{
+    if (_measurementState == LIDARLITE_STATE_READY)
+        _measurementState = LIDARLITE_STATE_IDLE;
+
+    return _lastDistance;
+} /* LIDARLite_v4LED::fetch */
+
+// The stamp is taken from the measurement service() last completed
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_T<Transport, Stats>::fetch(LIDARLite_Sample &sample)
+{
+    stampSample(sample, _triggerTime, _completionTime);
+    sample.distance = fetch();
+    return sample.distance;
+}
+
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_T<Transport, Stats>::getMeasurementState()
+{
+    return _measurementState;
+}
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::enableFusedReads(bool enable)
+{
+    _fusedReads = enable;
+}
+
+/*------------------------------------------------------------------------------
+  Read Status and Distance
+
+  Read STATUS (0x01) through FULL_DELAY_HIGH (0x11) in one auto-incrementing
+  burst, so the busy flag and the distance arrive in the same transaction.
+
+  Compared with getBusyFlag() followed by readDistance() this is 2 instead of
+  4 transactions, but 20 instead of 9 bytes on the wire. It pays off when
+  per-transaction overhead dominates (slow Wire stacks, Linux syscalls, busy
+  shared buses) and for the last poll of a measurement; for many busy polls
+  in a row getBusyFlag() moves fewer bytes.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  reading: status, busy and distance are filled in. distance is only valid
+           when the function returns true.
+
+  Returns false while the device is busy, and also when the read fails; the
+  reading then says busy with a distance of 0 and getLastError() is set.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::readStatusDistance(LIDARLite_Reading &reading)
+{
+    uint8_t dataBytes[FULL_DELAY_HIGH - STATUS + 1] = {0};
+
+    // Reads as busy if the device does not answer
+    if (read(STATUS, dataBytes, sizeof(dataBytes)) == false)
+    {
+        reading.status = 0x01;
+        reading.busy = true;
+        reading.distance = 0;
+        return false;
+    }
+
+    reading.status = dataBytes[0];
+    reading.busy = (dataBytes[0] & 0x01);
+    reading.distance = dataBytes[FULL_DELAY_LOW - STATUS] | ((uint16_t)dataBytes[FULL_DELAY_HIGH - STATUS] << 8);
+
+    return (reading.busy == false);
+} /* LIDARLite_v4LED::readStatusDistance */
+
+/*------------------------------------------------------------------------------
+  Read Telemetry
+
+  Read BOARD_TEMPERATURE (0xE0) through SOC_TEMPERATURE (0xEC) in one burst:
+  2 transactions and 16 bytes, against 4 transactions and 8 bytes for
+  getBoardTemp() plus getSOCTemp(), and the hardware version comes along.
+  Only reads registers, so the FACTORY_RESET and START_BOOTLOADER registers in
+  the span are not affected.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  reading: boardTemp, hardwareVersion and socTemp are filled in
+
+  Returns false, leaving reading untouched, if the read fails.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::readTelemetry(LIDARLite_Reading &reading)
+{
+    uint8_t dataBytes[SOC_TEMPERATURE - BOARD_TEMPERATURE + 1] = {0};
+
+    if (read(BOARD_TEMPERATURE, dataBytes, sizeof(dataBytes)) == false)
+        return false;
+
+    reading.boardTemp = (int8_t)dataBytes[0];
+    reading.hardwareVersion = dataBytes[HARDWARE_VERSION - BOARD_TEMPERATURE];
+    reading.socTemp = (int8_t)dataBytes[SOC_TEMPERATURE - BOARD_TEMPERATURE];
+    return true;
+} /* LIDARLite_v4LED::readTelemetry */
+
+/*------------------------------------------------------------------------------
+  Start Continuous
+
+  Put the device into free-running mode: it triggers its own measurements
+  every measurementInterval counts of MEASUREMENT_INTERVAL, so the host no
+  longer writes ACQ_COMMANDS for every sample.
+
+  The period is not taken on trust from the register units. One measurement
+  is triggered and waited for, then STATUS is polled every
+  LIDARLITE_POLL_MIN_US until the device starts the next measurement by
+  itself and until that one finishes. The time from the trigger to the start
+  of the device's own measurement is the first estimate of the sample period,
+  and the length of the triggered measurement the acquisition time, each to
+  within a STATUS read. This blocks for about one period plus an
+  acquisition, and fails if the device has not started a measurement of its
+  own after four nominal periods (measurementInterval *
+  LIDARLITE_INTERVAL_UNIT_US), for example because the firmware counts the
+  register in other units; define LIDARLITE_INTERVAL_UNIT_US to match before
+  including the library.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  measurementInterval: value written to MEASUREMENT_INTERVAL (0xE3). 0 is not
+                       allowed here, use stopContinuous() instead.
+
+  Returns true once the device is measuring on its own. On failure
+  MEASUREMENT_INTERVAL is written back to 0.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::startContinuous(uint8_t measurementInterval)
+{
+    uint32_t nominalPeriod = (uint32_t)measurementInterval * LIDARLITE_INTERVAL_UNIT_US;
+    uint8_t dataByte = 0x04;
+    unsigned long firstEnd;
+    unsigned long selfTrigger;
+    unsigned long selfEnd;
+
+    if (measurementInterval == 0)
+        return false;
+
+    if (writeRegister(MEASUREMENT_INTERVAL, measurementInterval) == false)
+        return false;
+
+    _ringHead = 0;
+    _ringCount = 0;
+    _overruns = 0;
+    _missed = 0;
+    _readSequence = _sequence;
+
+    // The first measurement starts the free-running sequence. The device
+    // starts it when the write ends, and the next one an interval later
+    if (write(ACQ_COMMANDS, &dataByte, 1) == false)
+    {
+        stopContinuous();
+        return false;
+    }
+    _triggerTime = micros();
+
+    if (waitForStatus(false, _triggerTime + nominalPeriod, firstEnd) == false ||
+        waitForStatus(true, _triggerTime + 4 * nominalPeriod, selfTrigger) == false ||
+        waitForStatus(false, selfTrigger + nominalPeriod, selfEnd) == false)
+    {
+        stopContinuous();
+        return false;
+    }
+
+    _samplePeriod = selfTrigger - _triggerTime;
+    _continuousDuration = firstEnd - _triggerTime;
+    _anchorTrigger = selfEnd - _continuousDuration;
+    _nextSampleTime = _anchorTrigger + _samplePeriod;
+    _nextPollTime = nextPollTime();
+    _pollPause = LIDARLITE_POLL_MIN_US;
+    _continuousBusySeen = false;
+    _continuousFirstRead = true;
+    _continuousEarly = false;
+    _continuous = true;
+
+    return true;
+} /* LIDARLite_v4LED::startContinuous */
+
+/*------------------------------------------------------------------------------
+  Wait for Status
+
+  Poll STATUS every LIDARLITE_POLL_MIN_US until its busy bit equals busy, or
+  until deadline. Each read is taken to show STATUS as it was half way
+  through it, so the bit changed between the middle of the last read that
+  still showed the old value (or the call) and the middle of the first one
+  that shows the new value; edgeTime is set to the middle of the two. The
+  length of a read is kept for serviceContinuous().
+
+  Returns false on timeout or if STATUS could not be read.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::waitForStatus(bool busy, unsigned long deadline, unsigned long &edgeTime)
+{
+    unsigned long lastSeen = micros();
+
+    while (1)
+    {
+        unsigned long readStart = micros();
+        uint8_t busyFlag = getBusyFlag();
+        unsigned long readEnd = micros();
+
+        if (_lastError != 0)
+            return false;
+
+        _statusReadTime = readEnd - readStart;
+        unsigned long seen = readStart + _statusReadTime / 2;
+        if ((busyFlag != 0) == busy)
+        {
+            edgeTime = lastSeen + (seen - lastSeen) / 2;
+            return true;
+        }
+
+        lastSeen = seen;
+        if ((long)(readEnd - deadline) >= 0)
+            return false;
+        delayMicroseconds(LIDARLITE_POLL_MIN_US);
+    }
+} /* LIDARLite_v4LED::waitForStatus */
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::stopContinuous()
+{
+    _continuous = false;
+    return writeRegister(MEASUREMENT_INTERVAL, 0x00);
+}
+
+/*------------------------------------------------------------------------------
+  Service Continuous
+
+  Collect the next self-triggered measurement once the device has finished
+  it, deciding from STATUS rather than the clock alone, so a measurement is
+  never read twice and one that was never read is counted.
+
+  Each sample normally costs two STATUS reads and one readDistance(). The
+  two reads straddle the predicted end of the measurement, one poll
+  interval (a STATUS read plus LIDARLITE_POLL_MIN_US) apart: the first sees
+  it running, which shows it is a new one, and the second sees it finished.
+  Its completion is taken as the middle of the two, and the schedule is
+  re-phased on it for every sample, so error in the period estimate cannot
+  build up. Slots of the schedule passed since the previous sample, for
+  example while the host was busy elsewhere, are counted by
+  getMissedCount() and their sequence numbers are skipped. Between samples
+  no bus traffic is generated, however often this is called.
+
+  While STATUS still shows the measurement running it is read again every
+  poll interval. If the first read finds the device idle, the measurement
+  has either not started or already finished, and STATUS is read again
+  after a pause that grows from LIDARLITE_POLL_MIN_US but stays short enough
+  that a whole acquisition cannot pass unseen. If the device is still idle
+  an acquisition time after the predicted end, the measurement finished
+  before it was seen: the newest finished one is read, earlier ones are
+  counted as missed, and when the first read was on time the schedule is
+  moved to just before it.
+
+  The period is re-estimated from the time since the first self-triggered
+  measurement divided by the number of periods since, once there are four.
+
+  Returns the number of samples added, 0 or 1.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_T<Transport, Stats>::serviceContinuous()
+{
+    unsigned long completion;
+    uint32_t skipped;
+
+    if (_continuous == false)
+        return 0;
+
+    unsigned long pollTime = micros();
+    if ((long)(pollTime - _nextPollTime) < 0)
+        return 0;
+
+    uint8_t busyFlag = getBusyFlag();
+    unsigned long readEnd = micros();
+    unsigned long seen = pollTime + (readEnd - pollTime) / 2;
+    unsigned long expectedEnd = _nextSampleTime + _continuousDuration;
+    uint32_t pollInterval = _statusReadTime + LIDARLITE_POLL_MIN_US;
+    uint32_t maxPause = (_continuousDuration > _statusReadTime) ? (_continuousDuration - _statusReadTime) / 2 : 0;
+    bool firstRead = _continuousFirstRead;
+
+    _continuousFirstRead = false;
+    if (_lastError != 0)
+    {
+        // Try again one period later; the measurements in between are counted once the sensor answers
+        _nextPollTime = pollTime + _samplePeriod;
+        return 0;
+    }
+
+    if (busyFlag != 0)
+    {
+        // Running. Look again one poll interval later, or just before the end if it started late
+        _continuousBusySeen = true;
+        _busySeenTime = seen;
+        _continuousEarly = false;
+        _nextPollTime = readEnd + LIDARLITE_POLL_MIN_US;
+        if ((long)(expectedEnd - seen) > (long)pollInterval)
+        {
+            unsigned long endPoll = seen + _continuousDuration - pollInterval;
+            if ((long)(endPoll - _nextPollTime) > 0)
+                _nextPollTime = endPoll;
+        }
+        return 0;
+    }
+
+    if (firstRead && (long)(pollTime - _nextPollTime) < (long)pollInterval)
+    {
+        _continuousEarly = true;
+        _idleSeenTime = seen;
+    }
+
+    if (_continuousBusySeen)
+    {
+        // Seen running and now finished
+        completion = _busySeenTime + (seen - _busySeenTime) / 2;
+        long late = (long)(completion - expectedEnd);
+        skipped = (late > (long)_samplePeriod / 2) ? (late + _samplePeriod / 2) / _samplePeriod : 0;
+        if (skipped == 0 && (long)(expectedEnd - _busySeenTime) > 0 && (long)(expectedEnd - seen) <= 0)
+        {
+            // On schedule: the prediction is at least as good as the middle of the reads
+            completion = expectedEnd;
+            rephaseContinuous(completion, false);
+        }
+        else
+            rephaseContinuous(completion, true);
+    }
+    else if ((long)(seen - expectedEnd) >= (long)_continuousDuration)
+    {
+        // Finished before it was ever seen running. Take the newest one
+        skipped = (seen - expectedEnd) / _samplePeriod;
+        completion = expectedEnd + skipped * _samplePeriod;
+        if (_continuousEarly && skipped == 0)
+        {
+            completion = _idleSeenTime - pollInterval / 2;
+            rephaseContinuous(completion, true);
+        }
+        else
+            _nextSampleTime = completion - _continuousDuration + _samplePeriod;
+    }
+    else
+    {
+        // Not started yet, or finished early
+        _nextPollTime = readEnd + _pollPause;
+        _pollPause = (2 * _pollPause > maxPause) ? maxPause : 2 * _pollPause;
+        return 0;
+    }
+
+    _missed += skipped;
+    _sequence += skipped;
+    _nextPollTime = nextPollTime();
+    _continuousBusySeen = false;
+    _continuousFirstRead = true;
+    _continuousEarly = false;
+    _pollPause = LIDARLITE_POLL_MIN_US;
+
+    LIDARLite_Sample sample;
+    sample.distance = readDistance();
+    if (_lastError != 0)
+    {
+        _missed++;
+        _sequence++;
+        return 0;
+    }
+
+    stampSample(sample, completion - _continuousDuration, completion);
+    queueSample(sample);
+    return 1;
+} /* LIDARLite_v4LED::serviceContinuous */
+
+// Start the next measurement one period after this completion, averaging the period since the first one
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::rephaseContinuous(unsigned long completion, bool refinePeriod)
+{
+    unsigned long trigger = completion - _continuousDuration;
+
+    if (refinePeriod)
+    {
+        uint32_t sinceAnchor = trigger - _anchorTrigger;
+        uint32_t periods = (sinceAnchor + _samplePeriod / 2) / _samplePeriod;
+        if (periods >= 4)
+            _samplePeriod = sinceAnchor / periods;
+    }
+    _nextSampleTime = trigger + _samplePeriod;
+}
+
+// When to start the STATUS read that should end half a poll interval before the next measurement does
+template <class Transport, class Stats>
+unsigned long LIDARLite_v4LED_T<Transport, Stats>::nextPollTime()
+{
+    uint32_t lead = (_statusReadTime + LIDARLITE_POLL_MIN_US) / 2 + _statusReadTime / 2;
+
+    return _nextSampleTime + ((_continuousDuration > lead) ? _continuousDuration - lead : 0);
+}
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::queueSample(const LIDARLite_Sample &sample)
+{
+    if (_ringCount == LIDARLITE_RING_SIZE)
+    {
+        // Drop the oldest sample
+        _ringHead = (_ringHead + 1) & (LIDARLITE_RING_SIZE - 1);
+        _ringCount--;
+        _overruns++;
+    }
+
+    _ring[(_ringHead + _ringCount) & (LIDARLITE_RING_SIZE - 1)] = sample;
+    _ringCount++;
+}
+
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_T<Transport, Stats>::getSamplePeriod()
+{
+    return _samplePeriod;
+}
+
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_T<Transport, Stats>::getMissedCount()
+{
+    return _missed;
+}
+
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_T<Transport, Stats>::samplesAvailable()
+{
+    return _ringCount;
+}
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::readSample(LIDARLite_Sample &sample)
+{
+    if (_ringCount == 0)
+        return false;
+
+    sample = _ring[_ringHead];
+    _ringHead = (_ringHead + 1) & (LIDARLITE_RING_SIZE - 1);
+    _ringCount--;
+    _readSequence = sample.sequence + 1;
+
+    return true;
+}
+
+/*------------------------------------------------------------------------------
+  Read Samples
+
+  Drain the ring buffer into a struct-of-arrays block in one call, appending
+  after the block's count entries and stopping when the block is full.
+  Samples left in the ring stay there for the next call. A sample whose
+  sequence number does not follow the previous one read is flagged
+  LIDARLITE_SAMPLE_GAP, so a logger can mark overruns without keeping the
+  sequence numbers.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  block:    destination. count is advanced by the number of samples moved
+  sensorId: value stored in block.sensor for every sample, to tell sensors
+            apart when several share one block
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_T<Transport, Stats>::readSamples(LIDARLite_SampleBlock &block, uint8_t sensorId)
+{
+    uint8_t moved = 0;
+
+    while (_ringCount > 0 && block.count < LIDARLITE_BLOCK_SIZE)
+    {
+        const LIDARLite_Sample &sample = _ring[_ringHead];
+        uint16_t i = block.count++;
+
+        block.timestamp[i] = sample.timestamp;
+        block.distance[i] = sample.distance;
+        block.status[i] = (sample.sequence != _readSequence) ? LIDARLITE_SAMPLE_GAP : 0;
+        block.sensor[i] = sensorId;
+        _readSequence = sample.sequence + 1;
+
+        _ringHead = (_ringHead + 1) & (LIDARLITE_RING_SIZE - 1);
+        _ringCount--;
+        moved++;
+    }
+
+    return moved;
+} /* LIDARLite_v4LED::readSamples */
+
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_T<Transport, Stats>::getOverrunCount()
+{
+    return _overruns;
+}
+
+#if LIDARLITE_ARDUINO
+/*------------------------------------------------------------------------------
+  Take Range using Trigger / Monitor Pins
+
+  Initiate a distance measurement by toggling the trigger pin
+
+  Parameters
+  ------------------------------------------------------------------------------
+  triggerPin: digital output pin connected to trigger input of LIDAR-Lite
+  monitorPin: digital input pin connected to monitor output of LIDAR-Lite
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::takeRangeGpio(uint8_t triggerPin, uint8_t monitorPin)
+{
+    uint8_t busyFlag;
+
+    _triggerTime = micros();
+
+    if (digitalRead(triggerPin))
+        digitalWrite(triggerPin, LOW);
+    else
+        digitalWrite(triggerPin, HIGH);
+
+    // When LLv4 receives trigger command it will drive monitor pin low.
+    // Wait for LLv4 to acknowledge receipt of command before moving on.
+    do
+    {
+        busyFlag = getBusyFlagGpio(monitorPin);
+    } while (!busyFlag);
+} /* LIDARLite_v4LED::takeRangeGpio */
+
+/*------------------------------------------------------------------------------
+  Wait for Busy Flag using Trigger / Monitor Pins
+
+  Blocking function to wait until the Lidar Lite's internal busy flag goes low
+
+  Parameters
+  ------------------------------------------------------------------------------
+  monitorPin: digital input pin connected to monitor output of LIDAR-Lite
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::waitForBusyGpio(uint8_t monitorPin)
+{
+    pollUntilIdle(0, true, monitorPin);
+} /* LIDARLite_v4LED::waitForBusyGpio */
+
+/*------------------------------------------------------------------------------
+  Wait for Busy Flag with Timeout using Trigger / Monitor Pins
+
+  Same polling policy as waitForBusy(timeoutUs), reading the monitor pin
+  instead of the STATUS register.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  monitorPin: digital input pin connected to monitor output of LIDAR-Lite
+  timeoutUs: longest time to wait in microseconds. 0 waits forever.
+
+  Returns true once the device is idle, false on timeout.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::waitForBusyGpio(uint8_t monitorPin, uint32_t timeoutUs)
+{
+    return pollUntilIdle(timeoutUs, true, monitorPin);
+} /* LIDARLite_v4LED::waitForBusyGpio */
+
+/*------------------------------------------------------------------------------
+  Get Busy Flag using Trigger / Monitor Pins
+
+  Check BUSY status via Monitor pin. Function will return 0x00 if not busy.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  monitorPin: digital input pin connected to monitor output of LIDAR-Lite
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_T<Transport, Stats>::getBusyFlagGpio(uint8_t monitorPin)
+{
+    uint8_t busyFlag; // busyFlag monitors when the device is done with a measurement
+
+    // Check busy flag via monitor pin
+    if (digitalRead(monitorPin))
+        busyFlag = 1;
+    else
+        busyFlag = 0;
+
+    return busyFlag;
+} /* LIDARLite_v4LED::getBusyFlagGpio */
+
+/*------------------------------------------------------------------------------
+  Begin Interrupt
+
+  Interrupt driven alternative to takeRangeGpio() / waitForBusyGpio(). The
+  falling edge of the monitor pin at the end of a measurement fires an
+  interrupt that records the completion time, so nothing spins while the
+  LIDAR works. The device only holds the result of its latest measurement,
+  so only the latest completion is kept: one that finishes before the
+  previous was read replaces it, and getInterruptDroppedCount() counts it.
+
+  The distance itself is read by readInterruptSample() from loop(), not in
+  the interrupt: Wire relies on interrupts on AVR and most other cores and
+  cannot be used from inside an ISR.
+
+  Typical use:
+    beginInterrupt(triggerPin, monitorPin);
+    takeRangeInterrupt();
+    ...
+    if (readInterruptSample(sample)) { use sample; takeRangeInterrupt(); }
+
+  Parameters
+  ------------------------------------------------------------------------------
+  triggerPin: digital output pin connected to trigger input of LIDAR-Lite
+  monitorPin: digital input pin connected to monitor output of LIDAR-Lite.
+              Must support attachInterrupt().
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::beginInterrupt(uint8_t triggerPin, uint8_t monitorPin)
+{
+    static void (*const trampolines[LIDARLITE_MAX_INTERRUPT_SENSORS])() = {
+        isrTrampoline0, isrTrampoline1, isrTrampoline2, isrTrampoline3};
+
+    int interruptNumber = digitalPinToInterrupt(monitorPin);
+#ifdef NOT_AN_INTERRUPT
+    if (interruptNumber == NOT_AN_INTERRUPT)
+        return false;
+#endif
+
+    endInterrupt();
+
+    int8_t slot = -1;
+    for (uint8_t i = 0; i < LIDARLITE_MAX_INTERRUPT_SENSORS; i++)
+    {
+        if (_isrInstances[i] == NULL)
+        {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0)
+        return false;
+
+    _triggerPin = triggerPin;
+    _monitorPin = monitorPin;
+    _isrPending = false;
+    _isrDropped = 0;
+
+    _isrSlot = slot;
+    _isrInstances[slot] = this;
+    attachInterrupt(interruptNumber, trampolines[slot], FALLING);
+
+    return true;
+} /* LIDARLite_v4LED::beginInterrupt */
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::endInterrupt()
+{
+    if (_isrSlot < 0)
+        return;
+
+    detachInterrupt(digitalPinToInterrupt(_monitorPin));
+    _isrInstances[_isrSlot] = NULL;
+    _isrSlot = -1;
+}
+
+/*------------------------------------------------------------------------------
+  Take Range Interrupt
+
+  Start a measurement by toggling the trigger pin. Unlike takeRangeGpio()
+  this does not wait for the monitor pin to acknowledge; the interrupt
+  reports completion.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::takeRangeInterrupt()
+{
+    _triggerTime = micros();
+
+    if (digitalRead(_triggerPin))
+        digitalWrite(_triggerPin, LOW);
+    else
+        digitalWrite(_triggerPin, HIGH);
+} /* LIDARLite_v4LED::takeRangeInterrupt */
+
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::interruptSampleAvailable()
+{
+    return _isrPending;
+}
+
+/*------------------------------------------------------------------------------
+  Read Interrupt Sample
+
+  Take the completion recorded by the interrupt and read the distance of that
+  measurement. Call this before triggering the next measurement, since the
+  device only holds the most recent result.
+
+  The completion time is a multi-byte value shared with the interrupt, so it
+  is taken with interrupts off. A completion that arrives during the
+  distance read is kept for the next call.
+
+  Returns false, without touching the bus, if no completion is pending.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::readInterruptSample(LIDARLite_Sample &sample)
+{
+    noInterrupts();
+    bool pending = _isrPending;
+    unsigned long completionTime = _isrCompletionTime;
+    _isrPending = false;
+    interrupts();
+
+    if (!pending)
+        return false;
+
+    Stats::onAcquisition(completionTime - _triggerTime);
+
+    // The ISR recorded the completion itself, so no estimate is needed
+    stampSample(sample, _triggerTime, completionTime);
+    sample.distance = readDistance();
+
+    return true;
+} /* LIDARLite_v4LED::readInterruptSample */
+
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_T<Transport, Stats>::getInterruptDroppedCount()
+{
+    // 32 bits written by the interrupt: not a single access on 8 bit cores
+    noInterrupts();
+    uint32_t dropped = _isrDropped;
+    interrupts();
+
+    return dropped;
+}
+
+/*------------------------------------------------------------------------------
+  Handle Monitor Interrupt
+
+  Runs in interrupt context. Records the completion time, replacing one that
+  was not read yet: its distance has already been overwritten on the device.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::handleMonitorInterrupt()
+{
+    if (_isrPending)
+        _isrDropped = _isrDropped + 1; // Compound assignment to volatile is deprecated in C++20
+
+    _isrCompletionTime = micros();
+    _isrPending = true;
+} /* LIDARLite_v4LED::handleMonitorInterrupt */
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::isrTrampoline0()
+{
+    if (_isrInstances[0] != NULL)
+        _isrInstances[0]->handleMonitorInterrupt();
+}
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::isrTrampoline1()
+{
+    if (_isrInstances[1] != NULL)
+        _isrInstances[1]->handleMonitorInterrupt();
+}
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::isrTrampoline2()
+{
+    if (_isrInstances[2] != NULL)
+        _isrInstances[2]->handleMonitorInterrupt();
+}
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::isrTrampoline3()
+{
+    if (_isrInstances[3] != NULL)
+        _isrInstances[3]->handleMonitorInterrupt();
+}
+#endif
+
+template <class Transport, class Stats>
+uint16_t LIDARLite_v4LED_T<Transport, Stats>::getLastWaitPolls()
+{
+    return _lastWaitPolls;
+}
+
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_T<Transport, Stats>::getLastWaitTime()
+{
+    return _lastWaitTime;
+}
+
+/*------------------------------------------------------------------------------
+  Poll Until Idle
+
+  Polling policy behind waitForBusy() and waitForBusyGpio().
+
+  1. Sleep until the profile's minAcquisitionUs has passed since the trigger.
+  2. Poll the busy flag. Between polls, pause LIDARLITE_POLL_MIN_US, doubling
+     after every poll up to LIDARLITE_POLL_MAX_US.
+  3. Stop once the flag is clear, or once timeoutUs has passed (if non-zero).
+     Polling STATUS also stops at the first read the device does not answer.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  timeoutUs:  longest time to wait in microseconds. 0 waits forever.
+  useGpio:    true to read the monitor pin, false to read the STATUS register
+  monitorPin: digital input pin connected to monitor output of LIDAR-Lite
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::pollUntilIdle(uint32_t timeoutUs, bool useGpio, uint8_t monitorPin)
+{
+    unsigned long startTime = micros();
+    uint32_t pause = LIDARLITE_POLL_MIN_US;
+    uint32_t elapsed;
+    uint32_t sinceTrigger = startTime - _triggerTime;
+    uint16_t expected = _profile.minAcquisitionUs;
+
+    _lastWaitPolls = 0;
+    _busySeenTime = _triggerTime + expected;
+
+    // Nothing to learn from the busy flag before the acquisition can be done
+    if (sinceTrigger < expected)
+    {
+        uint32_t sleepTime = expected - sinceTrigger;
+        if (timeoutUs != 0 && sleepTime > timeoutUs)
+            sleepTime = timeoutUs;
+        delayMicroseconds(sleepTime);
+    }
+
+    while (1)
+    {
+        unsigned long pollTime = micros();
+#if LIDARLITE_ARDUINO
+        uint8_t busyFlag = useGpio ? getBusyFlagGpio(monitorPin) : getBusyFlag();
+#else
+        // Without an Arduino core only the STATUS register can be polled
+        uint8_t busyFlag = getBusyFlag();
+        (void)monitorPin;
+#endif
+        _lastWaitPolls++;
+
+        elapsed = micros() - startTime;
+
+        // A sensor that stopped answering will not finish; do not wait out the timeout
+        if (!useGpio && _lastError != 0)
+        {
+            _lastWaitTime = elapsed;
+            return false;
+        }
+
+        if (busyFlag == 0)
+        {
+            noteCompletion(micros());
+            Stats::onAcquisition(micros() - _triggerTime);
+            _lastWaitTime = elapsed;
+            return true;
+        }
+
+        _busySeenTime = pollTime;
+
+        if (timeoutUs != 0 && elapsed >= timeoutUs)
+        {
+            _lastWaitTime = elapsed;
+            return false;
+        }
+
+        // Never sleep past the deadline
+        if (timeoutUs != 0 && pause > timeoutUs - elapsed)
+            delayMicroseconds(timeoutUs - elapsed);
+        else
+            delayMicroseconds(pause);
+
+        pause *= 2;
+        if (pause > LIDARLITE_POLL_MAX_US)
+            pause = LIDARLITE_POLL_MAX_US;
+    }
+} /* LIDARLite_v4LED::pollUntilIdle */
+
+/*------------------------------------------------------------------------------
+  Note Completion
+
+  A polled measurement finished somewhere between the last time it was seen
+  busy and idleSeenTime, the first time it was seen idle. The start of a busy
+  read and the end of an idle read are used, so the window holds the true
+  completion; its middle is the estimate. Before the first poll the lower
+  bound is the profile's shortest acquisition time, and it is clamped to the
+  window if the measurement beat that.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::noteCompletion(unsigned long idleSeenTime)
+{
+    unsigned long busySeen = _busySeenTime;
+
+    if ((long)(idleSeenTime - busySeen) < 0)
+        busySeen = idleSeenTime;
+    if ((long)(busySeen - _triggerTime) < 0)
+        busySeen = _triggerTime;
+
+    _completionTime = busySeen + (idleSeenTime - busySeen) / 2;
+} /* LIDARLite_v4LED::noteCompletion */
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::stampSample(LIDARLite_Sample &sample, unsigned long triggerTime,
+                                                     unsigned long completionTime)
+{
+    sample.duration = completionTime - triggerTime;
+    sample.timestamp = triggerTime + sample.duration / 2;
+    sample.sequence = _sequence++;
+}
+
+/*------------------------------------------------------------------------------
+  Get the temperature of the board
+  
+  Read the BOARD_TEMPERATURE register. This function returns the temperature in 
+  two's complement in Celcius.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_T<Transport, Stats>::getBoardTemp()
+{
+    uint8_t temp = 0;
+    read(BOARD_TEMPERATURE, &temp, 1);
+    return temp;
+}
+
+/*------------------------------------------------------------------------------
+  Get the temperature of the SOC (nRF52840)
+
+  Read the SOC_TEMPERATURE register. This function returns the temperature in 
+  two's complement in Celcius.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_T<Transport, Stats>::getSOCTemp()
+{
+    uint8_t temp = 0;
+    read(SOC_TEMPERATURE, &temp, 1);
+    return temp;
+}
+
+/*------------------------------------------------------------------------------
+  Set the power mode of the nRF52840 to be always on.
+
+  The coprocessor is not turned off, allowing for the fastest measurement possible.
+  This is the default setting.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::setPowerModeAlwaysOn()
+{
+    return writeRegister(POWER_MODE, 0xFF);
+}
+
+/*------------------------------------------------------------------------------
+  Set the nRF52840 to operate in asynchronous mode.
+
+  The coprocessor is always off unless a distance measurement is needed or a 
+  register access is required. Disable high accuracy mode first.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::setPowerModeAsync()
+{
+    return writeRegister(POWER_MODE, 0x00);
+}
+
+/*------------------------------------------------------------------------------
+  Enable and disable high accuracy mode
+
+  By default, the LIDAR operates in high accuracy mode, so use this function to 
+  disable and/or re-enable high accuracy mode
+  mode before setting the power mode to asynchronous.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  enable: boolean when set to true will ENABLE high accuracy mode and when false
+  will DISABLE high accuracy mode.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::enableHighAccuracyMode(bool enable)
+{
+    uint8_t writeByte;
+
+    if (enable){
+        writeByte = 0x14;
+    } else {
+        writeByte = 0x00;
+    }
+
+    return writeRegister(HIGH_ACCURACY_MODE, writeByte);
+}
+
+/*------------------------------------------------------------------------------
+  Call this function to put the nRF52840 SOC back to factory settings.
+
+  Resets the NVM/Flash storage information back to default settings and executes 
+  a SoftDevice reset.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::factoryReset()
+{
+    uint8_t resetByte = 0x01;
+    bool success = write(FACTORY_RESET, &resetByte, 1);
+
+    // Every configuration register goes back to its default
+    invalidateShadowCache();
+    _configSet = 0;
+
+    return success;
+}
+
+/*------------------------------------------------------------------------------
+  Enable Shadow Cache
+
+  Keep a copy of the last value written to each writable configuration
+  register (ACQUISITION_COUNT, QUICK_TERMINATION, DETECTION_SENSITIVITY,
+  POWER_MODE, HIGH_ACCURACY_MODE, ENABLE_FLASH_STORAGE, MEASUREMENT_INTERVAL
+  and I2C_CONFIG). While enabled, configure(), enableFlash(), the power mode
+  and accuracy functions and the useXAddress() functions skip their write when
+  the register already holds the requested value.
+
+  The shadow starts out empty, so the first write to each register always
+  reaches the device. It is cleared by begin(), factoryReset() and any address
+  change. Call invalidateShadowCache() if the device may have been reset or
+  reconfigured behind the library's back, or restoreConfiguration() to also
+  write the settings back.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  enable: true to skip redundant writes, false to always write (the default)
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::enableShadowCache(bool enable)
+{
+    _shadowEnabled = enable;
+    _shadowValid = 0;
+}
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::invalidateShadowCache()
+{
+    _shadowValid = 0;
+}
+
+template <class Transport, class Stats>
+uint32_t LIDARLite_v4LED_T<Transport, Stats>::getShadowWritesSaved()
+{
+    return _shadowWritesSaved;
+}
+
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_T<Transport, Stats>::getLastError()
+{
+    return _lastError;
+}
+
+template <class Transport, class Stats>
+uint8_t LIDARLite_v4LED_T<Transport, Stats>::getConsecutiveFailures()
+{
+    return _consecutiveFailures;
+}
+
+template <class Transport, class Stats>
+void LIDARLite_v4LED_T<Transport, Stats>::noteStatus(uint8_t status)
+{
+    _lastError = status;
+    if (status == 0)
+        _consecutiveFailures = 0;
+    else if (_consecutiveFailures != 0xFF)
+        _consecutiveFailures++;
+}
+
+/*------------------------------------------------------------------------------
+  Restore Configuration
+
+  A sensor that lost power, for example by being unplugged and plugged back
+  in, comes back with its default settings. This writes every configuration
+  register set since begin() back to it: ACQUISITION_COUNT,
+  QUICK_TERMINATION, DETECTION_SENSITIVITY, HIGH_ACCURACY_MODE and
+  POWER_MODE, in that order, whether or not the shadow cache is enabled.
+  Registers never written are left at the device default.
+
+  Not replayed: I2C_CONFIG and ENABLE_FLASH_STORAGE (a sensor moved to a new
+  address without flash storage comes back on the default address and has
+  to be provisioned again) and MEASUREMENT_INTERVAL (call startContinuous()
+  again).
+
+  Returns true if every write was acknowledged.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::restoreConfiguration()
+{
+    // HIGH_ACCURACY_MODE before POWER_MODE, see setPowerModeAsync()
+    const uint8_t replay[] = {ACQUISITION_COUNT, QUICK_TERMINATION, DETECTION_SENSITIVITY,
+                              HIGH_ACCURACY_MODE, POWER_MODE};
+    bool success = true;
+
+    // Whatever the shadow held no longer matches the device
+    _shadowValid = 0;
+
+    for (uint8_t i = 0; i < sizeof(replay); i++)
+    {
+        int8_t slot = shadowIndex(replay[i]);
+        if ((_configSet & (1 << slot)) && !write(replay[i], &_shadowValue[slot], 1))
+            success = false;
+    }
+
+    _measurementState = LIDARLITE_STATE_IDLE;
+    return success;
+} /* LIDARLite_v4LED::restoreConfiguration */
+
+/*------------------------------------------------------------------------------
+  Shadow Index
+
+  Returns the slot in _shadowValue used for a register, or -1 if the register
+  is not shadowed.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+int8_t LIDARLite_v4LED_T<Transport, Stats>::shadowIndex(uint8_t regAddr)
+{
+    switch (regAddr)
+    {
+    case ACQUISITION_COUNT:
+        return 0;
+    case QUICK_TERMINATION:
+        return 1;
+    case DETECTION_SENSITIVITY:
+        return 2;
+    case POWER_MODE:
+        return 3;
+    case HIGH_ACCURACY_MODE:
+        return 4;
+    case ENABLE_FLASH_STORAGE:
+        return 5;
+    case MEASUREMENT_INTERVAL:
+        return 6;
+    case I2C_CONFIG:
+        return 7;
+    default:
+        return -1;
+    }
+} /* LIDARLite_v4LED::shadowIndex */
+
+/*------------------------------------------------------------------------------
+  Write Register
+
+  Write a single configuration register. When the shadow cache is enabled and
+  already holds this value for the register, no bus traffic is generated and
+  the write counts as saved.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::writeRegister(uint8_t regAddr, uint8_t value)
+{
+    int8_t slot = shadowIndex(regAddr);
+
+    if (_shadowEnabled && slot >= 0 && (_shadowValid & (1 << slot)) && _shadowValue[slot] == value)
+    {
+        _shadowWritesSaved++;
+        return true;
+    }
+
+    return write(regAddr, &value, 1);
+} /* LIDARLite_v4LED::writeRegister */
+
+/*------------------------------------------------------------------------------
+  Write
+
+  Perform I2C write to device. The I2C peripheral in the LidarLite v3 HP
+  will receive multiple bytes in one I2C transmission. The first byte is
+  always the register address. The the bytes that follow will be written
+  into the specified register address first and then the internal address
+  in the Lidar Lite will be auto-incremented for all following bytes.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  regAddr:   register address to write to
+  dataBytes: pointer to array of bytes to write
+  numBytes:  number of bytes in 'dataBytes' array to write
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::write(uint8_t regAddr, uint8_t *dataBytes,
+                                         uint8_t numBytes)
+{
+    uint8_t nackCatcher;
+
+    // First byte of every write sets the LidarLite's internal register address pointer,
+    // subsequent bytes are data writes.
+    // A nack means the device is not responding.
+    nackCatcher = _transport.write(_deviceAddress, regAddr, dataBytes, numBytes);
+    Stats::onWrite(nackCatcher, numBytes);
+    noteStatus(nackCatcher);
+
+    // Remember the value of every configuration register this write covered,
+    // for restoreConfiguration(), and keep the shadow cache in step. After a
+    // failed write the register contents are unknown.
+    for (uint8_t i = 0; i < numBytes; i++)
+    {
+        int8_t slot = shadowIndex(regAddr + i);
+        if (slot < 0)
+            continue;
+
+        _shadowValue[slot] = dataBytes[i];
+        _configSet |= (1 << slot);
+
+        if (_shadowEnabled && nackCatcher == 0)
+            _shadowValid |= (1 << slot);
+        else
+            _shadowValid &= ~(1 << slot);
+    }
+
+    if (nackCatcher != 0)
+    {
+        // handle nack issues in here
+        return false;
+    }
+    else
+        return true;
+} /* LIDARLite_v4LED::write */
+
+/*------------------------------------------------------------------------------
+  Read
+
+  Perform I2C read from device.  The I2C peripheral in the LidarLite v3 HP
+  will send multiple bytes in one I2C transmission. The register address must
+  be set up by a previous I2C write. The bytes that follow will be read
+  from the specified register address first and then the internal address
+  pointer in the Lidar Lite will be auto-incremented for following bytes.
+
+  Returns false if the device did not acknowledge or sent fewer than numBytes
+  bytes; getLastError() has the transport's error code.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  regAddr:   register address to read
+  dataBytes: pointer to array of bytes to write
+  numBytes:  number of bytes in 'dataBytes' array to read
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::read(uint8_t regAddr, uint8_t *dataBytes,
+                                        uint8_t numBytes)
+{
+    // Set the internal register address pointer in the Lidar Lite, then perform
+    // read, save in dataBytes array. dataBytes is left untouched if the device
+    // returns fewer than numBytes bytes.
+    uint8_t status = _transport.read(_deviceAddress, regAddr, dataBytes, numBytes);
+    Stats::onRead(status, numBytes);
+    noteStatus(status);
+
+    return (status == 0);
+} /* LIDARLite_v4LED::read */
+
+/*------------------------------------------------------------------------------
+  Correlation Record Read
+
+  The correlation record used to calculate distance can be read from the device.
+  It has a bipolar wave shape, transitioning from a positive going portion to a
+  roughly symmetrical negative going pulse. The point where the signal crosses
+  zero represents the effective delay for the reference and return signals.
+
+  Process
+  ------------------------------------------------------------------------------
+  1.  Take a distance reading (there is no correlation record without at least
+      one distance reading being taken)
+  2.  For as many points as you want to read from the record (max is 192) read
+      the two byte signed correlation data point from 0x52
+
+  Each point is its own 2 byte read of 0x52. The register pointer
+  auto-increments, so a longer read would run on into 0x54 and the registers
+  after it rather than into the next record point. There is no bulk read of
+  the record however large the Wire buffer: the device hands out one point
+  per read of 0x52 and 0x53, so 192 points are always 384 transactions.
+  Read only the points needed with correlationRecordReadWindow() instead.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  correlationArray: pointer to memory location to store the correlation record
+                    ** Two bytes for every correlation value must be
+                       allocated by calling function
+  numberOfReadings: Default = 192. Maximum = 192
+
+  Returns false if a read fails. The points from the failed one on are not
+  written, and the record index in the device no longer matches the array,
+  so take a new measurement before reading the record again.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::correlationRecordRead(
+    int16_t *correlationArray, uint8_t numberOfReadings)
+{
+    uint8_t i;
+    int16_t correlationValue;
+    uint8_t *dataBytes = (uint8_t *)&correlationValue;
+
+    for (i = 0; i < numberOfReadings; i++)
+    {
+        if (read(CORR_DATA, dataBytes, 2) == false)
+            return false;
+        correlationArray[i] = correlationValue;
+    }
+    return true;
+} /* LIDARLite_v4LED::correlationRecordRead */
+
+/*------------------------------------------------------------------------------
+  Correlation Record Read Window
+
+  Read a window of the correlation record, for example the points around the
+  crossing expected from the last distance (see LIDARLite_distanceToPoint()
+  and LIDARLite_measureSignalQuality() in LIDARLite_v4LED_Correlation.h).
+
+  CORR_DATA can only be read from the start of the record, one point per
+  2 byte read, and every read continues where the previous one stopped. The
+  points before firstPoint are therefore read and discarded, and the read
+  stops at the end of the window instead of running to point 191. Close
+  targets cost the least: a 32 point window ending at point 64 is 64 reads,
+  a third of the full record.
+
+  Parameters
+  ------------------------------------------------------------------------------
+  window:           pointer to memory location to store the points
+                    ** Two bytes for every point must be allocated by
+                       calling function
+  firstPoint:       first record point to keep, 0 to 191
+  numberOfReadings: number of points to keep, clamped to the end of the
+                    record
+
+  Returns false if firstPoint is outside the record or a read fails, in
+  which case window must not be used.
+------------------------------------------------------------------------------*/
+template <class Transport, class Stats>
+bool LIDARLite_v4LED_T<Transport, Stats>::correlationRecordReadWindow(
+    int16_t *window, uint8_t firstPoint, uint8_t numberOfReadings)
+{
+    int16_t skipped;
+
+    if (firstPoint >= 192)
+        return false;
+    if (numberOfReadings > 192 - firstPoint)
+        numberOfReadings = 192 - firstPoint;
+
+    for (uint8_t i = 0; i < firstPoint; i++)
+    {
+        if (correlationRecordRead(&skipped, 1) == false)
+            return false;
+    }
+
+    return correlationRecordRead(window, numberOfReadings);
+} /* LIDARLite_v4LED::correlationRecordReadWindow */
+
+#endif